@@ -0,0 +1,534 @@
+#include "Application.h"
+#include "Profiler.h"
+#include <cfloat>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <ostream>
+#include <string.h> // for strncpy
+
+// ImGui 和后端
+#include <imgui.h>
+#include <backends/imgui_impl_glfw.h>
+#include <backends/imgui_impl_opengl3.h>
+
+// GLFW (必须在 imgui 后端之前包含)
+#include <GLFW/glfw3.h>
+
+static void glfw_error_callback(int error, const char* description) {
+    std::cerr << "Glfw Error " << error << ": " << description << std::endl;
+}
+
+Application::Application(){
+    strncpy(m_pathABuf, "../assets/poly_a.json", 128);
+    strncpy(m_pathBBuf, "../assets/poly_b.json", 128);
+}
+
+Application::~Application(){
+    shutdown();
+}
+
+int Application::init() {
+    // 1. 初始化 GLFW
+    glfwSetErrorCallback(glfw_error_callback);
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+
+    // 2. 创建窗口
+    const char* glsl_version = "#version 330 core";
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    
+    m_window = glfwCreateWindow(1600, 900, "Fuzzy Shape Blending", NULL, NULL);
+    if (!m_window) {
+        std::cerr << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(m_window);
+    glfwSwapInterval(1); // 启用垂直同步
+
+    // 3. 初始化 ImGui
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO(); (void)io;
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable; //启用窗口停靠
+    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;//启用多窗口支持
+
+    //设置样式
+    ImGui::StyleColorsDark();
+    ImGuiStyle& style = ImGui::GetStyle();
+    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+        style.WindowRounding = 0.0f;
+        style.Colors[ImGuiCol_WindowBg].w = 1.0f;
+    }
+
+    // 4. 初始化 ImGui 后端
+    ImGui_ImplGlfw_InitForOpenGL(m_window, true);
+    ImGui_ImplOpenGL3_Init(glsl_version);
+
+    // 5. 后台发布新快照时唤醒主循环（glfwPostEmptyEvent 可在任意线程调用）
+    m_worker.onPublish = []() { glfwPostEmptyEvent(); };
+
+    // 6. 加载初始数据
+    loadData();
+    requestRedraw();
+
+    return 0;
+}
+
+void Application::loadData(){
+    std::cout << "Loading Data..." << std::endl;
+    submitJob(MorphStage::Load, m_autoFindK ? -1 : m_manualK);
+}
+
+void Application::submitJob(MorphStage from, int manualK){
+    MorphJob job;
+    job.from = from;
+    job.pathA = m_pathABuf;
+    job.pathB = m_pathBBuf;
+    job.weights = m_weights;
+    job.manualK = manualK;
+    job.searchBudgetSeconds = m_searchBudget;
+    job.cacheDir = m_cacheDir;
+    m_worker.submit(job);
+}
+
+// 收到事件后继续绘制的帧数
+static const int kRedrawFrames = 3;
+// 空闲时的等待超时；后台任务运行时缩短，以便刷新进度条
+static const double kIdleWaitSeconds = 1.0;
+static const double kBusyWaitSeconds = 0.1;
+
+void Application::run(){
+    while (!glfwWindowShouldClose(m_window)) {
+        if (!waitForEvents()) continue;
+        mainLoop();
+        if (m_framesToRender > 0) --m_framesToRender;
+    }
+}
+
+bool Application::waitForEvents(){
+    if (m_framesToRender > 0) {
+        glfwPollEvents();
+        return true;
+    }
+
+    const bool busy = m_worker.busy();
+    const double timeout = busy ? kBusyWaitSeconds : kIdleWaitSeconds;
+    const double start = glfwGetTime();
+    glfwWaitEventsTimeout(timeout);
+
+    // 超时前返回说明有输入事件或后台发布了快照
+    const bool timedOut = glfwGetTime() - start >= timeout;
+    if (!timedOut || busy) requestRedraw();
+    return m_framesToRender > 0;
+}
+
+void Application::requestRedraw(){
+    m_framesToRender = kRedrawFrames;
+}
+
+void Application::mainLoop() {
+    const auto frameStart = std::chrono::steady_clock::now();
+    // 开始 ImGui 帧
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+
+    // 设置一个全屏、无装饰的窗口作为DockSpace的“背景”
+    ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(viewport->WorkPos); // 使用 WorkPos 避开菜单栏（如果有）
+    ImGui::SetNextWindowSize(viewport->WorkSize); // 使用 WorkSize 避开菜单栏
+    ImGui::SetNextWindowViewport(viewport->ID);
+
+    // 设置窗口样式
+    ImGuiWindowFlags host_window_flags = 0;
+    host_window_flags |= ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove;
+    host_window_flags |= ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoNavFocus;
+    host_window_flags |= ImGuiWindowFlags_NoBackground;  
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+    
+    // 开始这个背景窗口
+    ImGui::Begin("DockSpaceHost", nullptr, host_window_flags);
+
+    ImGui::PopStyleVar(3);
+
+    // 创建 DockSpace
+    ImGuiID dockspace_id = ImGui::GetID("MyDockSpace");
+    ImGuiDockNodeFlags dockspace_flags = ImGuiDockNodeFlags_PassthruCentralNode; 
+    ImGui::DockSpace(dockspace_id, ImVec2(0.0f, 0.0f), dockspace_flags);
+
+    // 结束背景窗口
+    ImGui::End(); 
+
+    // 绘制 UI
+    drawUI();
+
+    // 渲染
+    ImGui::Render();
+    int display_w, display_h;
+    glfwGetFramebufferSize(m_window, &display_w, &display_h);
+    glViewport(0, 0, display_w, display_h);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+    // 帧时间不含等待垂直同步
+    Profiler::instance().record("frame", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+
+    // 更新和渲染其他视口 (如果启用了)
+    if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+        GLFWwindow* backup_current_context = glfwGetCurrentContext();
+        ImGui::UpdatePlatformWindows();
+        ImGui::RenderPlatformWindowsDefault();
+        glfwMakeContextCurrent(backup_current_context);
+    }
+
+    glfwSwapBuffers(m_window);
+}
+
+void Application::drawUI() {
+    // 每帧只原子地取一次快照，本帧所有绘制都基于它
+    m_snapshot = m_worker.snapshot();
+    const MorphSnapshot& snap = *m_snapshot;
+    if (m_snapshot != m_interpCacheSource) requestRedraw();
+    if (snap.generation != m_seenGeneration && !snap.provisional) {
+        m_seenGeneration = snap.generation;
+        if (snap.valid) m_manualK = snap.bestK;
+    }
+
+    // 控制面板
+    ImGui::Begin("Controls");
+    ImGui::InputText("Polygon A Path", m_pathABuf, 128);
+    ImGui::InputText("Polygon B Path", m_pathBBuf, 128);
+    if (ImGui::Button("Load")) {
+        loadData();
+    }
+    
+    ImGui::Separator();
+    
+    if (ImGui::SliderFloat("Time (t)", &m_interpTime, 0.0f, 1.0f)) requestRedraw();
+    if (ImGui::DragFloat("Render Scale", &m_renderScale, 0.01f, 0.1f, 10.0f)) requestRedraw();
+    static const char* const kModeNames[] = {"Affine basis", "ARAP"};
+    int mode = static_cast<int>(m_interpMode);
+    if (ImGui::Combo("Interpolation", &mode, kModeNames, 2)) {
+        m_interpMode = static_cast<InterpolationMode>(mode);
+        requestRedraw();
+    }
+    if (m_interpMode == InterpolationMode::Arap && snap.valid && !snap.arap) {
+        ImGui::TextDisabled("(ARAP needs a triangulation: showing affine)");
+    }
+    if (ImGui::Checkbox("Filled Preview", &m_filledPreview)) requestRedraw();
+    if (m_filledPreview) {
+        if (!snap.fill) {
+            ImGui::TextDisabled("(no triangulation: polygon is not simple)");
+        } else if (m_interpInverted >= 0) {
+            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Triangle %d folds at t = %.3f, outline only",
+                               m_interpInverted, m_interpTime);
+        }
+    }
+
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    ImGui::Text("Correspondence (Start Vertex k)");
+    ImGui::Checkbox("Auto-Find Best k", &m_autoFindK);
+    
+    // 如果是自动模式，就禁用滑块
+    if (m_autoFindK) {
+        ImGui::DragFloat("Search Budget (s)", &m_searchBudget, 0.05f, 0.0f, 60.0f, m_searchBudget > 0.0f ? "%.2f" : "unlimited");
+        const KSearchProgress& progress = m_worker.progress();
+        if (m_worker.busy() && progress.total > 0 && !progress.finished) {
+            int tested = progress.tested;
+            int total = progress.total;
+            ImGui::Text("Searching... best k = %d (provisional)", progress.bestK.load());
+            ImGui::ProgressBar(static_cast<float>(tested) / total, ImVec2(-1.0f, 0.0f));
+            ImGui::Text("cost = %.4f, lower bound = %.4f", progress.bestCost.load(), progress.lowerBound.load());
+            if (ImGui::Button("Stop Search")) {
+                m_worker.stopSearch();
+            }
+        } else {
+            ImGui::Text("Best k (auto-found): %d", snap.bestK);
+        }
+    } else {
+        // 假设 polyA 已经加载
+        int max_k = snap.polyA.n - 1;
+        if (max_k < 0) max_k = 0;
+        
+        // 手动滑块
+        ImGui::SliderInt("Manual k", &m_manualK, 0, max_k);
+        ImGui::SameLine();
+        if (ImGui::Button("Run with this k")) {
+            // 只重算 correspondence 及其后的 basis，不重新加载文件
+             submitJob(MorphStage::Correspondence, m_manualK);
+        }
+    }
+    
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // --- sim_t 权重 (w1, w2) ---
+    ImGui::Text("sim_t Weights (for Correspondence)");
+    bool sim_changed = false;
+    if (ImGui::SliderFloat("w1 (Edge)", &m_weights.w1, 0.0f, 1.0f)) {
+        m_weights.w2 = 1.0f - m_weights.w1; // 自动更新 w2
+        sim_changed = true;
+    }
+    ImGui::Text("w2 (Angle): %.2f", m_weights.w2); // 显示自动计算的 w2
+
+    ImGui::SameLine(); // 将下一个控件放在同一行
+    if (ImGui::Button("Reset##SimWeights")) { // "##SimWeights" 是一个唯一的ID
+        m_weights.w1 = 0.5f; // 恢复 ShapeBlender.h 中的默认值
+        m_weights.w2 = 0.5f;
+        sim_changed = true;
+    }
+
+    // 拖动滑块时每帧都会提交，新任务会取消仍在运行的旧任务
+    if (sim_changed) requestRedraw();
+    if (sim_changed || ImGui::Button("Recompute Correspondence")) {
+         submitJob(MorphStage::Correspondence, m_autoFindK ? -1 : m_manualK);
+    }
+
+    ImGui::Separator(); 
+    ImGui::Spacing();
+
+    // --- smooth_a 权重 (wS, wR, wA) ---
+    ImGui::Text("smooth_a Weights (for Basis Finding)");
+    bool smooth_changed = false;
+
+    bool changed_s = ImGui::SliderFloat("wS (Shape)", &m_weights.smooth_a_wS, 0.0f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+    bool changed_r = ImGui::SliderFloat("wR (Rotation)", &m_weights.smooth_a_wR, 0.0f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+
+    if (changed_s) {
+        if (m_weights.smooth_a_wS + m_weights.smooth_a_wR > 1.0f) {
+            m_weights.smooth_a_wR = 1.0f - m_weights.smooth_a_wS; // 当 wS 增加时，挤压 wR
+        }
+        smooth_changed = true;
+    } else if (changed_r) {
+        if (m_weights.smooth_a_wS + m_weights.smooth_a_wR > 1.0f) {
+            m_weights.smooth_a_wS = 1.0f - m_weights.smooth_a_wR; // 当 wR 增加时，挤压 wS
+        }
+        smooth_changed = true;
+    }
+    //自动计算wA
+    m_weights.smooth_a_wA = 1.0f - m_weights.smooth_a_wS - m_weights.smooth_a_wR;
+
+    ImGui::Text("wA (Area): %.3f", m_weights.smooth_a_wA); // 显示自动计算的 wA
+    
+    ImGui::SameLine();
+    if (ImGui::Button("Reset##SmoothWeights")) {
+        m_weights.smooth_a_wS = 0.333f; // 恢复 ShapeBlender.h 中的默认值
+        m_weights.smooth_a_wR = 0.333f;
+        // m_weights.smooth_a_wA 会在下一帧自动更新为 0.334f
+        smooth_changed = true;
+    }
+
+    if (smooth_changed) requestRedraw();
+    if (smooth_changed || ImGui::Button("Recompute Optimal Basis")) {
+        submitJob(MorphStage::Basis, m_autoFindK ? -1 : m_manualK);
+    }
+    ImGui::Separator();
+
+
+    ImGui::End();
+
+    // 渲染视口
+    ImGui::Begin("Viewport");
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 canvasPos = ImGui::GetCursorScreenPos();
+    
+    // 绘制多边形
+    const auto& polyA = snap.polyA;
+    const auto& polyB = snap.polyB;
+    // 只有 t、插值方式或快照变化时才重新插值
+    if (m_snapshot != m_interpCacheSource || m_interpTime != m_interpCacheTime || m_interpMode != m_interpCacheMode) {
+        {
+            ScopedTimer timer("interpolate");
+            if (m_interpMode == InterpolationMode::Arap && snap.arap) {
+                snap.arap->evaluate(m_interpTime, m_interpCache);
+            } else {
+                snap.plan.evaluate(m_interpTime, m_interpCache);
+            }
+        }
+        m_interpCacheSource = m_snapshot;
+        m_interpCacheTime = m_interpTime;
+        m_interpCacheMode = m_interpMode;
+        // 源多边形的剖分在插值帧中仍然有效，当且仅当没有三角形翻转
+        m_interpInverted = -1;
+        if (snap.fill && m_interpCache.n == snap.fill->vertexCount()) {
+            m_interpInverted = snap.fill->firstInvertedTriangle(m_interpCache.vertices.front().data());
+        }
+    }
+    const Polygon& interpPoly = m_interpCache;
+
+    // 计算偏移量，使B在A的右侧
+    ImVec2 offsetA = canvasPos;
+    ImVec2 offsetB = ImVec2(canvasPos.x + 400 * m_renderScale, canvasPos.y);
+    ImVec2 offsetInterp = ImVec2(canvasPos.x + 200 * m_renderScale, canvasPos.y + 400 * m_renderScale);
+
+    // 填充：剖分属于源多边形 A（界面直接在 ShapeBlender 上求解，计划从不反向）
+    const Triangulation* fill = m_filledPreview ? snap.fill.get() : nullptr;
+    if (fill) {
+        drawFilledPolygon(drawList, polyA, *fill, IM_COL32(255, 0, 0, 96), offsetA, m_renderScale);
+        if (m_interpInverted < 0) {
+            drawFilledPolygon(drawList, interpPoly, *fill, IM_COL32(255, 255, 255, 96), offsetInterp, m_renderScale);
+        }
+    }
+
+    // 红色: 源
+    drawPolygon(drawList, polyA, IM_COL32(255, 0, 0, 255), offsetA, m_renderScale);
+    // 蓝色: 目标
+    drawPolygon(drawList, polyB, IM_COL32(0, 0, 255, 255), offsetB, m_renderScale);
+    // 白色: 插值
+    drawPolygon(drawList, interpPoly, IM_COL32(255, 255, 255, 255), offsetInterp, m_renderScale);
+
+    ImGui::End();
+
+    drawPerformanceWindow();
+}
+
+void Application::drawPerformanceWindow() {
+    ImGui::Begin("Performance");
+
+    // 每帧都会发生的阶段：滚动直方图
+    for (const char* name : {"frame", "interpolate"}) {
+        Profiler::Stage stage = Profiler::instance().stage(name);
+        ImGui::Text("%s: last %.3f ms, avg %.3f ms, max %.3f ms", name, stage.lastMs, stage.averageMs(), stage.maxMs);
+        if (!stage.history.empty()) {
+            std::string label = std::string("##") + name;
+            ImGui::PlotHistogram(label.c_str(), stage.history.data(), static_cast<int>(stage.history.size()),
+                                 0, nullptr, 0.0f, FLT_MAX, ImVec2(0.0f, 50.0f));
+        }
+    }
+
+    // 求解流水线：最近一次的耗时
+    ImGui::Separator();
+    ImGui::Text("Last solve");
+    if (ImGui::BeginTable("Stages", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("stage");
+        ImGui::TableSetupColumn("last (ms)");
+        ImGui::TableSetupColumn("avg (ms)");
+        ImGui::TableHeadersRow();
+        for (const char* name : {"load", "cost_graph", "k_sweep", "traceback", "basis", "triangulate", "arap_factor"}) {
+            Profiler::Stage stage = Profiler::instance().stage(name);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text("%s", name);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stage.lastMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stage.averageMs());
+        }
+        ImGui::EndTable();
+    }
+
+    // 内存
+    ImGui::Separator();
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    ImGui::Text("Blender tables: %.2f MB", m_snapshot->blenderBytes * mb);
+    ImGui::Text("Correspondence scratch (peak): %.2f MB", m_snapshot->scratchBytes * mb);
+    ImGui::Text("Triangulation: %.2f MB", (m_snapshot->fill ? m_snapshot->fill->memoryUsage() : 0) * mb);
+    ImGui::Text("ARAP (factor + triangles): %.2f MB", (m_snapshot->arap ? m_snapshot->arap->memoryUsage() : 0) * mb);
+    ImGui::Text("Viewport buffers: %.2f MB",
+                (m_interpCache.memoryUsage() + m_screenPoints.capacity() * sizeof(ImVec2)) * mb);
+
+    ImGui::End();
+}
+
+// 屏幕空间中短于该长度（像素）的线段会被合并到下一段
+static const float kMinSegmentPixels = 1.0f;
+
+void Application::drawPolygon(ImDrawList* drawList, const Polygon& poly, ImU32 color, const ImVec2& offset, float scale) const {
+    if (poly.n == 0) return;
+
+    // 一次遍历变换到屏幕空间。NaN/Inf 会传播到总和中，所以每帧只需检查一次
+    m_screenPoints.resize(poly.n);
+    double checksum = 0.0;
+    for (int i = 0; i < poly.n; ++i) {
+        const auto v = poly.vertex(i);
+        checksum += v.x() + v.y();
+        m_screenPoints[i] = ImVec2(offset.x + static_cast<float>(v.x()) * scale,
+                                   offset.y + static_cast<float>(v.y()) * scale);
+    }
+
+    if (!std::isfinite(checksum)) {
+        static bool nan_error_printed = false;
+        if (!nan_error_printed) {
+            std::cerr << "!!! FATAL RENDER ERROR: NaN detected in polygon vertices." << std::endl;
+            nan_error_printed = true; 
+        }
+
+        // 少见的错误路径：逐段绘制有效的部分
+        for (int i = 0; i < poly.n; ++i) {
+            const ImVec2& p1 = m_screenPoints[i];
+            const ImVec2& p2 = m_screenPoints[(i + 1) % poly.n];
+            if (std::isfinite(p1.x + p1.y + p2.x + p2.y)) drawList->AddLine(p1, p2, color, 2.0f);
+        }
+        return;
+    }
+
+    // 就地抽稀：丢掉离上一个保留点不足一个像素的顶点
+    const float minDist2 = kMinSegmentPixels * kMinSegmentPixels;
+    int count = 1;
+    for (int i = 1; i < poly.n; ++i) {
+        const ImVec2& last = m_screenPoints[count - 1];
+        const ImVec2& p = m_screenPoints[i];
+        float dx = p.x - last.x;
+        float dy = p.y - last.y;
+        if (dx * dx + dy * dy >= minDist2) m_screenPoints[count++] = p;
+    }
+    // 闭合段同样不能短于一个像素
+    if (count > 1) {
+        float dx = m_screenPoints[count - 1].x - m_screenPoints[0].x;
+        float dy = m_screenPoints[count - 1].y - m_screenPoints[0].y;
+        if (dx * dx + dy * dy < minDist2) --count;
+    }
+    if (count < 2) return;
+
+    drawList->AddPolyline(m_screenPoints.data(), count, color, ImDrawFlags_Closed, 2.0f);
+}
+
+void Application::drawFilledPolygon(ImDrawList* drawList, const Polygon& poly, const Triangulation& fill, ImU32 color,
+                                    const ImVec2& offset, float scale) const {
+    if (poly.n != fill.vertexCount() || fill.empty()) return;
+    // 16 位索引时一次最多引用 65536 个顶点
+    if (sizeof(ImDrawIdx) == 2 && poly.n > 0xFFFF) return;
+
+    m_screenPoints.resize(poly.n);
+    double checksum = 0.0;
+    for (int i = 0; i < poly.n; ++i) {
+        const auto v = poly.vertex(i);
+        checksum += v.x() + v.y();
+        m_screenPoints[i] = ImVec2(offset.x + static_cast<float>(v.x()) * scale,
+                                   offset.y + static_cast<float>(v.y()) * scale);
+    }
+    if (!std::isfinite(checksum)) return; // drawPolygon() 会报告并画出有效的部分
+
+    const std::vector<uint32_t>& indices = fill.indices();
+    const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+    drawList->PrimReserve(static_cast<int>(indices.size()), poly.n);
+    // PrimReserve() 可能开启新的顶点偏移，所以在它之后再读取基准编号
+    const unsigned int base = drawList->_VtxCurrentIdx;
+    for (int i = 0; i < poly.n; ++i) drawList->PrimWriteVtx(m_screenPoints[i], uv, color);
+    for (uint32_t index : indices) drawList->PrimWriteIdx(static_cast<ImDrawIdx>(base + index));
+}
+
+void Application::shutdown() {
+    // 先停止后台线程，它发布快照时会调用 glfwPostEmptyEvent
+    m_worker.stop();
+
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+
+    if (m_window) {
+        glfwDestroyWindow(m_window);
+    }
+    glfwTerminate();
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#include "MorphWorker.h"
+#include <imgui.h>
+#include <memory>
+#include <vector>
+
+//前向声明 GLFW 窗口
+struct GLFWwindow;
+
+
+/**
+ * @brief 封装 ImGui/GLFW 窗口、主循环和渲染。
+ * 思路：这是将算法与窗口管理和渲染分离的“胶水”类。
+ * 1. init(): 初始化 GLFW, ImGui。
+ * 2. loadData(): 向后台 m_worker 提交加载和预计算任务。
+ * 3. run(): 运行主循环。空闲时阻塞等待事件，只在有变化时重绘。
+ * 4. mainLoop(): 开始新帧, 调用 drawUI(), 渲染。
+ * 5. drawUI(): 绘制 ImGui 控件 (滑块, 按钮) 和视口。
+ * 6. drawPolygon(): 一个辅助函数，将多边形变换到屏幕空间、抽稀后作为一条折线绘制到 ImDrawList。
+ * 7. drawFilledPolygon(): 用快照中源多边形的三角剖分填充多边形；插值帧中有三角形翻转时退回到只画轮廓。
+ */
+class Application{
+
+public:
+    Application();
+    ~Application();
+
+    /**
+     * @brief 初始化 GLFW 窗口, OpenGL 上下文, 和 ImGui。
+     */
+    int init();
+
+    /**
+     * @brief 运行主事件循环。
+     */
+    void run();
+
+private:
+    /**
+     * @brief 主循环的单次迭代。
+     */
+    void mainLoop();
+
+    /**
+     * @brief 处理事件；空闲时用 glfwWaitEventsTimeout 阻塞。
+     * @return 本次迭代是否需要重绘。
+     */
+    bool waitForEvents();
+
+    /**
+     * @brief 请求接下来再绘制几帧（ImGui 的悬停/点击状态需要多帧才能稳定）。
+     */
+    void requestRedraw();
+
+    /**
+     * @brief 清理资源。
+     */
+    void shutdown();
+
+    /**
+     * @brief 绘制所有 ImGui 界面元素。
+     */
+    void drawUI();
+
+    /**
+     * @brief 绘制 "Performance" 窗口：各阶段的耗时历史（来自 Profiler）和内存占用。
+     */
+    void drawPerformanceWindow();
+
+    /**
+     * @brief 辅助函数，将一个多边形绘制到 ImGui 绘图列表。
+     * 顶点一次性变换到屏幕空间，丢弃短于一个像素的线段后用一次 AddPolyline 提交，
+     * 因此绘制开销取决于屏幕上的像素数，而不是顶点数。
+     */
+    void drawPolygon(ImDrawList* drawList, const Polygon& poly, ImU32 color, const ImVec2& offset, float scale) const;
+
+    /**
+     * @brief 按 fill 的索引把多边形作为三角形网格写入 ImDrawList（不抽稀，所有顶点都参与）。
+     * poly 的顶点顺序必须与 fill 剖分时相同；调用者负责确认没有翻转的三角形。
+     */
+    void drawFilledPolygon(ImDrawList* drawList, const Polygon& poly, const Triangulation& fill, ImU32 color,
+                           const ImVec2& offset, float scale) const;
+
+    /**
+     * @brief 封装了加载和预计算的逻辑。
+     */
+    void loadData();
+
+    /**
+     * @brief 向后台 worker 提交从 from 阶段开始的重新计算。
+     * 过时的任务会被取消；界面继续显示上一个快照，直到新快照发布。
+     */
+    void submitJob(MorphStage from, int manualK = -1);
+
+    GLFWwindow* m_window = nullptr;
+    MorphWorker m_worker;
+    BlendWeights m_weights;
+    std::shared_ptr<const MorphSnapshot> m_snapshot; // 本帧使用的快照
+    uint64_t m_seenGeneration = 0;
+    float m_interpTime = 0.0f;
+    float m_renderScale = 1.0f;
+
+    // --- 按需渲染 ---
+    int m_framesToRender = 0; // > 0 时持续绘制，降到 0 后进入空闲等待
+    Polygon m_interpCache;    // 上一次的插值结果
+    std::shared_ptr<const MorphSnapshot> m_interpCacheSource;
+    float m_interpCacheTime = -1.0f;
+    InterpolationMode m_interpCacheMode = InterpolationMode::Affine;
+    int m_interpInverted = -1;  // 插值结果中第一个翻转的三角形，-1 表示可以填充
+    mutable std::vector<ImVec2> m_screenPoints; // drawPolygon() 的屏幕空间缓冲区，跨帧复用
+
+    // 用于 ImGui 文本输入的缓冲区
+    char m_pathABuf[128];
+    char m_pathBBuf[128];
+
+    bool m_autoFindK = true; // 是否自动寻找 best_k
+    int m_manualK = 0;       // 手动指定的 k 值
+    bool m_filledPreview = true; // 用三角剖分填充源多边形和插值多边形
+    InterpolationMode m_interpMode = InterpolationMode::Affine; // 中间多边形的插值方式
+
+    float m_searchBudget = 0.0f; // 自动搜索 k 的时间预算（秒），0 = 不限时
+    std::string m_cacheDir = ".shapeblender_cache"; // 求解结果的磁盘缓存目录，重新打开同一对多边形时跳过搜索
+};
\ No newline at end of file
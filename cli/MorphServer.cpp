@@ -0,0 +1,450 @@
+#include "MorphServer.h"
+#include "PolygonArchive.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kPollMs = 200;                       // 检查停止标志的间隔
+constexpr size_t kMaxRequestBytes = 64u << 20;     // 单行请求的上限
+constexpr int kMaxFramesPerRequest = 100000;
+
+void appendDouble(std::string& text, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    text.append(buffer, static_cast<size_t>(length));
+}
+
+std::string errorResponse(const std::string& message) {
+    nlohmann::json response = {{"ok", false}, {"error", message}};
+    return response.dump();
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief 从内联的 [[x, y], ...] 数组构造多边形。
+ */
+std::shared_ptr<const Polygon> polygonFromJson(const nlohmann::json& data) {
+    if (!data.is_array()) throw std::runtime_error("inline polygon must be an array of [x, y]");
+    auto poly = std::make_shared<Polygon>();
+    poly->vertices.reserve(data.size());
+    for (const auto& item : data) {
+        poly->vertices.emplace_back(item.at(0).get<double>(), item.at(1).get<double>());
+    }
+    poly->n = static_cast<int>(poly->vertices.size());
+    if (poly->n < 3) throw std::runtime_error("polygon must have at least 3 vertices");
+    poly->precomputeIntrinsics();
+    return poly;
+}
+
+const char* lookupName(MorphCache::Lookup lookup) {
+    switch (lookup) {
+        case MorphCache::Lookup::Hit: return "hit";
+        case MorphCache::Lookup::Coalesced: return "coalesced";
+        case MorphCache::Lookup::Miss: return "miss";
+    }
+    return "miss";
+}
+
+} // namespace
+
+/**
+ * @brief 一个连接的状态。多边形以共享指针持有，和多边形缓存共用同一份数据。
+ */
+struct MorphServer::Session {
+    std::shared_ptr<const Polygon> polyA;
+    std::shared_ptr<const Polygon> polyB;
+    BlendWeights weights;
+    int manualK = -1;
+    MorphCache::Entry morph; // 当前多边形对和权重的求解结果，二者任一改变后清空
+    Polygon frame;
+    std::string out;
+};
+
+void MorphServer::LatencySeries::add(double ms){
+    if (samples.size() < kLatencySamples) samples.push_back(ms);
+    else samples[next] = ms;
+    next = (next + 1) % kLatencySamples;
+    ++count;
+    totalMs += ms;
+    maxMs = std::max(maxMs, ms);
+}
+
+MorphServer::MorphServer(const Options& options)
+    : m_options(options),
+      m_morphs(options.morphCacheEntries),
+      m_polygons(options.polygonCacheEntries) {}
+
+MorphServer::~MorphServer(){
+    stop();
+    for (auto& connection : m_connections) {
+        if (connection.thread.joinable()) connection.thread.join();
+    }
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        ::unlink(m_options.socketPath.c_str());
+    }
+}
+
+bool MorphServer::start(){
+    sockaddr_un addr{};
+    if (m_options.socketPath.empty() || m_options.socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: Socket path is empty or longer than " << sizeof(addr.sun_path) - 1 << " bytes." << std::endl;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, m_options.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        std::cerr << "Error: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 上一次异常退出留下的套接字文件
+    ::unlink(m_options.socketPath.c_str());
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(m_listenFd, 64) < 0) {
+        std::cerr << "Error: Failed to listen on " << m_options.socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    // 客户端中途断开时 send() 返回错误，而不是用 SIGPIPE 结束进程
+    std::signal(SIGPIPE, SIG_IGN);
+    return true;
+}
+
+void MorphServer::serve(){
+    if (m_listenFd < 0) return;
+
+    while (!m_stopping) {
+        // 回收已经结束的连接线程
+        for (auto it = m_connections.begin(); it != m_connections.end();) {
+            if (*it->done) {
+                it->thread.join();
+                it = m_connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        pollfd pfd{m_listenFd, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, kPollMs);
+        if (ready <= 0) continue;
+
+        int fd = ::accept(m_listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        Connection connection;
+        connection.done = std::make_shared<std::atomic<bool>>(false);
+        auto done = connection.done;
+        connection.thread = std::thread([this, fd, done]() {
+            handleConnection(fd);
+            ::close(fd);
+            *done = true;
+        });
+        m_connections.push_back(std::move(connection));
+    }
+
+    for (auto& connection : m_connections) connection.thread.join();
+    m_connections.clear();
+}
+
+void MorphServer::handleConnection(int fd){
+    Session session;
+    std::string buffer;
+    char chunk[64 * 1024];
+
+    while (!m_stopping) {
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, kPollMs);
+        if (ready == 0) continue;
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n == 0) return; // 对方关闭
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        size_t start = 0;
+        for (size_t end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', start)) {
+            std::string line = buffer.substr(start, end - start);
+            start = end + 1;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            std::string response = handleRequest(line, session);
+            response += '\n';
+            if (!sendAll(fd, response)) return;
+        }
+        buffer.erase(0, start);
+
+        if (buffer.size() > kMaxRequestBytes) {
+            sendAll(fd, errorResponse("request line too long") + "\n");
+            return;
+        }
+    }
+}
+
+std::string MorphServer::handleRequest(const std::string& line, Session& session){
+    const auto start = std::chrono::steady_clock::now();
+    std::string command = "invalid";
+    std::string response;
+    bool ok = true;
+
+    // 处理函数用异常报告请求错误（包括 JSON 字段类型不对），在这里统一转换为错误回复
+    try {
+        nlohmann::json request = nlohmann::json::parse(line);
+        if (!request.is_object() || !request.contains("cmd")) {
+            throw std::runtime_error("request must be a JSON object with a \"cmd\" field");
+        }
+        const std::string name = request["cmd"].get<std::string>();
+        command = name;
+        if (name == "load") response = cmdLoad(request, session);
+        else if (name == "weights") response = cmdWeights(request, session);
+        else if (name == "eval") response = cmdEval(request, session);
+        else if (name == "stats") response = cmdStats();
+        else if (name == "shutdown") {
+            stop();
+            response = nlohmann::json({{"ok", true}}).dump();
+        } else {
+            command = "invalid";
+            throw std::runtime_error("unknown command: " + name);
+        }
+    } catch (const std::exception& e) {
+        response = errorResponse(e.what());
+        ok = false;
+    }
+
+    recordLatency(command, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), ok);
+    return response;
+}
+
+std::string MorphServer::cmdLoad(const nlohmann::json& request, Session& session){
+    std::shared_ptr<const Polygon> polys[2];
+    const char* pathKeys[2] = {"pathA", "pathB"};
+    const char* inlineKeys[2] = {"a", "b"};
+    for (int i = 0; i < 2; ++i) {
+        if (request.contains(inlineKeys[i])) polys[i] = polygonFromJson(request[inlineKeys[i]]);
+        else if (request.contains(pathKeys[i])) polys[i] = loadPolygon(request[pathKeys[i]].get<std::string>());
+        else throw std::runtime_error(std::string("missing ") + pathKeys[i] + " or " + inlineKeys[i]);
+    }
+
+    session.polyA = polys[0];
+    session.polyB = polys[1];
+    session.morph.reset();
+
+    nlohmann::json response = {{"ok", true}, {"nA", session.polyA->n}, {"nB", session.polyB->n}};
+    return response.dump();
+}
+
+std::string MorphServer::cmdWeights(const nlohmann::json& request, Session& session){
+    // 先在副本上解析和校验，任何字段出错（类型不对、k 越界）都不改动会话
+    BlendWeights weights = session.weights;
+    int manualK = session.manualK;
+    // 与命令行和批处理清单一致：只给出 w1 时 w2 = 1 - w1，只给出 wS、wR 时 wA = 1 - wS - wR
+    if (request.contains("w1")) {
+        weights.w1 = request["w1"].get<float>();
+        weights.w2 = 1.0f - weights.w1;
+    }
+    if (request.contains("w2")) weights.w2 = request["w2"].get<float>();
+    if (request.contains("smooth_a_wS")) weights.smooth_a_wS = request["smooth_a_wS"].get<float>();
+    if (request.contains("smooth_a_wR")) weights.smooth_a_wR = request["smooth_a_wR"].get<float>();
+    if (request.contains("smooth_a_wS") || request.contains("smooth_a_wR")) {
+        weights.smooth_a_wA = 1.0f - weights.smooth_a_wS - weights.smooth_a_wR;
+    }
+    if (request.contains("smooth_a_wA")) weights.smooth_a_wA = request["smooth_a_wA"].get<float>();
+    if (request.contains("k")) {
+        const nlohmann::json& k = request["k"];
+        if (!k.is_number_integer()) throw std::runtime_error("k must be an integer");
+        manualK = k.get<int>();
+        // k 是 A 的顶点编号；还没有加载多边形时只能先排除负数，加载和求值时再按 A 的顶点数检查
+        const int nA = session.polyA ? session.polyA->n : std::numeric_limits<int>::max();
+        if (manualK != -1 && (manualK < 0 || manualK >= nA)) {
+            throw std::runtime_error("k = " + std::to_string(manualK) + " is out of range (expected -1 or 0.." +
+                                     (session.polyA ? std::to_string(nA - 1) : std::string("n - 1")) + ")");
+        }
+    }
+    session.weights = weights;
+    session.manualK = manualK;
+    session.morph.reset();
+
+    nlohmann::json response = {
+        {"ok", true},
+        {"w1", weights.w1}, {"w2", weights.w2},
+        {"smooth_a_wS", weights.smooth_a_wS}, {"smooth_a_wR", weights.smooth_a_wR}, {"smooth_a_wA", weights.smooth_a_wA},
+        {"k", session.manualK}};
+    return response.dump();
+}
+
+std::string MorphServer::cmdEval(const nlohmann::json& request, Session& session){
+    if (!session.polyA || !session.polyB) throw std::runtime_error("no polygons loaded");
+    // weights 可能在 load 之前设置了 k，换了多边形后它可能已经越界
+    if (session.manualK >= session.polyA->n) {
+        throw std::runtime_error("k = " + std::to_string(session.manualK) + " is out of range (polygon A has " +
+                                 std::to_string(session.polyA->n) + " vertices)");
+    }
+    if (session.manualK >= 0 && session.polyA->n < session.polyB->n) {
+        throw std::runtime_error("k needs polygon A to have at least as many vertices as polygon B");
+    }
+
+    std::vector<float> times;
+    if (request.contains("t")) {
+        times.push_back(request["t"].get<float>());
+    } else if (request.contains("count")) {
+        int count = request["count"].get<int>();
+        if (count < 1 || count > kMaxFramesPerRequest) {
+            throw std::runtime_error("count must be in [1, " + std::to_string(kMaxFramesPerRequest) + "]");
+        }
+        float t0 = request.value("t0", 0.0f);
+        float t1 = request.value("t1", 1.0f);
+        for (int f = 0; f < count; ++f) {
+            times.push_back(count == 1 ? t0 : t0 + (t1 - t0) * static_cast<float>(f) / (count - 1));
+        }
+    } else {
+        throw std::runtime_error("eval needs \"t\" or \"count\" (with optional \"t0\", \"t1\")");
+    }
+    for (float t : times) {
+        if (!std::isfinite(t)) throw std::runtime_error("t must be finite");
+    }
+
+    // 同一会话连续求值时直接复用，不再查缓存
+    const char* source = "session";
+    if (!session.morph) {
+        MorphCache::Lookup lookup = MorphCache::Lookup::Miss;
+        session.morph = m_morphs.getOrSolve(*session.polyA, *session.polyB, session.weights, session.manualK, &lookup);
+        if (!session.morph) throw std::runtime_error("failed to solve the morph");
+        source = lookupName(lookup);
+    }
+
+    std::string& out = session.out;
+    out.clear();
+    out += "{\"ok\": true, \"cache\": \"";
+    out += source;
+    out += "\", \"bestK\": " + std::to_string(session.morph->bestK);
+    out += ", \"n\": " + std::to_string(session.morph->plan.n);
+    out += ", \"frames\": [";
+    for (size_t f = 0; f < times.size(); ++f) {
+        session.morph->plan.evaluate(times[f], session.frame);
+        if (f > 0) out += ", ";
+        out += "[";
+        for (int i = 0; i < session.frame.n; ++i) {
+            if (i > 0) out += ", ";
+            out += "[";
+            appendDouble(out, session.frame.vertices[i].x());
+            out += ", ";
+            appendDouble(out, session.frame.vertices[i].y());
+            out += "]";
+        }
+        out += "]";
+    }
+    out += "]}";
+    return out;
+}
+
+std::string MorphServer::cmdStats(){
+    MorphCache::Stats cache = m_morphs.stats();
+    nlohmann::json response = {{"ok", true}};
+
+    uint64_t lookups = cache.hits + cache.coalesced + cache.misses;
+    response["cache"] = {
+        {"hits", cache.hits}, {"coalesced", cache.coalesced}, {"misses", cache.misses},
+        {"evictions", cache.evictions}, {"entries", cache.entries}, {"capacity", cache.capacity},
+        {"hit_rate", lookups > 0 ? static_cast<double>(cache.hits + cache.coalesced) / lookups : 0.0}};
+
+    {
+        std::lock_guard<std::mutex> lock(m_polygonMutex);
+        response["polygons"] = {
+            {"hits", m_polygonHits}, {"misses", m_polygonMisses},
+            {"entries", m_polygons.size()}, {"capacity", m_polygons.capacity()}};
+    }
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    response["requests"] = m_requests;
+    response["errors"] = m_errors;
+    nlohmann::json latency = nlohmann::json::object();
+    for (const auto& [command, series] : m_latency) {
+        std::vector<double> sorted = series.samples;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double q) {
+            if (sorted.empty()) return 0.0;
+            size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+            return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+        };
+        latency[command] = {
+            {"count", series.count},
+            {"mean", series.count > 0 ? series.totalMs / series.count : 0.0},
+            {"p50", percentile(0.50)}, {"p99", percentile(0.99)}, {"max", series.maxMs}};
+    }
+    response["latency_ms"] = latency;
+    return response.dump();
+}
+
+std::shared_ptr<const Polygon> MorphServer::loadPolygon(const std::string& path){
+    // 归档中的条目以归档文件的修改时间和大小判断是否变化
+    std::string statPath = path, name;
+    PolygonArchive::splitPath(path, statPath, name);
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(statPath, ec);
+    uintmax_t size = ec ? 0 : std::filesystem::file_size(statPath, ec);
+    if (ec) throw std::runtime_error("cannot stat " + statPath + ": " + ec.message());
+
+    {
+        std::lock_guard<std::mutex> lock(m_polygonMutex);
+        if (LoadedPolygon* cached = m_polygons.get(path)) {
+            if (cached->mtime == mtime && cached->size == size) {
+                ++m_polygonHits;
+                return cached->polygon;
+            }
+        }
+        ++m_polygonMisses;
+    }
+
+    // 在锁外读取和解析文件
+    auto poly = std::make_shared<Polygon>();
+    if (!poly->loadFromFile(path)) throw std::runtime_error("failed to load " + path);
+
+    std::lock_guard<std::mutex> lock(m_polygonMutex);
+    m_polygons.put(path, LoadedPolygon{mtime, size, poly});
+    return poly;
+}
+
+void MorphServer::recordLatency(const std::string& command, double ms, bool ok){
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_requests;
+    if (!ok) ++m_errors;
+    m_latency["all"].add(ms);
+    if (command != "invalid") m_latency[command].add(ms);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "LruCache.h"
+#include "MorphCache.h"
+#include "../lib/json/nlohmann/json.hpp"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 常驻的渐变服务：在 Unix 域套接字上接受按行分隔的 JSON 请求。
+ * 进程启动、JSON 解析和对应关系求解只在第一次遇到某对多边形时付出：
+ * - 按路径缓存已加载的多边形（文件的修改时间或大小变化后重新加载）；
+ * - 按多边形内容哈希 + 权重缓存已求解的渐变 (MorphCache, LRU)。
+ *
+ * 每个连接是一个会话，保存当前的多边形对和权重。请求（每行一个 JSON 对象）：
+ *   {"cmd": "load", "pathA": "...", "pathB": "..."}     或内联顶点 "a"/"b": [[x, y], ...]
+ *   {"cmd": "weights", "w1": 0.6, "smooth_a_wS": 0.5, "k": -1}   未给出的字段保持不变
+ *   {"cmd": "eval", "t": 0.5}                            或 {"cmd": "eval", "t0": 0, "t1": 1, "count": 30}
+ *   {"cmd": "stats"}
+ *   {"cmd": "shutdown"}
+ * 每个请求回复一行 JSON，失败时为 {"ok": false, "error": "..."}。
+ */
+class MorphServer {
+public:
+    struct Options {
+        std::string socketPath;
+        size_t morphCacheEntries = 64;
+        size_t polygonCacheEntries = 256;
+    };
+
+    explicit MorphServer(const Options& options);
+    ~MorphServer();
+
+    MorphServer(const MorphServer&) = delete;
+    MorphServer& operator=(const MorphServer&) = delete;
+
+    /**
+     * @brief 创建并监听套接字（已存在的同名套接字文件会被替换）。
+     */
+    bool start();
+
+    /**
+     * @brief 接受连接并处理请求，阻塞直到 stop() 或收到 shutdown 请求。
+     */
+    void serve();
+
+    /**
+     * @brief 请求停止；可以从任意线程（包括信号处理之外的线程）调用。
+     */
+    void stop() { m_stopping = true; }
+
+private:
+    struct Session;
+
+    /**
+     * @brief 某类请求的延迟统计，保留最近 kLatencySamples 个样本用于求百分位数。
+     */
+    struct LatencySeries {
+        static constexpr size_t kLatencySamples = 4096;
+        std::vector<double> samples;
+        size_t next = 0;
+        uint64_t count = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+
+        void add(double ms);
+    };
+
+    struct LoadedPolygon {
+        std::filesystem::file_time_type mtime;
+        uintmax_t size = 0;
+        std::shared_ptr<const Polygon> polygon;
+    };
+
+    struct Connection {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    Options m_options;
+    int m_listenFd = -1;
+    std::atomic<bool> m_stopping{false};
+    std::vector<Connection> m_connections;
+
+    MorphCache m_morphs;
+
+    std::mutex m_polygonMutex;
+    LruCache<std::string, LoadedPolygon> m_polygons;
+    uint64_t m_polygonHits = 0;
+    uint64_t m_polygonMisses = 0;
+
+    std::mutex m_statsMutex;
+    std::map<std::string, LatencySeries> m_latency; // 按请求类型，"all" 为全部
+    uint64_t m_requests = 0;
+    uint64_t m_errors = 0;
+
+    void handleConnection(int fd);
+    std::string handleRequest(const std::string& line, Session& session);
+
+    std::string cmdLoad(const nlohmann::json& request, Session& session);
+    std::string cmdWeights(const nlohmann::json& request, Session& session);
+    std::string cmdEval(const nlohmann::json& request, Session& session);
+    std::string cmdStats();
+
+    /**
+     * @brief 按路径加载多边形，优先使用缓存。以下处理函数都用 std::runtime_error 报告请求错误。
+     */
+    std::shared_ptr<const Polygon> loadPolygon(const std::string& path);
+    void recordLatency(const std::string& command, double ms, bool ok);
+};
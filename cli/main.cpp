@@ -0,0 +1,1044 @@
+#include "ShapeBlender.h"
+#include "AdaptiveSampling.h"
+#include "MorphBatch.h"
+#include "FrameCodec.h"
+#include "FrameExporter.h"
+#include "FrameFile.h"
+#include "MorphDiskCache.h"
+#include "PolygonArchive.h"
+#include "Rasterizer.h"
+#include "SelfIntersection.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef SHAPEBLENDER_HAS_SERVER
+#include "MorphServer.h"
+#endif
+
+/**
+ * @brief 无界面的命令行入口。
+ * 思路：只链接算法核心（Polygon、ShapeBlender），不依赖 GLFW/OpenGL/ImGui，
+ * 可以在没有显示器的渲染节点上运行：求解对应关系，按给定的 t 输出帧和计时摘要。
+ */
+
+namespace {
+
+struct MorphOptions {
+    std::string pathA;
+    std::string pathB;
+    BlendWeights weights;
+    int manualK = -1;             // -1 = 自动搜索
+    double searchBudget = 0.0;    // 自动搜索的时间预算（秒）
+    int frameCount = 11;          // 均匀采样的帧数（含 t=0 和 t=1）
+    std::vector<float> times;     // 显式给出的 t，非空时优先于 frameCount
+    double adaptiveTolerance = 0.0; // > 0 时求解之后按几何变化放置帧（见 applyAdaptiveTimes()）
+    std::string outDir = "frames";
+    std::string cacheDir;         // 非空时把求解结果缓存到该目录
+    BatchFormat format = BatchFormat::Frames; // Json 时每帧一个 frame_XXXX.json，否则一个 frames.<扩展名>
+    FrameCodecOptions codec;
+    bool quiet = false;
+};
+
+struct BatchOptions {
+    std::string manifest;
+    BatchJob defaults;            // 清单行未指定时使用的权重、k 和帧数
+    double searchBudget = 0.0;
+    unsigned threads = 0;         // 0 = 硬件并发数
+    std::string outDir = "batch_out";
+    std::string cacheDir;
+    BatchFormat format = BatchFormat::Frames;
+    FrameCodecOptions codec;
+    bool verbose = false;
+};
+
+void printUsage(std::ostream& os) {
+    os << "Usage: ShapeBlenderCLI morph <polyA.json> <polyB.json> [options]\n"
+          "       ShapeBlenderCLI batch <manifest.jsonl> [options]\n"
+          "       ShapeBlenderCLI serve --socket <path> [options]\n"
+          "       ShapeBlenderCLI convert <poly.json>... [options]\n"
+          "       ShapeBlenderCLI pack <dir|poly>... --out <library.sba> [options]\n"
+          "       ShapeBlenderCLI decode <frames.sbz> [options]\n"
+          "       ShapeBlenderCLI render <polyA.json> <polyB.json> [options]\n"
+          "       ShapeBlenderCLI validate <polyA.json> <polyB.json> [options]\n"
+          "\n"
+          "Solver options (morph and batch):\n"
+          "  --w1 <v>          sim_t edge weight, w2 = 1 - w1 (default 0.5)\n"
+          "  --ws <v>          smooth_a shape weight (default 0.333)\n"
+          "  --wr <v>          smooth_a rotation weight (default 0.333), wA = 1 - wS - wR\n"
+          "  --k <k>           use a manual start vertex k instead of the auto search\n"
+          "  --budget <s>      time budget for the auto k search in seconds (0 = unlimited)\n"
+          "  --cache-dir <dir> reuse and store solved correspondences in <dir>/<key>.sbc\n"
+          "  --frames <n>      number of uniformly spaced t samples in [0, 1] (default 11)\n"
+          "\n"
+          "Output options (morph and batch):\n"
+          "  --precision <v>   quantization step of --format sbz (default 1e-4)\n"
+          "  --keyframes <n>   keyframe interval of --format sbz (default 30)\n"
+          "\n"
+          "morph options:\n"
+          "  --t <t0,t1,...>   explicit comma separated t samples\n"
+          "  --adaptive <d>    instead of --frames, place the fewest frames such that no vertex moves more than d\n"
+          "                    between consecutive frames (polygon units; pixels for render), dense only where it moves fast\n"
+          "  --out <dir>       output directory (default: frames)\n"
+          "  --format <f>      sbf: one memory-mappable frames.sbf (default); sbz: one compressed frames.sbz;\n"
+          "                    csv: frames.csv; svg: frames.svg (one path per frame); json: frame_XXXX.json per frame\n"
+          "                    (sbz, csv and svg are serialized on a writer thread while the next frames are evaluated)\n"
+          "  --quiet           suppress the solver log\n"
+          "\n"
+          "batch options (manifest lines: {\"pathA\", \"pathB\", \"weights\", \"frames\", \"k\", \"output\"}):\n"
+          "  --threads <n>     worker threads (default: hardware concurrency)\n"
+          "  --out <dir>       output directory, one file per manifest line (default: batch_out)\n"
+          "  --format <f>      sbf: memory-mappable frame file (default); sbz: compressed frame stream;\n"
+          "                    csv: frame,t,vertex,x,y table; svg: one path per frame; json: one JSON document\n"
+          "  --verbose         print the solver log and every finished pair\n"
+          "\n"
+          "serve options (line-based JSON over a Unix socket: load, weights, eval, stats, shutdown):\n"
+          "  --socket <path>   Unix domain socket to listen on\n"
+          "  --cache <n>       prepared morphs kept in the LRU cache (default 64)\n"
+          "  --polygons <n>    loaded polygon files kept in the LRU cache (default 256)\n"
+          "  --verbose         print the solver log\n"
+          "\n"
+          "convert options (JSON -> memory-mapped binary .sbp, accepted everywhere a polygon path is):\n"
+          "  --out <dir>       output directory (default: next to each input)\n"
+          "  --no-intrinsics   store only the vertices (smaller files, intrinsics recomputed on load)\n"
+          "\n"
+          "pack options (one indexed archive; polygons are referenced as <library.sba>#<name>):\n"
+          "  --out <file>      archive to write\n"
+          "  --threads <n>     worker threads (default: hardware concurrency)\n"
+          "  --no-intrinsics   as for convert\n"
+          "\n"
+          "decode options (compressed .sbz -> memory-mappable .sbf):\n"
+          "  --out <file>      frame file to write (default: the input with the extension .sbf)\n"
+          "  --frame <k>       print frame k as [[x, y], ...] instead, decoded from the nearest keyframe\n"
+          "\n"
+          "render options (software rasterizer, no GPU; also accepts the solver options and --t, --adaptive, --cache-dir, --quiet):\n"
+          "  --out <dir>       output directory for frame_XXXX.png / .ppm (default: render)\n"
+          "  --image <f>       png (stored deflate, default) or ppm\n"
+          "  --size <WxH>      image size in pixels (default 512x512, at most 16384 per side)\n"
+          "  --samples <n>     anti-aliasing sub-scanlines per pixel row (default 4)\n"
+          "  --fill <rrggbb[aa]>, --background <rrggbb[aa]>  colors (default white on black)\n"
+          "  --threads <n>     worker threads (default: hardware concurrency)\n"
+          "  --parallel <p>    frames: one frame per thread (default); tiles: each frame split into row tiles\n"
+          "\n"
+          "validate options (self-intersection check of every frame, O(n log n) sweep; exit code 3 if any frame is bad;\n"
+          "also accepts the solver options and --t, --adaptive, --cache-dir, --quiet):\n"
+          "  --scan            instead of the --frames/--t samples, scan [0, 1] adaptively and report the first bad t\n"
+          "  --tolerance <dt>  precision of the first bad t for --scan (default 1e-4)\n"
+          "  --max-step <v>    --scan checks again once any vertex moved this fraction of the shape's diagonal (default 0.01)\n";
+}
+
+/**
+ * @brief 解析两个命令共用的求解参数。
+ * @return 1 = 已处理，0 = 不是求解参数，-1 = 缺少参数值。
+ */
+int parseSolverOption(const std::string& arg, const std::function<const char*(const char*)>& next,
+                      BlendWeights& weights, int& manualK, double& searchBudget, int& frameCount) {
+    const char* v = nullptr;
+    if (arg == "--w1") {
+        if (!(v = next("--w1"))) return -1;
+        weights.w1 = std::strtof(v, nullptr);
+        weights.w2 = 1.0f - weights.w1;
+    } else if (arg == "--ws") {
+        if (!(v = next("--ws"))) return -1;
+        weights.smooth_a_wS = std::strtof(v, nullptr);
+    } else if (arg == "--wr") {
+        if (!(v = next("--wr"))) return -1;
+        weights.smooth_a_wR = std::strtof(v, nullptr);
+    } else if (arg == "--k") {
+        if (!(v = next("--k"))) return -1;
+        char* end = nullptr;
+        const long k = std::strtol(v, &end, 10);
+        if (end == v || *end != '\0' || k < 0 || k > std::numeric_limits<int>::max()) {
+            std::cerr << "Error: --k must be a non-negative integer: " << v << std::endl;
+            return -1;
+        }
+        manualK = static_cast<int>(k);
+    } else if (arg == "--budget") {
+        if (!(v = next("--budget"))) return -1;
+        searchBudget = std::strtod(v, nullptr);
+    } else if (arg == "--frames") {
+        if (!(v = next("--frames"))) return -1;
+        frameCount = std::atoi(v);
+    } else {
+        return 0;
+    }
+    weights.smooth_a_wA = 1.0f - weights.smooth_a_wS - weights.smooth_a_wR;
+    return 1;
+}
+
+/**
+ * @brief 解析两个命令共用的输出格式参数。
+ * @return 1 = 已处理，0 = 不是输出参数，-1 = 缺少或无效的参数值。
+ */
+int parseFormatOption(const std::string& arg, const std::function<const char*(const char*)>& next,
+                      BatchFormat& format, FrameCodecOptions& codec) {
+    const char* v = nullptr;
+    if (arg == "--format") {
+        if (!(v = next("--format"))) return -1;
+        const std::string name = v;
+        if (name == "sbf") {
+            format = BatchFormat::Frames;
+        } else if (name == "sbz") {
+            format = BatchFormat::Compressed;
+        } else if (name == "csv") {
+            format = BatchFormat::Csv;
+        } else if (name == "svg") {
+            format = BatchFormat::Svg;
+        } else if (name == "json") {
+            format = BatchFormat::Json;
+        } else {
+            std::cerr << "Error: --format must be sbf, sbz, csv, svg or json." << std::endl;
+            return -1;
+        }
+    } else if (arg == "--precision") {
+        if (!(v = next("--precision"))) return -1;
+        codec.precision = std::strtod(v, nullptr);
+        if (!(codec.precision > 0.0)) {
+            std::cerr << "Error: --precision must be > 0." << std::endl;
+            return -1;
+        }
+    } else if (arg == "--keyframes") {
+        if (!(v = next("--keyframes"))) return -1;
+        codec.keyframeInterval = std::atoi(v);
+        if (codec.keyframeInterval < 1) {
+            std::cerr << "Error: --keyframes must be >= 1." << std::endl;
+            return -1;
+        }
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+bool parseFloatList(const std::string& text, std::vector<float>& out) {
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        float value = std::strtof(item.c_str(), &end);
+        if (end == item.c_str() || *end != '\0') return false;
+        out.push_back(value);
+    }
+    return !out.empty();
+}
+
+/**
+ * @brief 其他命令在 morph 参数之外追加的参数。返回值同 parseSolverOption()。
+ */
+using ExtraOptionParser = std::function<int(const std::string&, const std::function<const char*(const char*)>&)>;
+
+bool parseMorphOptions(int argc, char** argv, MorphOptions& opts, const ExtraOptionParser& extra = nullptr) {
+    std::vector<std::string> positional;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::function<const char*(const char*)> next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << name << " needs a value." << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        int solver = parseSolverOption(arg, next, opts.weights, opts.manualK, opts.searchBudget, opts.frameCount);
+        if (solver < 0) return false;
+        if (solver > 0) continue;
+        int output = parseFormatOption(arg, next, opts.format, opts.codec);
+        if (output < 0) return false;
+        if (output > 0) continue;
+        int handled = extra ? extra(arg, next) : 0;
+        if (handled < 0) return false;
+        if (handled > 0) continue;
+
+        if (arg == "--t") {
+            const char* v = next("--t"); if (!v) return false;
+            if (!parseFloatList(v, opts.times)) {
+                std::cerr << "Error: Invalid t list: " << v << std::endl;
+                return false;
+            }
+        } else if (arg == "--adaptive") {
+            const char* v = next("--adaptive"); if (!v) return false;
+            opts.adaptiveTolerance = std::strtod(v, nullptr);
+            if (!(opts.adaptiveTolerance > 0.0)) {
+                std::cerr << "Error: --adaptive must be > 0." << std::endl;
+                return false;
+            }
+        } else if (arg == "--out") {
+            const char* v = next("--out"); if (!v) return false;
+            opts.outDir = v;
+        } else if (arg == "--cache-dir") {
+            const char* v = next("--cache-dir"); if (!v) return false;
+            opts.cacheDir = v;
+        } else if (arg == "--quiet") {
+            opts.quiet = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            return false;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 2) {
+        std::cerr << "Error: Expected exactly two polygon paths." << std::endl;
+        return false;
+    }
+    opts.pathA = positional[0];
+    opts.pathB = positional[1];
+
+    if (opts.adaptiveTolerance > 0.0) {
+        if (!opts.times.empty()) {
+            std::cerr << "Error: --adaptive and --t cannot be combined." << std::endl;
+            return false;
+        }
+        return true; // 帧在求解之后由 applyAdaptiveTimes() 放置
+    }
+    if (opts.times.empty()) {
+        if (opts.frameCount < 1) {
+            std::cerr << "Error: --frames must be >= 1." << std::endl;
+            return false;
+        }
+        for (int f = 0; f < opts.frameCount; ++f) {
+            opts.times.push_back(opts.frameCount == 1 ? 0.0f : static_cast<float>(f) / (opts.frameCount - 1));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 以与输入相同的 [[x, y], ...] 格式写出一帧。
+ */
+bool writeFrame(const std::filesystem::path& path, const Polygon& poly) {
+    std::ofstream f(path);
+    if (!f.is_open()) {
+        std::cerr << "Error: Failed to write frame: " << path << std::endl;
+        return false;
+    }
+    f << std::setprecision(10) << "[";
+    for (int i = 0; i < poly.n; ++i) {
+        if (i > 0) f << ", ";
+        f << "[" << poly.vertices[i].x() << ", " << poly.vertices[i].y() << "]";
+    }
+    f << "]\n";
+    return static_cast<bool>(f);
+}
+
+/**
+ * @brief 按 morph 的参数加载并求解（可选使用磁盘缓存）。
+ */
+bool solveFromOptions(const MorphOptions& opts, ShapeBlender& blender) {
+    // --quiet：把核心算法打印到 std::cout 的日志丢掉
+    std::ofstream nullStream;
+    std::streambuf* coutBuf = std::cout.rdbuf();
+    if (opts.quiet) std::cout.rdbuf(nullStream.rdbuf());
+
+    blender.setWeights(opts.weights);
+    if (!blender.loadPolygons(opts.pathA, opts.pathB)) {
+        std::cout.rdbuf(coutBuf);
+        return false;
+    }
+    if (opts.manualK >= blender.getPolyA().n) {
+        std::cout.rdbuf(coutBuf);
+        std::cerr << "Error: --k " << opts.manualK << " is out of range; polygon A has " << blender.getPolyA().n
+                  << " vertices." << std::endl;
+        return false;
+    }
+
+    KSearchProgress progress;
+    progress.timeBudgetSeconds = opts.searchBudget;
+    if (!opts.cacheDir.empty()) {
+        MorphDiskCache(opts.cacheDir).solve(blender, opts.manualK, &progress);
+    } else {
+        blender.computeCorrespondence(opts.manualK, &progress);
+        blender.findOptimalBasis();
+    }
+    std::cout.rdbuf(coutBuf);
+
+    if (blender.getPlan().empty()) {
+        std::cerr << "Error: Failed to solve the morph." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief --adaptive：求解之后按计划的闭式轨迹放置帧（adaptiveSampleTimes）。
+ * unitsPerTolerance 把容差换算成多边形坐标，例如 render 的一个像素。未指定 --adaptive 时什么也不做。
+ */
+bool applyAdaptiveTimes(MorphOptions& opts, const MorphPlan& plan, double unitsPerTolerance = 1.0) {
+    if (!(opts.adaptiveTolerance > 0.0)) return true;
+    AdaptiveSamplingOptions sampling;
+    sampling.tolerance = opts.adaptiveTolerance * unitsPerTolerance;
+    if (!adaptiveSampleTimes(plan, sampling, opts.times)) {
+        std::cerr << "Error: --adaptive " << opts.adaptiveTolerance << " needs more than " << sampling.maxFrames
+                  << " frames; use a larger tolerance." << std::endl;
+        return false;
+    }
+    std::cout << "adaptive: " << opts.times.size() << " frames, at most " << opts.adaptiveTolerance
+              << " between consecutive frames\n";
+    return true;
+}
+
+int runMorph(int argc, char** argv) {
+    MorphOptions opts;
+    if (!parseMorphOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    ShapeBlender blender;
+    if (!solveFromOptions(opts, blender)) return 1;
+    if (!applyAdaptiveTimes(opts, blender.getPlan())) return 1;
+
+    std::error_code ec;
+    std::filesystem::create_directories(opts.outDir, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to create output directory " << opts.outDir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    if (opts.format == BatchFormat::Json) {
+        Polygon frame;
+        for (size_t f = 0; f < opts.times.size(); ++f) {
+            {
+                ScopedTimer timer("interpolate");
+                blender.getPlan().evaluate(opts.times[f], frame);
+            }
+
+            std::ostringstream name;
+            name << "frame_" << std::setw(4) << std::setfill('0') << f << ".json";
+            ScopedTimer timer("write");
+            if (!writeFrame(std::filesystem::path(opts.outDir) / name.str(), frame)) return 1;
+        }
+    } else if (opts.format != BatchFormat::Frames) {
+        // 插值在本线程，序列化在导出器的写线程，两者重叠
+        const char* name = opts.format == BatchFormat::Csv ? "frames.csv" : opts.format == BatchFormat::Svg ? "frames.svg" : "frames.sbz";
+        const ExportFormat format = opts.format == BatchFormat::Csv ? ExportFormat::Csv
+            : opts.format == BatchFormat::Svg ? ExportFormat::Svg : ExportFormat::Compressed;
+        ScopedTimer timer("write");
+        FrameExporter exporter;
+        bool ok = exporter.open((std::filesystem::path(opts.outDir) / name).string(), format, blender.getPlan().n, 8, opts.codec);
+        for (size_t f = 0; ok && f < opts.times.size(); ++f) {
+            ExportFrame* frame = exporter.acquire();
+            if (!frame) break;
+            frame->t = opts.times[f];
+            {
+                ScopedTimer interpolateTimer("interpolate");
+                blender.getPlan().evaluate(frame->t, frame->xy.data());
+            }
+            exporter.commit();
+        }
+        if (!ok || !exporter.finish()) {
+            std::cerr << "Error: " << exporter.error() << std::endl;
+            return 1;
+        }
+        const ExportStats& stats = exporter.stats();
+        std::cout << "export: " << stats.frames << " frames, " << stats.bytes << " bytes; producer waited "
+                  << stats.producerWaitSeconds << " s, writer waited " << stats.writerWaitSeconds << " s\n";
+    } else {
+        ScopedTimer timer("write");
+        FrameFileWriter writer;
+        const int frameCount = static_cast<int>(opts.times.size());
+        bool ok = writer.open((std::filesystem::path(opts.outDir) / "frames.sbf").string(), blender.getPlan().n, frameCount);
+        for (int f = 0; ok && f < frameCount; ++f) {
+            {
+                ScopedTimer interpolateTimer("interpolate");
+                blender.getPlan().evaluate(opts.times[f], writer.frame(f));
+            }
+            writer.setTime(f, opts.times[f]);
+        }
+        if (!ok || !writer.finish()) {
+            std::cerr << "Error: " << writer.error() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "A: " << blender.getPolyA().n << " verts, B: " << blender.getPolyB().n << " verts, best k = "
+              << blender.getBestK() << ", " << opts.times.size() << " frames -> " << opts.outDir << "\n\n";
+    Profiler::instance().report(std::cout);
+
+    std::ofstream timing(std::filesystem::path(opts.outDir) / "timing.txt");
+    Profiler::instance().report(timing);
+    return 0;
+}
+
+bool parseBatchOptions(int argc, char** argv, BatchOptions& opts) {
+    std::vector<std::string> positional;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::function<const char*(const char*)> next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << name << " needs a value." << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        BatchJob& d = opts.defaults;
+        int solver = parseSolverOption(arg, next, d.weights, d.manualK, opts.searchBudget, d.frameCount);
+        if (solver < 0) return false;
+        if (solver > 0) continue;
+        int output = parseFormatOption(arg, next, opts.format, opts.codec);
+        if (output < 0) return false;
+        if (output > 0) continue;
+
+        if (arg == "--threads") {
+            const char* v = next("--threads"); if (!v) return false;
+            opts.threads = static_cast<unsigned>(std::max(0, std::atoi(v)));
+        } else if (arg == "--out") {
+            const char* v = next("--out"); if (!v) return false;
+            opts.outDir = v;
+        } else if (arg == "--cache-dir") {
+            const char* v = next("--cache-dir"); if (!v) return false;
+            opts.cacheDir = v;
+        } else if (arg == "--verbose") {
+            opts.verbose = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            return false;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 1) {
+        std::cerr << "Error: Expected exactly one manifest path." << std::endl;
+        return false;
+    }
+    opts.manifest = positional[0];
+    if (opts.defaults.frameCount < 1) {
+        std::cerr << "Error: --frames must be >= 1." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int runBatch(int argc, char** argv) {
+    BatchOptions opts;
+    if (!parseBatchOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    MorphBatch batch;
+    if (!batch.loadManifest(opts.manifest, opts.defaults)) return 1;
+    batch.m_searchBudget = opts.searchBudget;
+    batch.m_cacheDir = opts.cacheDir;
+    batch.m_format = opts.format;
+    batch.m_codec = opts.codec;
+
+    // 多个工作线程同时打印求解日志只会交错成一团，默认丢掉
+    std::ofstream nullStream;
+    std::streambuf* coutBuf = std::cout.rdbuf();
+    if (!opts.verbose) std::cout.rdbuf(nullStream.rdbuf());
+
+    BatchSummary summary = batch.run(opts.outDir, opts.threads, [&](const BatchResult& result) {
+        if (!result.ok) {
+            std::cerr << "line " << result.line << ": " << result.error << std::endl;
+        } else if (opts.verbose) {
+            std::cout << "line " << result.line << ": k = " << result.bestK << ", "
+                      << result.latencyMs << " ms -> " << result.outputPath << std::endl;
+        }
+    });
+    std::cout.rdbuf(coutBuf);
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1)
+           << "batch: " << summary.total << " pairs (" << summary.succeeded << " ok, " << summary.failed
+           << " failed) in " << std::setprecision(2) << summary.wallSeconds << " s on " << summary.threads << " threads\n"
+           << "throughput: " << summary.pairsPerSecond << " pairs/s\n"
+           << "latency: p50 " << summary.p50Ms << " ms, p99 " << summary.p99Ms << " ms\n\n";
+    Profiler::instance().report(report);
+
+    std::cout << report.str();
+    std::ofstream timing(std::filesystem::path(opts.outDir) / "timing.txt");
+    timing << report.str();
+    return summary.failed == 0 ? 0 : 1;
+}
+
+int runConvert(int argc, char** argv) {
+    std::vector<std::string> inputs;
+    std::string outDir;
+    bool withIntrinsics = true;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --out needs a value." << std::endl;
+                return 2;
+            }
+            outDir = argv[++i];
+        } else if (arg == "--no-intrinsics") {
+            withIntrinsics = false;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        std::cerr << "Error: convert needs at least one polygon file." << std::endl;
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    if (!outDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(outDir, ec);
+        if (ec) {
+            std::cerr << "Error: Failed to create output directory " << outDir << ": " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+
+    int failed = 0;
+    for (const std::string& input : inputs) {
+        std::filesystem::path output = std::filesystem::path(input).replace_extension(".sbp");
+        if (!outDir.empty()) output = std::filesystem::path(outDir) / output.filename();
+
+        Polygon poly;
+        if (!poly.loadFromFile(input) || !poly.saveBinary(output.string(), withIntrinsics)) {
+            ++failed;
+            continue;
+        }
+        std::cout << input << " -> " << output.string() << " (" << poly.n << " verts)" << std::endl;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int runPack(int argc, char** argv) {
+    std::vector<std::string> sources;
+    std::string outPath;
+    unsigned threads = 0;
+    bool withIntrinsics = true;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << name << " needs a value." << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--out") {
+            const char* v = next("--out"); if (!v) return 2;
+            outPath = v;
+        } else if (arg == "--threads") {
+            const char* v = next("--threads"); if (!v) return 2;
+            threads = static_cast<unsigned>(std::max(0, std::atoi(v)));
+        } else if (arg == "--no-intrinsics") {
+            withIntrinsics = false;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        } else {
+            sources.push_back(arg);
+        }
+    }
+    if (sources.empty() || outPath.empty()) {
+        std::cerr << "Error: pack needs input polygons and --out <file>." << std::endl;
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    // 目录展开为其中的 .json 和 .sbp 文件（按文件名排序），条目名为去掉扩展名的文件名
+    std::vector<std::pair<std::string, std::string>> inputs;
+    for (const std::string& source : sources) {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(source, ec)) {
+            inputs.emplace_back(std::filesystem::path(source).stem().string(), source);
+            continue;
+        }
+        std::vector<std::filesystem::path> files;
+        for (const auto& item : std::filesystem::directory_iterator(source, ec)) {
+            const std::string ext = item.path().extension().string();
+            if (item.is_regular_file() && (ext == ".json" || ext == ".sbp")) files.push_back(item.path());
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto& file : files) inputs.emplace_back(file.stem().string(), file.string());
+    }
+    if (inputs.empty()) {
+        std::cerr << "Error: No polygon files found." << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!PolygonArchive::build(inputs, outPath, threads, withIntrinsics)) return 1;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Packed " << inputs.size() << " polygons into " << outPath << " in " << std::fixed
+              << std::setprecision(2) << seconds << " s" << std::endl;
+    return 0;
+}
+
+#ifdef SHAPEBLENDER_HAS_SERVER
+MorphServer* g_server = nullptr;
+
+void onStopSignal(int) {
+    if (g_server) g_server->stop(); // 只写一个原子标志
+}
+
+int runServe(int argc, char** argv) {
+    MorphServer::Options options;
+    bool verbose = false;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << name << " needs a value." << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--socket") {
+            const char* v = next("--socket"); if (!v) return 2;
+            options.socketPath = v;
+        } else if (arg == "--cache") {
+            const char* v = next("--cache"); if (!v) return 2;
+            options.morphCacheEntries = static_cast<size_t>(std::max(1, std::atoi(v)));
+        } else if (arg == "--polygons") {
+            const char* v = next("--polygons"); if (!v) return 2;
+            options.polygonCacheEntries = static_cast<size_t>(std::max(1, std::atoi(v)));
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+    }
+    if (options.socketPath.empty()) {
+        std::cerr << "Error: serve needs --socket <path>." << std::endl;
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    MorphServer server(options);
+    if (!server.start()) return 1;
+    std::cout << "Listening on " << options.socketPath << std::endl;
+
+    g_server = &server;
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    // 常驻进程不需要每次求解的日志
+    std::ofstream nullStream;
+    std::streambuf* coutBuf = std::cout.rdbuf();
+    if (!verbose) std::cout.rdbuf(nullStream.rdbuf());
+    server.serve();
+    std::cout.rdbuf(coutBuf);
+
+    g_server = nullptr;
+    std::cout << "Server stopped." << std::endl;
+    return 0;
+}
+#endif
+
+int runDecode(int argc, char** argv) {
+    std::string input;
+    std::string output;
+    int frame = -1;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--frame" && i + 1 < argc) {
+            const char* v = argv[++i];
+            char* end = nullptr;
+            const long k = std::strtol(v, &end, 10);
+            if (end == v || *end != '\0' || k < 0 || k > std::numeric_limits<int>::max()) {
+                std::cerr << "Error: --frame must be a non-negative integer: " << v << std::endl;
+                return 2;
+            }
+            frame = static_cast<int>(k);
+        } else if (arg.rfind("--", 0) == 0 || !input.empty()) {
+            std::cerr << "Error: Unexpected argument " << arg << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        } else {
+            input = arg;
+        }
+    }
+    if (input.empty()) {
+        std::cerr << "Error: Expected a .sbz path." << std::endl;
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    std::ifstream in(input, std::ios::binary);
+    FrameStreamDecoder decoder;
+    if (!in.is_open() || !decoder.open(in)) {
+        std::cerr << "Error: Failed to open " << input << ": " << decoder.error() << std::endl;
+        return 1;
+    }
+    const int n = decoder.vertexCount();
+    std::vector<double> xy(2 * static_cast<size_t>(n));
+    float t = 0.0f;
+
+    if (frame >= 0) {
+        if (!decoder.seek(frame) || !decoder.next(t, xy.data())) {
+            std::cerr << "Error: Failed to decode frame " << frame << ": " << decoder.error() << std::endl;
+            return 1;
+        }
+        std::cout << std::setprecision(10) << "[";
+        for (int i = 0; i < n; ++i) std::cout << (i > 0 ? ", [" : "[") << xy[2 * i] << ", " << xy[2 * i + 1] << "]";
+        std::cout << "]\n";
+        return 0;
+    }
+
+    // 不可定位的输入（例如管道）没有索引，帧数未知：先全部解码到内存
+    std::vector<float> times;
+    std::vector<float> frames;
+    while (decoder.next(t, xy.data())) {
+        times.push_back(t);
+        frames.insert(frames.end(), xy.begin(), xy.end());
+    }
+    if (!decoder.error().empty()) {
+        std::cerr << "Error: Failed to decode frame " << times.size() << ": " << decoder.error() << std::endl;
+        return 1;
+    }
+
+    if (output.empty()) output = std::filesystem::path(input).replace_extension(".sbf").string();
+    const int frameCount = static_cast<int>(times.size());
+    FrameFileWriter writer;
+    if (!writer.open(output, n, frameCount)) {
+        std::cerr << "Error: " << writer.error() << std::endl;
+        return 1;
+    }
+    for (int f = 0; f < frameCount; ++f) {
+        std::copy_n(frames.data() + xy.size() * f, xy.size(), writer.frame(f));
+        writer.setTime(f, times[f]);
+    }
+    if (!writer.finish()) {
+        std::cerr << "Error: " << writer.error() << std::endl;
+        return 1;
+    }
+    std::cout << input << ": " << frameCount << " frames x " << n << " vertices -> " << output << std::endl;
+    return 0;
+}
+
+bool parseColor(const std::string& text, std::array<uint8_t, 4>& color) {
+    std::string hex = text[0] == '#' ? text.substr(1) : text;
+    if (hex.size() != 6 && hex.size() != 8) return false;
+    if (hex.size() == 6) hex += "ff";
+    for (int c = 0; c < 4; ++c) {
+        char* end = nullptr;
+        const std::string byte = hex.substr(2 * c, 2);
+        const long value = std::strtol(byte.c_str(), &end, 16);
+        if (*end != '\0') return false;
+        color[c] = static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+int runRender(int argc, char** argv) {
+    MorphOptions opts;
+    opts.outDir = "render";
+    RasterOptions raster;
+    RasterFormat format = RasterFormat::Png;
+    RasterParallelism parallelism = RasterParallelism::Frames;
+    unsigned threads = 0;
+
+    auto extra = [&](const std::string& arg, const std::function<const char*(const char*)>& next) -> int {
+        const char* v = nullptr;
+        if (arg == "--image") {
+            if (!(v = next("--image"))) return -1;
+            if (std::string(v) != "png" && std::string(v) != "ppm") {
+                std::cerr << "Error: --image must be png or ppm." << std::endl;
+                return -1;
+            }
+            format = std::string(v) == "png" ? RasterFormat::Png : RasterFormat::Ppm;
+        } else if (arg == "--size") {
+            if (!(v = next("--size"))) return -1;
+            if (std::sscanf(v, "%dx%d", &raster.width, &raster.height) != 2 || raster.width <= 0 || raster.height <= 0) {
+                std::cerr << "Error: --size must look like 640x480." << std::endl;
+                return -1;
+            }
+            if (raster.width > kMaxRasterSize || raster.height > kMaxRasterSize) {
+                std::cerr << "Error: --size is limited to " << kMaxRasterSize << " pixels per side." << std::endl;
+                return -1;
+            }
+        } else if (arg == "--samples") {
+            if (!(v = next("--samples"))) return -1;
+            raster.samples = std::max(1, std::atoi(v));
+        } else if (arg == "--fill" || arg == "--background") {
+            if (!(v = next(arg.c_str()))) return -1;
+            if (!parseColor(v, arg == "--fill" ? raster.fill : raster.background)) {
+                std::cerr << "Error: " << arg << " must be rrggbb or rrggbbaa." << std::endl;
+                return -1;
+            }
+        } else if (arg == "--threads") {
+            if (!(v = next("--threads"))) return -1;
+            threads = static_cast<unsigned>(std::max(0, std::atoi(v)));
+        } else if (arg == "--parallel") {
+            if (!(v = next("--parallel"))) return -1;
+            if (std::string(v) != "frames" && std::string(v) != "tiles") {
+                std::cerr << "Error: --parallel must be frames or tiles." << std::endl;
+                return -1;
+            }
+            parallelism = std::string(v) == "frames" ? RasterParallelism::Frames : RasterParallelism::Tiles;
+        } else {
+            return 0;
+        }
+        return 1;
+    };
+    if (!parseMorphOptions(argc, argv, opts, extra)) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    ShapeBlender blender;
+    if (!solveFromOptions(opts, blender)) return 1;
+    if (opts.adaptiveTolerance > 0.0) {
+        // 容差以像素计。视图是所有帧的总包围盒，至少包含首尾两帧；按首尾两帧的视图换算，
+        // 它的缩放不小于最终视图的缩放，得到的多边形坐标容差偏保守
+        const MorphPlan& plan = blender.getPlan();
+        std::vector<double> xy(2 * static_cast<size_t>(plan.n));
+        double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+        for (float t : {0.0f, 1.0f}) {
+            plan.evaluate(t, xy.data());
+            for (int i = 0; i < plan.n; ++i) {
+                minX = std::min(minX, xy[2 * i]);
+                maxX = std::max(maxX, xy[2 * i]);
+                minY = std::min(minY, xy[2 * i + 1]);
+                maxY = std::max(maxY, xy[2 * i + 1]);
+            }
+        }
+        const RasterTransform view = RasterTransform::fit(minX, minY, maxX, maxY, raster.width, raster.height);
+        if (!applyAdaptiveTimes(opts, plan, 1.0 / view.scale)) return 1;
+    }
+
+    RasterSequenceStats stats;
+    if (!renderMorphSequence(blender.getPlan(), opts.times, raster, format, opts.outDir, parallelism, threads, &stats)) {
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << "render: " << stats.frames << " frames of " << raster.width << "x"
+              << raster.height << " in " << stats.wallSeconds << " s (" << std::setprecision(1) << stats.framesPerSecond
+              << " frames/s) -> " << opts.outDir << "\n\n";
+    Profiler::instance().report(std::cout);
+    return 0;
+}
+
+int runValidate(int argc, char** argv) {
+    MorphOptions opts;
+    bool scan = false;
+    IntersectionScanOptions scanOptions;
+
+    auto extra = [&](const std::string& arg, const std::function<const char*(const char*)>& next) -> int {
+        const char* v = nullptr;
+        if (arg == "--scan") {
+            scan = true;
+        } else if (arg == "--tolerance") {
+            if (!(v = next("--tolerance"))) return -1;
+            scanOptions.tolerance = std::strtof(v, nullptr);
+            if (!(scanOptions.tolerance > 0.0f)) {
+                std::cerr << "Error: --tolerance must be > 0." << std::endl;
+                return -1;
+            }
+        } else if (arg == "--max-step") {
+            if (!(v = next("--max-step"))) return -1;
+            scanOptions.maxStep = std::strtod(v, nullptr);
+            if (!(scanOptions.maxStep > 0.0)) {
+                std::cerr << "Error: --max-step must be > 0." << std::endl;
+                return -1;
+            }
+        } else {
+            return 0;
+        }
+        return 1;
+    };
+    if (!parseMorphOptions(argc, argv, opts, extra)) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    ShapeBlender blender;
+    if (!solveFromOptions(opts, blender)) return 1;
+    const MorphPlan& plan = blender.getPlan();
+    if (!applyAdaptiveTimes(opts, plan)) return 1;
+
+    bool found = false;
+    if (scan) {
+        IntersectionScanResult result;
+        found = scanSelfIntersections(plan, scanOptions, result);
+        if (found) {
+            std::cout << "self-intersection: first at t = " << result.firstBadT << " (edges " << result.edgeA << " and "
+                      << result.edgeB << "), last good t = " << result.lastGoodT;
+        } else {
+            std::cout << "no self-intersection in [" << scanOptions.tBegin << ", " << scanOptions.tEnd << "]";
+        }
+        std::cout << "; " << result.checks << " checks, " << result.evaluations << " evaluations\n\n";
+    } else {
+        SelfIntersectionChecker checker;
+        std::vector<double> xy(2 * static_cast<size_t>(plan.n));
+        int bad = 0;
+        for (float t : opts.times) {
+            {
+                ScopedTimer timer("interpolate");
+                plan.evaluate(t, xy.data());
+            }
+            bool simple;
+            {
+                ScopedTimer timer("self_intersection");
+                simple = checker.isSimple(xy.data(), plan.n);
+            }
+            if (simple) continue;
+            if (bad == 0) {
+                std::cout << "self-intersection: first at t = " << t << " (edges " << checker.edgeA() << " and "
+                          << checker.edgeB() << ")\n";
+            }
+            ++bad;
+        }
+        found = bad > 0;
+        std::cout << bad << " of " << opts.times.size() << " frames self-intersect (" << plan.n << " vertices)\n\n";
+    }
+    Profiler::instance().report(std::cout);
+    return found ? 3 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    if (command == "morph") return runMorph(argc - 2, argv + 2);
+    if (command == "batch") return runBatch(argc - 2, argv + 2);
+    if (command == "convert") return runConvert(argc - 2, argv + 2);
+    if (command == "pack") return runPack(argc - 2, argv + 2);
+    if (command == "decode") return runDecode(argc - 2, argv + 2);
+    if (command == "render") return runRender(argc - 2, argv + 2);
+    if (command == "validate") return runValidate(argc - 2, argv + 2);
+#ifdef SHAPEBLENDER_HAS_SERVER
+    if (command == "serve") return runServe(argc - 2, argv + 2);
+#endif
+    if (command == "-h" || command == "--help" || command == "help") {
+        printUsage(std::cout);
+        return 0;
+    }
+
+    std::cerr << "Error: Unknown command " << command << std::endl;
+    printUsage(std::cerr);
+    return 2;
+}
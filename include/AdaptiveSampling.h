@@ -0,0 +1,25 @@
+#pragma once
+
+#include "MorphPlan.h"
+#include <vector>
+
+/**
+ * @brief adaptiveSampleTimes() 的参数。
+ */
+struct AdaptiveSamplingOptions {
+    double tolerance = 1.0; // 相邻两帧之间任一顶点的最大位移（多边形坐标）
+    float tBegin = 0.0f;
+    float tEnd = 1.0f;
+    int maxFrames = 10000;  // 超过时放弃（容差相对运动过小）
+};
+
+/**
+ * @brief 按几何变化放置帧：从 tBegin 起贪心地取最长的一步 [t0, t1]，使区间内任一时刻的任一顶点
+ * 离上一帧都不超过 tolerance。位移的上界逐顶点取 MorphPlan::speedBounds() 的 speed * dt 与
+ * “精确的弦长 + accel * dt^2 / 8”（轨迹偏离弦的距离）中较小的一个，短区间上后者几乎就是真实位移。
+ * 步长先按上一步倍增，再二分到 1% 的精度。
+ * 形状几乎不动的区间只放很少的帧，快速旋转（theta * t 变化大）的区间自动加密；
+ * 结果从 tBegin 开始、到 tEnd 结束，严格递增。
+ * @return 参数无效或帧数超过 maxFrames 时返回 false（times 为空）。
+ */
+bool adaptiveSampleTimes(const MorphPlan& plan, const AdaptiveSamplingOptions& options, std::vector<float>& times);
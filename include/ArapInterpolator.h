@@ -0,0 +1,99 @@
+#pragma once
+
+#include "MorphPlan.h"
+#include "Triangulation.h"
+#include <memory>
+#include <vector>
+#include <Eigen/SparseCholesky>
+
+/**
+ * @brief 中间帧的插值方式。
+ */
+enum class InterpolationMode {
+    Affine = 0, // 仿射基插值（MorphPlan::evaluate），每帧 O(n)
+    Arap = 1,   // 尽可能刚性的内部插值（ArapInterpolator），大角度旋转时不收缩、不翻折
+};
+
+/**
+ * @brief 剖分的边 Laplacian 的预分解（SimplicialLDLT）。
+ * 矩阵只取决于剖分的连接关系，与顶点位置和对应关系都无关：
+ * 同一个源多边形只需分解一次，之后换对应关系、换仿射基都直接复用。
+ * 0 号顶点被固定在原点以消去平移的零空间，剩下的 n - 1 阶矩阵对连通的剖分是正定的。
+ * 构建后只读，可以在多个线程上同时 solve()。
+ */
+class ArapLaplacian {
+public:
+    /**
+     * @brief 组装并分解。剖分为空或分解失败时返回 false。
+     */
+    bool build(const Triangulation& triangulation);
+
+    bool empty() const { return m_n == 0; }
+    int vertexCount() const { return m_n; }
+
+    /**
+     * @brief 解 L X = rhs，rhs 为 (n - 1) x 2（第 0 号顶点已去掉），结果原地写回。
+     */
+    void solve(Eigen::MatrixX2d& rhs) const;
+
+    size_t memoryUsage() const;
+
+private:
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> m_ldlt;
+    int m_n = 0;
+    size_t m_factorBytes = 0;
+};
+
+/**
+ * @brief 在源多边形的三角剖分上做尽可能刚性（ARAP）的插值。
+ * 1. build()：每个三角形从源到目标的仿射映射 M 做极分解 M = R(phi) S，只在对应关系改变时做一次，O(n)。
+ *    phi 取最接近计划整体旋转角 theta 的那个值，使相邻三角形和大于 180° 的旋转都按同一方向转。
+ * 2. 每一帧：三角形 k 的目标映射为 M_k(s) = R(s phi_k) ((1 - s) I + s S_k)，
+ *    s 为插值参数（与 MorphPlan 的 t_f 相同）。求各边 (p_j - p_i) 与 M_k(s) (a_j - a_i) 之差的平方和最小的顶点，
+ *    即解 L p = b(s)，L 已由 ArapLaplacian 预分解，每帧只需组装 b 并做一次回代。
+ * 3. 能量与平移无关，解出后整体平移，使质心与仿射插值的质心一致，两种模式的运动路径相同。
+ * s = 0 和 s = 1 时能量为零，结果与源多边形和目标多边形重合。
+ * 构建后对象只读，可以在多个线程上同时 evaluate()。
+ */
+class ArapInterpolator {
+public:
+    /**
+     * @brief triangulation 必须是计划的源多边形（按计划的顶点顺序，t_f = 0 的那一帧）的剖分，
+     * laplacian 由同一个剖分构建。失败时（顶点数不符、剖分为空）返回 false，对象为空。
+     */
+    bool build(const MorphPlan& plan, const Triangulation& triangulation,
+               std::shared_ptr<const ArapLaplacian> laplacian);
+
+    bool empty() const { return m_n == 0; }
+    int vertexCount() const { return m_n; }
+
+    /**
+     * @brief 计算 t 时刻的插值顶点，与 MorphPlan::evaluate() 相同的布局（2 * n 个交错坐标）。
+     */
+    void evaluate(float t, double* outXY) const;
+
+    /**
+     * @brief 计算 t 时刻的插值多边形，写入 out（复用 out 的存储）。
+     */
+    void evaluate(float t, Polygon& out) const;
+
+    size_t memoryUsage() const;
+
+private:
+    /**
+     * @brief 一个三角形的源边向量 (v0 -> v1, v1 -> v2, v2 -> v0) 和源到目标映射的极分解。
+     */
+    struct Triangle {
+        int v[3];
+        double edges[3][2];
+        double phi;
+        double sxx, sxy, syy; // 对称的伸缩部分 S
+    };
+
+    std::vector<Triangle> m_triangles;
+    std::shared_ptr<const ArapLaplacian> m_laplacian;
+    MorphPlan m_plan; // 用于求仿射插值的质心
+    Eigen::Vector2d m_meanUv1 = Eigen::Vector2d::Zero();
+    Eigen::Vector2d m_meanUv2 = Eigen::Vector2d::Zero();
+    int m_n = 0;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 压缩帧流 (.sbz) 的编码参数。
+ */
+struct FrameCodecOptions {
+    double precision = 1e-4;   // 量化步长：解码误差不超过 precision / 2
+    int keyframeInterval = 30; // 每隔多少帧插入一个可以独立解码的关键帧
+};
+
+/**
+ * @brief 有损（量化）+ 无损（预测 + 熵编码）的帧流编码器。
+ * 1. 量化：坐标除以 precision 后取整。
+ * 2. 预测：关键帧在帧内沿轮廓预测（相邻顶点之差）；其余帧逐帧选择残差更小的一种
+ *    —— 与上一帧之差 (delta)，或沿每个顶点的轨迹线性外推 (2 * 上一帧 - 上上帧)。
+ *    渐变的相邻帧只有很小的位移，线性外推后残差通常只剩几个量化单位。
+ * 3. 熵编码：残差 zigzag 后按 32 个一组做自适应 Rice 编码（每组单独选择参数）。
+ * 流布局：文件头，逐帧记录 (字节数, t, 预测方式, 数据)，结束标记，关键帧索引和 12 字节的尾部。
+ * 编码只顺序写出，可以直接写入管道；解码既可以顺序流式进行，也可以借助索引随机访问。
+ */
+class FrameStreamEncoder {
+public:
+    /**
+     * @brief 写出文件头。os 在 finish() 之前必须保持有效。
+     */
+    bool open(std::ostream& os, int vertexCount, const FrameCodecOptions& options = FrameCodecOptions());
+
+    /**
+     * @brief 编码一帧。xy 为 2 * vertexCount 个交错的坐标（例如 MorphPlan::evaluate() 的输出）。
+     */
+    bool addFrame(float t, const double* xy);
+
+    /**
+     * @brief 写出结束标记和关键帧索引。
+     */
+    bool finish();
+
+    int frameCount() const { return m_frameCount; }
+    uint64_t bytesWritten() const { return m_bytesWritten; }
+
+private:
+    std::ostream* m_os = nullptr;
+    int m_vertexCount = 0;
+    FrameCodecOptions m_options;
+    int m_frameCount = 0;
+    uint64_t m_bytesWritten = 0;
+
+    std::vector<int64_t> m_prev;  // 上一帧的量化坐标
+    std::vector<int64_t> m_prev2; // 上上帧的量化坐标
+    std::vector<int64_t> m_quantized;
+    std::vector<int64_t> m_residuals;
+    std::vector<int64_t> m_candidate;
+    std::string m_payload;
+    std::vector<std::pair<uint32_t, uint64_t>> m_keyframes; // (帧号, 记录在流中的偏移)
+
+    void write(const void* data, size_t size);
+};
+
+/**
+ * @brief FrameStreamEncoder 的解码器。
+ * next() 顺序解码下一帧，只需要可读的流；seek() 跳到任意一帧（从之前最近的关键帧开始解码），
+ * 需要可定位的流（例如 std::ifstream）。
+ */
+class FrameStreamDecoder {
+public:
+    /**
+     * @brief 读取文件头；流可定位时同时读取关键帧索引（frameCount() 随之可用）。
+     */
+    bool open(std::istream& is);
+
+    int vertexCount() const { return m_vertexCount; }
+    double precision() const { return m_precision; }
+
+    /**
+     * @brief 总帧数；流不可定位时为 -1。
+     */
+    int frameCount() const { return m_frameCount; }
+
+    /**
+     * @brief 解码下一帧到 xy（2 * vertexCount 个 double）。流结束时返回 false。
+     */
+    bool next(float& t, double* xy);
+
+    /**
+     * @brief 使下一次 next() 返回第 frame 帧。
+     */
+    bool seek(int frame);
+
+    /**
+     * @brief 下一次 next() 将返回的帧号。
+     */
+    int position() const { return m_position; }
+
+    const std::string& error() const { return m_error; }
+
+private:
+    std::istream* m_is = nullptr;
+    int m_vertexCount = 0;
+    double m_precision = 0.0;
+    int m_keyframeInterval = 0;
+    int m_frameCount = -1;
+    int m_position = 0;
+    bool m_ended = false;
+    std::string m_error;
+
+    std::vector<int64_t> m_prev;
+    std::vector<int64_t> m_prev2;
+    std::vector<int64_t> m_quantized;
+    std::vector<int64_t> m_residuals;
+    std::string m_payload;
+    std::vector<std::pair<uint32_t, uint64_t>> m_keyframes;
+
+    bool fail(const std::string& message);
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "FrameCodec.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 导出的文本 / 二进制格式。
+ */
+enum class ExportFormat {
+    Csv,       // 表头 frame,t,vertex,x,y，每个顶点一行
+    Svg,       // 每帧一个 <path d="M ... Z"/>，viewBox 覆盖所有帧
+    Compressed // .sbz 压缩帧流（见 FrameStreamEncoder）
+};
+
+/**
+ * @brief 环形队列中的一帧：t 和 2 * vertexCount 个交错的坐标（预先分配，反复复用）。
+ */
+struct ExportFrame {
+    float t = 0.0f;
+    std::vector<double> xy;
+};
+
+/**
+ * @brief 导出过程中两端各自等待的时间，用来判断瓶颈在哪一端。
+ */
+struct ExportStats {
+    int frames = 0;
+    uint64_t bytes = 0;
+    double producerWaitSeconds = 0.0; // 队列满、生产者等待写线程（写出是瓶颈）
+    double writerWaitSeconds = 0.0;   // 队列空、写线程等待生产者（插值是瓶颈）
+};
+
+/**
+ * @brief 把"计算一帧"和"写出一帧"分到两个线程上的流水线导出器。
+ * 1. 调用线程（唯一的生产者）acquire() 一个预先分配的槽位，例如用 MorphPlan::evaluate(t, xy) 直接填入，
+ *    再 commit()。队列满时 acquire() 阻塞等待（背压），内存占用固定为 ringSlots 帧。
+ * 2. 专用的写线程（唯一的消费者）从 SpscRing 中按顺序取出帧，序列化到 path + ".tmp"。
+ * 3. finish() 标记流结束，等写线程排空队列、刷新文件后再改名到 path。
+ * 两个阶段重叠执行，总耗时取决于较慢的一端，而不是两者之和。
+ */
+class FrameExporter {
+public:
+    FrameExporter() = default;
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    /**
+     * @brief 创建临时文件、写出文件头并启动写线程。
+     * @param codec 只用于 ExportFormat::Compressed。
+     */
+    bool open(const std::string& path, ExportFormat format, int vertexCount, size_t ringSlots = 8,
+              const FrameCodecOptions& codec = FrameCodecOptions());
+
+    /**
+     * @brief 取得下一帧的槽位；队列满时阻塞。写线程已经失败时返回 nullptr。
+     */
+    ExportFrame* acquire();
+
+    /**
+     * @brief 把 acquire() 得到的槽位交给写线程。
+     */
+    void commit();
+
+    /**
+     * @brief 结束流：等待写线程写完所有已提交的帧，然后改名到目标路径。
+     * 未调用 finish() 就析构时丢弃临时文件。
+     */
+    bool finish();
+
+    const std::string& error() const { return m_error; }
+
+    /**
+     * @brief finish() 之后有效。
+     */
+    const ExportStats& stats() const { return m_stats; }
+
+    /**
+     * @brief 按扩展名推断格式 (.csv / .svg / .sbz)。
+     */
+    static bool formatFromPath(const std::string& path, ExportFormat& format);
+
+private:
+    ExportFormat m_format = ExportFormat::Csv;
+    int m_vertexCount = 0;
+    std::string m_path;
+    std::string m_tmpPath;
+    std::string m_error;
+    ExportStats m_stats;
+
+    std::unique_ptr<SpscRing<ExportFrame>> m_ring;
+    std::thread m_writer;
+    std::atomic<bool> m_closed{false};
+    std::atomic<bool> m_failed{false};
+    double m_writerWaitSeconds = 0.0; // 只由写线程修改，join 之后读取
+
+    // --- 以下只由写线程使用（open() 和 finish() 在线程启动前 / 结束后访问） ---
+    std::ofstream m_out;
+    FrameStreamEncoder m_encoder;
+    std::string m_text;
+    int m_written = 0;
+    double m_minX = 0.0, m_minY = 0.0, m_maxX = 0.0, m_maxY = 0.0;
+    std::streampos m_viewBoxPos = 0;
+
+    void writerLoop();
+    bool writeFrame(const ExportFrame& frame);
+    bool writeTrailer();
+    void stopWriter();
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief 定长步幅、可直接内存映射的动画帧文件 (.sbf)。
+ * 文件布局（小端）：
+ *   64 字节文件头（魔数 "SBF1"、版本、顶点数、帧数、帧步幅、各段偏移）
+ *   frameCount 个 float32 的 t 值
+ *   从 64 字节对齐的偏移开始，逐帧存放 float32 的 x0, y0, x1, y1, ...，
+ *   每帧占 frameStride 字节（2 * 4 * 顶点数向上取整到 64 的倍数），第 k 帧的位置可以直接算出。
+ * 下游工具（例如 numpy.memmap）不需要任何解析就能按帧读取。
+ */
+namespace FrameFileFormat {
+    constexpr size_t kAlignment = 64;
+
+    /**
+     * @brief 一帧占用的字节数。
+     */
+    size_t frameStride(int vertexCount);
+}
+
+/**
+ * @brief 直接在映射中生成帧文件：open() 预先分配整个文件，
+ * 调用者把每一帧写入 frame(k)（例如 MorphPlan::evaluate(t, float*)），finish() 后文件才出现在目标路径。
+ */
+class FrameFileWriter {
+public:
+    FrameFileWriter() = default;
+    ~FrameFileWriter();
+
+    FrameFileWriter(const FrameFileWriter&) = delete;
+    FrameFileWriter& operator=(const FrameFileWriter&) = delete;
+
+    /**
+     * @brief 在 path + ".tmp" 创建并映射文件，写好文件头。
+     */
+    bool open(const std::string& path, int vertexCount, int frameCount);
+
+    /**
+     * @brief 第 k 帧的 2 * vertexCount 个 float（64 字节对齐），按本机字节序写入。
+     */
+    float* frame(int k);
+    void setTime(int k, float t);
+
+    /**
+     * @brief 解除映射并改名到目标路径。未调用 finish() 就析构时删除临时文件。
+     */
+    bool finish();
+
+    const std::string& error() const { return m_error; }
+
+private:
+    std::shared_ptr<MappedFile> m_file;
+    std::string m_path;
+    std::string m_tmpPath;
+    std::string m_error;
+    int m_vertexCount = 0;
+    int m_frameCount = 0;
+    size_t m_stride = 0;
+    size_t m_timesOffset = 0;
+    size_t m_framesOffset = 0;
+};
+
+/**
+ * @brief 零拷贝读取帧文件：frame(k) 直接指向映射中的数据。
+ * 文件按小端存储，大端主机无法原地读取，open() 会失败。
+ */
+class FrameFile {
+public:
+    bool open(const std::string& path);
+
+    int vertexCount() const { return m_vertexCount; }
+    int frameCount() const { return m_frameCount; }
+    size_t frameStride() const { return m_stride; }
+
+    float time(int k) const;
+
+    /**
+     * @brief 第 k 帧的 x0, y0, x1, y1, ...；在 FrameFile（或 file() 的副本）存活期间有效。
+     */
+    const float* frame(int k) const;
+
+    const std::shared_ptr<const MappedFile>& file() const { return m_file; }
+
+private:
+    std::shared_ptr<const MappedFile> m_file;
+    int m_vertexCount = 0;
+    int m_frameCount = 0;
+    size_t m_stride = 0;
+    size_t m_timesOffset = 0;
+    size_t m_framesOffset = 0;
+};
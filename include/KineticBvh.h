@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MorphPlan.h"
+#include <vector>
+
+/**
+ * @brief KineticBvh 的构建参数。
+ */
+struct KineticBvhOptions {
+    int slabs = 16;   // t ∈ [0, 1] 均分成的时间片数，每片一套节点包围盒
+    int leafSize = 4; // 每个叶子最多包含的边数
+};
+
+/**
+ * @brief 射线与插值多边形最近的交点。
+ */
+struct RayHit {
+    int edge = -1;          // 边 i 为顶点 (i, i + 1)；没有交点时为 -1
+    double distance = 0.0;  // 沿单位化方向的距离
+    double x = 0.0;
+    double y = 0.0;
+    double edgeParam = 0.0; // 交点在边上的位置，0 为顶点 i，1 为顶点 i + 1
+};
+
+/**
+ * @brief 渐变多边形的运动包围体层次（kinetic BVH），在任意 t 上做点包含和射线查询，不必逐帧重建。
+ * 1. 拓扑只建一次：按 t = 0.5 时各边的中点递归中位数划分。
+ * 2. 包围盒按时间片存储：每个顶点在时间片 [t0, t1] 上的轨迹被包含在两端位置的包围盒向外扩展
+ *    min(speed * Δt / 2, accel * Δt² / 8) 之内，speed 和 accel 是 MorphPlan::speedBounds() 由闭式轨迹
+ *    给出的速度和加速度上界；边的包围盒是两个顶点的并，父节点的包围盒是子节点的并。
+ * 3. 查询 t 时只用 t 所在时间片的包围盒剪枝，只对到达的叶子用 MorphPlan::evaluateVertex() 求出这一时刻的边，
+ *    每次查询 O(log n)（加上真正与查询相交的边数）。
+ * 构建后对象只读，可以在多个线程上同时查询。
+ */
+class KineticBvh {
+public:
+    /**
+     * @brief 复制计划并建树。顶点少于 3 个时返回 false。
+     */
+    bool build(const MorphPlan& plan, const KineticBvhOptions& options = KineticBvhOptions());
+
+    bool empty() const { return m_nodes.empty(); }
+
+    /**
+     * @brief (x, y) 是否在 t 时刻的多边形内部（奇偶规则，与光栅化一致）。t 被限制在 [0, 1]。
+     */
+    bool contains(float t, double x, double y) const;
+
+    /**
+     * @brief 从 (originX, originY) 沿 (dirX, dirY) 发出的射线在 maxDistance 之内与 t 时刻多边形的第一个交点。
+     * 方向不必是单位向量；没有交点或方向为零时返回 false。t 被限制在 [0, 1]。
+     */
+    bool raycast(float t, double originX, double originY, double dirX, double dirY, double maxDistance,
+                 RayHit& hit) const;
+
+    const MorphPlan& plan() const { return m_plan; }
+    int nodeCount() const { return static_cast<int>(m_nodes.size()); }
+    int slabCount() const { return m_slabs; }
+    size_t memoryUsage() const;
+
+private:
+    struct Node {
+        int child = -1; // 内部节点：两个子节点为 child 和 child + 1
+        int first = 0;  // 叶子：m_edges[first, first + count)
+        int count = 0;
+    };
+
+    /**
+     * @brief 单精度包围盒，转换时向外取整，保证仍然包含双精度的轨迹。
+     */
+    struct Box {
+        float minX, minY, maxX, maxY;
+    };
+
+    MorphPlan m_plan;
+    int m_slabs = 0;
+    std::vector<Node> m_nodes;
+    std::vector<int> m_edges;
+    std::vector<Box> m_boxes; // m_boxes[slab * nodeCount() + node]，一次查询只访问一个时间片的连续区域
+
+    int buildNode(int node, int begin, int end, const std::vector<double>& centers, int leafSize);
+    const Box* slabBoxes(float t) const;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief 固定容量的最近最少使用 (LRU) 缓存。
+ * 链表按使用时间排列（表头最新），哈希表把键映射到链表节点，查找、插入和淘汰都是 O(1)。
+ * 本身不加锁，由使用者负责同步。
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    /**
+     * @brief 查找并把该项标记为最近使用；不存在时返回 nullptr。
+     * 返回的指针在下一次修改缓存之前有效。
+     */
+    Value* get(const Key& key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return nullptr;
+        m_items.splice(m_items.begin(), m_items, it->second);
+        return &it->second->second;
+    }
+
+    /**
+     * @brief 插入或覆盖一项；超出容量时淘汰最久未使用的项。
+     * @return 因此被淘汰的项数。
+     */
+    size_t put(const Key& key, Value value) {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            it->second->second = std::move(value);
+            m_items.splice(m_items.begin(), m_items, it->second);
+            return 0;
+        }
+        m_items.emplace_front(key, std::move(value));
+        m_index[key] = m_items.begin();
+        return trim();
+    }
+
+    bool erase(const Key& key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        m_items.erase(it->second);
+        m_index.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief 修改容量，必要时立即淘汰多出的项。
+     * @return 被淘汰的项数。
+     */
+    size_t setCapacity(size_t capacity) {
+        m_capacity = capacity > 0 ? capacity : 1;
+        return trim();
+    }
+
+    void clear() {
+        m_items.clear();
+        m_index.clear();
+    }
+
+    size_t size() const { return m_items.size(); }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    using Item = std::pair<Key, Value>;
+
+    size_t m_capacity;
+    std::list<Item> m_items;
+    std::unordered_map<Key, typename std::list<Item>::iterator, Hash> m_index;
+
+    size_t trim() {
+        size_t evicted = 0;
+        while (m_items.size() > m_capacity) {
+            m_index.erase(m_items.back().first);
+            m_items.pop_back();
+            ++evicted;
+        }
+        return evicted;
+    }
+};
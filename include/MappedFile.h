@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+/**
+ * @brief 映射到内存的整个文件。
+ * 在 POSIX 系统上使用 mmap，页面在第一次访问时才由操作系统读入；
+ * 其他平台退回到一次性读入堆缓冲区。open() 得到的数据在对象的整个生命周期内有效且不变，
+ * 通常用 shared_ptr 持有，让借用其中数组的对象（例如 Polygon::externalOwner）保持映射存活。
+ * create() 得到可写的映射，用于直接在文件中生成输出（例如 FrameFileWriter）。
+ */
+class MappedFile {
+public:
+    /**
+     * @brief 映射 path。失败时返回空指针，并把原因写入 error（可为空）。
+     */
+    static std::shared_ptr<const MappedFile> open(const std::string& path, std::string* error = nullptr);
+
+    /**
+     * @brief 创建（或截断）path，大小为 size 字节并全部置零，以读写方式映射。
+     * 写入的内容在 flush() 或析构时落盘。
+     */
+    static std::shared_ptr<MappedFile> create(const std::string& path, size_t size, std::string* error = nullptr);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief 可写的数据；只有 create() 得到的映射才非空。
+     */
+    char* writableData() { return m_writable ? const_cast<char*>(m_data) : nullptr; }
+
+    /**
+     * @brief 把可写映射的内容同步到文件。
+     */
+    bool flush(std::string* error = nullptr);
+
+private:
+    MappedFile() = default;
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;   // true: m_data 来自 mmap；false: 来自 new[]
+    bool m_writable = false;
+    std::string m_path;      // 没有 mmap 时 flush() 写回的文件
+};
+
+/**
+ * @brief 二进制文件格式（.sbp、.sba 等）统一使用小端字节序。
+ */
+inline bool hostIsLittleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+/**
+ * @brief 在小端和本机字节序之间转换（两个方向相同）。
+ */
+template <typename T>
+T littleEndian(T value) {
+    if (hostIsLittleEndian()) return value;
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    std::reverse(bytes, bytes + sizeof(T));
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
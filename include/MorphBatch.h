@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ShapeBlender.h"
+#include "FrameExporter.h"
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 清单中的一对多边形。
+ */
+struct BatchJob {
+    int line = 0;            // 在清单文件中的行号（从 1 开始），同时决定输出文件名
+    std::string pathA;
+    std::string pathB;
+    BlendWeights weights;
+    int manualK = -1;        // -1 = 自动搜索
+    int frameCount = 11;     // 均匀采样的帧数（含 t=0 和 t=1）
+    std::string output;      // 输出文件名；为空时使用 line_XXXXXX.sbf（或对应格式的扩展名）
+    std::string error;       // 该行解析失败时的原因，非空时不会被执行
+};
+
+/**
+ * @brief 批处理的输出格式。
+ */
+enum class BatchFormat {
+    Frames,     // 可内存映射的帧文件 (.sbf，见 FrameFile)，帧直接求值到映射中
+    Compressed, // 量化 + 预测 + 熵编码的帧流 (.sbz，见 FrameStreamEncoder)
+    Csv,        // frame,t,vertex,x,y 表格
+    Svg,        // 每帧一条路径
+    Json        // {"line", "pathA", "pathB", "bestK", "frames": [{"t", "vertices"}, ...]}
+};
+
+/**
+ * @brief 单个任务的执行结果。
+ */
+struct BatchResult {
+    int line = 0;
+    bool ok = false;
+    std::string outputPath;
+    std::string error;
+    int bestK = -1;
+    double latencyMs = 0.0;  // 加载 + 求解 + 写出
+};
+
+/**
+ * @brief 整批任务的吞吐和延迟统计（延迟只统计成功的任务）。
+ */
+struct BatchSummary {
+    int total = 0;
+    int succeeded = 0;
+    int failed = 0;
+    unsigned threads = 0;
+    double wallSeconds = 0.0;
+    double pairsPerSecond = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+};
+
+/**
+ * @brief 按清单批量渐变多对多边形。
+ * 1. loadManifest()：读取 JSON Lines 清单，每行一对多边形，例如
+ *    {"pathA": "a.json", "pathB": "b.json", "frames": 30, "k": 12,
+ *     "weights": {"w1": 0.6, "smooth_a_wS": 0.5}, "output": "ab.json"}
+ *    除 pathA/pathB 外都可省略，省略时使用传入的默认值；相对路径相对于清单所在目录。
+ * 2. run()：在固定大小的线程池上并发执行。每个工作线程独占一份工作区
+ *    （ShapeBlender、多边形和输出缓冲区），在它处理的所有任务之间复用。
+ *    每个任务完成后立即写出自己的文件（文件名只取决于行号，与完成顺序无关）。
+ */
+class MorphBatch {
+public:
+    using ResultCallback = std::function<void(const BatchResult&)>;
+
+    /**
+     * @brief 读取清单。空行和以 # 开头的行会被跳过；格式错误的行记录为失败的任务。
+     * @param defaults 提供未在行内指定的权重、k 和帧数。
+     * @return 清单文件能打开时返回 true。
+     */
+    bool loadManifest(const std::string& path, const BatchJob& defaults = BatchJob());
+
+    const std::vector<BatchJob>& jobs() const { return m_jobs; }
+
+    double m_searchBudget = 0.0; // 每对多边形自动搜索 k 的时间预算（秒），<= 0 表示不限时
+    std::string m_cacheDir;      // 非空时通过 MorphDiskCache 复用和保存求解结果
+    BatchFormat m_format = BatchFormat::Frames;
+    FrameCodecOptions m_codec;   // m_format 为 Compressed 时的量化精度和关键帧间隔
+
+    /**
+     * @brief 并发执行所有任务，阻塞直到全部完成。
+     * @param threadCount 工作线程数；0 表示使用硬件并发数。
+     * @param onResult 每完成一个任务调用一次（按完成顺序，同一时刻只有一个回调在执行）。
+     * 任务中抛出的异常记为该任务失败（异常信息写入 error），回调抛出的异常记录到 std::cerr，其余任务照常执行。
+     */
+    BatchSummary run(const std::string& outDir, unsigned threadCount = 0,
+                     const ResultCallback& onResult = nullptr) const;
+
+private:
+    struct Workspace;
+
+    std::vector<BatchJob> m_jobs;
+
+    bool process(const BatchJob& job, const std::string& outDir, Workspace& ws, BatchResult& result) const;
+    bool writeFrames(const BatchJob& job, const MorphSolution& solution, const std::filesystem::path& path,
+                     BatchResult& result) const;
+    bool writeExported(const BatchJob& job, const MorphSolution& solution, const std::filesystem::path& path,
+                       ExportFormat format, BatchResult& result) const;
+    bool writeJson(const BatchJob& job, const MorphSolution& solution, const std::filesystem::path& path,
+                   Workspace& ws, BatchResult& result) const;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "LruCache.h"
+#include "ShapeBlender.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief 多边形顶点坐标的内容哈希（64 位 FNV-1a），与顶点是自有的还是借用的无关。
+ */
+uint64_t hashPolygon(const Polygon& poly);
+
+/**
+ * @brief 一次求解的缓存键：由两个多边形的内容、全部权重和手动 k 共同决定。
+ * 同样的输入一定得到同样的键；不同输入碰撞的概率约为 2^-64。
+ */
+uint64_t morphKey(const Polygon& polyA, const Polygon& polyB, const BlendWeights& weights, int manual_k);
+
+/**
+ * @brief 线程安全的已求解渐变 (MorphSolution) 的 LRU 缓存。
+ * getOrSolve()：命中时直接返回共享的结果；未命中时在调用线程上求解并放入缓存。
+ * 多个线程同时请求同一个尚未缓存的键时只求解一次，其余线程等待同一个结果。
+ */
+class MorphCache {
+public:
+    using Entry = std::shared_ptr<const MorphSolution>;
+
+    enum class Lookup {
+        Hit,       // 缓存中已有
+        Coalesced, // 其他线程正在求解，等待了它的结果
+        Miss       // 由本次调用求解
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t coalesced = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t capacity = 0;
+    };
+
+    explicit MorphCache(size_t capacity = 64) : m_lru(capacity) {}
+
+    /**
+     * @brief 返回这对多边形在给定权重下的求解结果，必要时求解。
+     * @param lookup 可为空；非空时写入本次是命中、合并还是未命中。
+     * @return 求解失败（计划为空）时返回 nullptr，失败的结果不会被缓存。
+     */
+    Entry getOrSolve(const Polygon& polyA, const Polygon& polyB, const BlendWeights& weights,
+                     int manual_k = -1, Lookup* lookup = nullptr);
+
+    void setCapacity(size_t capacity);
+    void clear();
+    Stats stats() const;
+
+private:
+    struct InFlight {
+        bool done = false;
+        Entry result;
+    };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    LruCache<uint64_t, Entry> m_lru;
+    std::unordered_map<uint64_t, std::shared_ptr<InFlight>> m_inFlight;
+    Stats m_stats;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ShapeBlender.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+ * @brief 以内容寻址的磁盘缓存：保存对应关系、最佳 k、仿射基和每个 k 的代价。
+ * 键由两个多边形的顶点内容、全部权重和手动 k 决定（见 morphKey()），
+ * 每个键对应目录中的一个紧凑二进制文件 <key>.sbc。
+ * 读取时逐项校验（魔数、版本、键、两个多边形的哈希和顶点数、权重、k、负载校验和、索引范围），
+ * 任何一项不符都当作未命中。命中时直接恢复结果，跳过 O(m^2 n) 的搜索和选基。
+ */
+class MorphDiskCache {
+public:
+    explicit MorphDiskCache(std::string directory) : m_directory(std::move(directory)) {}
+
+    const std::string& directory() const { return m_directory; }
+
+    /**
+     * @brief blender 当前的多边形和权重在给定 k 下对应的缓存文件路径。
+     */
+    std::string pathFor(const ShapeBlender& blender, int manual_k) const;
+
+    /**
+     * @brief 命中时把结果恢复到 blender（包括插值计划）并返回 true。
+     */
+    bool load(ShapeBlender& blender, int manual_k) const;
+
+    /**
+     * @brief 保存 blender 当前的求解结果（先写临时文件再改名，可被多个进程并发调用）。
+     */
+    bool store(const ShapeBlender& blender, int manual_k) const;
+
+    /**
+     * @brief 先查缓存；未命中时完整求解（对应关系 + 仿射基），搜索完整时写入缓存。
+     * 被取消或受时间预算截断的搜索结果不会被缓存。
+     * @return 是否命中缓存。
+     */
+    bool solve(ShapeBlender& blender, int manual_k = -1, KSearchProgress* progress = nullptr) const;
+
+private:
+    std::string m_directory;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ShapeBlender.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一对多渐变：同一个源多边形渐变到多个目标。
+ * 1. loadSource()：源只加载并预计算一次内在属性（边长、角度、面积各自连续存放），
+ *    之后所有目标只读地共享这份数据，不再重复加载。
+ * 2. run()：在线程池中并发地为每个目标加载、求解对应关系和仿射基。
+ *    每完成一个目标就立即通过回调交付结果（按完成顺序，而非输入顺序）。
+ */
+class MorphFanOut {
+public:
+    /**
+     * @brief 单个目标的求解结果。
+     */
+    struct Result {
+        int index = -1;      // 目标在输入列表中的下标
+        std::string path;    // 目标文件路径（使用 Polygon 输入时为空）
+        bool ok = false;
+        Polygon target;      // 已加载的目标多边形
+        MorphSolution solution;
+    };
+
+    /**
+     * @brief 回调在工作线程中调用，但保证同一时刻只有一个回调在执行。
+     */
+    using ResultCallback = std::function<void(const Result&)>;
+
+    bool loadSource(const std::string& path);
+    void setSource(const Polygon& source);
+    const Polygon& getSource() const { return m_source; }
+
+    BlendWeights m_weights;
+    int m_manualK = -1; // -1 = 自动搜索最佳 k；手动 k 只用于顶点数不多于源的目标，其余目标求解失败
+
+    /**
+     * @brief 并发求解所有目标，阻塞直到全部完成。
+     * 加载或求解时抛出的异常会记录到 std::cerr，该目标以 ok = false 交给回调；回调自身抛出的异常同样只记录。
+     * @param threadCount 工作线程数；0 表示使用硬件并发数。
+     * @return 成功求解的目标数。
+     */
+    int run(const std::vector<std::string>& targetPaths, const ResultCallback& onResult, unsigned threadCount = 0) const;
+    int run(const std::vector<Polygon>& targets, const ResultCallback& onResult, unsigned threadCount = 0) const;
+
+private:
+    Polygon m_source;
+
+    int runTasks(int count, const std::function<bool(int, Result&)>& prepare,
+                 const ResultCallback& onResult, unsigned threadCount) const;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Polygon.h"
+#include <vector>
+#include <Eigen/Dense>
+
+/**
+ * @brief 一次渐变的"插值计划"：把 getInterpolatedPolygon() 中与 t 无关的部分预先算好。
+ * 包括仿射矩阵的分解 (theta, C, T) 以及每个 A 顶点在两个基下的局部坐标 (uv1, uv2)。
+ * 之后每一帧只需要 O(n) 的线性插值和一次 2x2 旋转，不再求解任何方程。
+ * 计划是自包含的（不引用任何多边形），可以在线程之间自由复制和共享。
+ */
+struct MorphPlan {
+    // --- 源多边形的基顶点 (A1, B1, C1) ---
+    Eigen::Vector2d basisA = Eigen::Vector2d::Zero();
+    Eigen::Vector2d basisB = Eigen::Vector2d::Zero();
+    Eigen::Vector2d basisC = Eigen::Vector2d::Zero();
+
+    // --- 仿射变换 A = B(theta) * C 的分解，以及平移 T ---
+    double theta = 0.0;
+    Eigen::Matrix2d C_mat = Eigen::Matrix2d::Identity();
+    Eigen::Vector2d T_vec = Eigen::Vector2d::Zero();
+
+    // --- 每个 A 顶点的局部坐标：uv1 相对源基，uv2 为其对应 B 顶点相对目标基 ---
+    std::vector<Eigen::Vector2d> uv1;
+    std::vector<Eigen::Vector2d> uv2;
+
+    int n = 0;             // 插值结果的顶点数 (= 源多边形的顶点数)
+    bool reversed = false; // 若为 true，则求解时交换了源和目标，evaluate() 使用 1 - t
+
+    bool empty() const { return n == 0; }
+
+    /**
+     * @brief 计算 t 时刻的插值顶点，直接写入调用者提供的内存。
+     * @param outXY 至少 2 * n 个 double，按 x0, y0, x1, y1, ... 交错存放。
+     */
+    void evaluate(float t, double* outXY) const;
+
+    /**
+     * @brief 同上，输出单精度（例如直接写入内存映射的帧文件，见 FrameFile）。
+     */
+    void evaluate(float t, float* outXY) const;
+
+    /**
+     * @brief 计算 t 时刻的插值多边形，写入 out（复用 out 的存储）。
+     */
+    void evaluate(float t, Polygon& out) const;
+
+    /**
+     * @brief 计算并返回 t 时刻的插值多边形。
+     */
+    Polygon evaluate(float t) const;
+
+    /**
+     * @brief t 时刻变换后的基。每个 t 用 frameAt() 算一次，之后 evaluateVertex() 只求需要的顶点，
+     * 例如空间查询只访问少数几条边时。
+     */
+    struct Frame {
+        double t_f = 0.0;
+        Eigen::Vector2d origin = Eigen::Vector2d::Zero();
+        Eigen::Vector2d ab = Eigen::Vector2d::Zero();
+        Eigen::Vector2d cb = Eigen::Vector2d::Zero();
+    };
+
+    Frame frameAt(float t) const;
+
+    /**
+     * @brief 第 i 个插值顶点，与 evaluate() 的第 i 个输出相同。
+     */
+    Eigen::Vector2d evaluateVertex(const Frame& frame, int i) const {
+        const Eigen::Vector2d uv = (1.0 - frame.t_f) * uv1[i] + frame.t_f * uv2[i];
+        return frame.origin + uv[0] * frame.ab + uv[1] * frame.cb;
+    }
+
+    /**
+     * @brief 各顶点在 t ∈ [t0, t1] 上的速度上界（Lipschitz 常数），由闭式轨迹求出：
+     * p_i(s) = A(s) (basisB + r_i(s)) + s T，A(s) = (1 - s) I + R(s theta) C，r_i(s) 对 s 线性。
+     * 对区间内任意 t、t' 有 |p_i(t) - p_i(t')| <= outSpeed[i] * |t - t'|；区间越短，上界越紧。
+     * @param outSpeed 至少 n 个 double。
+     * @param outAccel 非空时同时给出加速度上界 |p_i''|（至少 n 个 double）：轨迹偏离两端连线的距离
+     *                 不超过 outAccel[i] * (t1 - t0)^2 / 8，对平滑的运动比速度上界紧得多。
+     */
+    void speedBounds(float t0, float t1, double* outSpeed, double* outAccel = nullptr) const;
+
+    /**
+     * @brief 所有顶点在 [t0, t1] 上的速度上界的最大值。
+     */
+    double maxSpeedBound(float t0, float t1) const;
+
+private:
+    /**
+     * @brief t 时刻的插值参数 t_f（已考虑 reversed）以及变换后的基：原点 b_t 和两条基向量。
+     */
+    void frameBasis(float t, double& t_f, Eigen::Vector2d& origin, Eigen::Vector2d& ab, Eigen::Vector2d& cb) const;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ShapeBlender.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief 多关键帧时间轴 (A -> B -> C -> ...)。
+ * 1. load()/build()：每个关键帧只加载并预计算一次内在属性，
+ *    相邻两段共用同一个关键帧，不会重复加载。
+ * 2. 所有相邻关键帧对的对应关系和仿射基并行求解，结果存为每段的 MorphPlan。
+ * 3. evaluate()：通过预先建好的分桶查找表以 O(1) 定位全局时间所在的段，
+ *    再用该段的计划插值。
+ */
+class MorphTimeline {
+public:
+    MorphTimeline() = default;
+
+    /**
+     * @brief 并行加载关键帧文件，然后调用 build()。
+     * @param paths 按播放顺序排列的关键帧 JSON 路径（至少 2 个）。
+     * @param times 每个关键帧的全局时间，严格递增；为空则均匀分布在 [0, 1]。
+     */
+    bool load(const std::vector<std::string>& paths,
+              const BlendWeights& weights = BlendWeights(),
+              const std::vector<double>& times = {});
+
+    /**
+     * @brief 使用已加载的关键帧构建时间轴，并行求解每一段。
+     */
+    bool build(std::vector<Polygon> keyframes,
+               const BlendWeights& weights = BlendWeights(),
+               const std::vector<double>& times = {});
+
+    /**
+     * @brief 将全局时间映射到段索引和段内的局部时间 [0, 1]。超出范围时夹到两端。
+     * @return 段索引；时间轴为空时返回 -1。
+     */
+    int locate(double globalTime, double& localT) const;
+
+    /**
+     * @brief 计算全局时间处的插值多边形，写入 out（复用 out 的存储）。
+     */
+    void evaluate(double globalTime, Polygon& out) const;
+    Polygon evaluate(double globalTime) const;
+
+    int keyframeCount() const { return static_cast<int>(m_keyframes.size()); }
+    int segmentCount() const { return static_cast<int>(m_segments.size()); }
+    const Polygon& getKeyframe(int i) const { return m_keyframes[i]; }
+    const MorphPlan& getSegmentPlan(int i) const { return m_segments[i]; }
+    double startTime() const { return m_times.empty() ? 0.0 : m_times.front(); }
+    double endTime() const { return m_times.empty() ? 0.0 : m_times.back(); }
+
+private:
+    std::vector<Polygon> m_keyframes;
+    std::vector<double> m_times;       // 每个关键帧的全局时间
+    std::vector<MorphPlan> m_segments; // 第 i 段: 关键帧 i -> i+1
+
+    // 查找表：把 [startTime, endTime] 均分成若干桶，记录每个桶起点所在的段。
+    // 桶宽不超过最短的段，因此每个桶内至多有一个段边界，查找最多再挪动一步。
+    std::vector<int> m_bucketSegment;
+    double m_bucketScale = 0.0; // 桶数 / 时间跨度
+
+    void buildLookup();
+};
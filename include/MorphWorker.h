@@ -0,0 +1,138 @@
+#pragma once
+
+#include "ArapInterpolator.h"
+#include "ShapeBlender.h"
+#include "Triangulation.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief 渐变流水线的阶段。后面的阶段依赖前面阶段的结果。
+ */
+enum class MorphStage {
+    Load = 0,           // loadPolygons()
+    Correspondence = 1, // computeCorrespondence()
+    Basis = 2,          // findOptimalBasis()
+};
+
+/**
+ * @brief 一次已完成（或临时）的计算结果。发布后不可修改，可在任意线程上只读共享。
+ */
+struct MorphSnapshot {
+    Polygon polyA;
+    Polygon polyB;
+    std::map<int, int> correspondence;
+    AffineBasis basis;
+    int bestK = 0;
+    MorphPlan plan;
+    // 插值多边形的三角剖分（按 plan 的顶点顺序，即源多边形的剖分）；多边形不是简单多边形时为空
+    std::shared_ptr<const Triangulation> fill;
+    // 同一剖分上的 ARAP 插值（InterpolationMode::Arap）；没有剖分时为空
+    std::shared_ptr<const ArapInterpolator> arap;
+
+    bool valid = false;        // 是否已成功加载并求解
+    bool provisional = false;  // k 搜索仍在进行，这是当前最优 k 的临时结果
+    uint64_t generation = 0;   // 产生该快照的任务编号
+
+    size_t blenderBytes = 0;   // 产生该快照的 ShapeBlender 常驻表的内存
+    size_t scratchBytes = 0;   // 求解对应关系时的峰值临时内存
+};
+
+/**
+ * @brief 需要后台执行的任务：从 from 阶段开始重新计算其后的所有阶段。
+ */
+struct MorphJob {
+    MorphStage from = MorphStage::Load;
+    std::string pathA;
+    std::string pathB;
+    BlendWeights weights;
+    int manualK = -1;                // -1 = 自动搜索
+    double searchBudgetSeconds = 0.0; // 自动搜索的时间预算，0 = 不限时
+    std::string cacheDir;            // 非空时先查磁盘缓存 (MorphDiskCache)，完整求解后写回
+};
+
+/**
+ * @brief 在独立的工作线程上执行 加载 / 对应关系 / 仿射基 三个阶段。
+ * 1. submit()：提交新任务。尚未开始的旧任务被直接替换，正在运行的任务被取消。
+ * 2. 工作线程把结果做成不可变的 MorphSnapshot，通过 shared_ptr 原子替换发布；
+ *    自动搜索 k 时，每找到更好的 k 都会先发布一个临时快照。
+ * 3. snapshot()：渲染线程随时原子地取得最新快照，从不等待计算。
+ */
+class MorphWorker {
+public:
+    MorphWorker();
+    ~MorphWorker();
+
+    /**
+     * @brief 每次发布快照后在工作线程上调用（可为空），例如用来唤醒正在等待事件的界面线程。
+     * 应在提交第一个任务之前设置。
+     */
+    std::function<void()> onPublish;
+
+    MorphWorker(const MorphWorker&) = delete;
+    MorphWorker& operator=(const MorphWorker&) = delete;
+
+    void submit(const MorphJob& job);
+
+    /**
+     * @brief 取消当前任务并结束工作线程（可重复调用，析构时自动调用）。
+     * 之后不会再调用 onPublish。
+     */
+    void stop();
+
+    /**
+     * @brief 让正在进行的 k 搜索提前结束，并采用已找到的最优 k。
+     */
+    void stopSearch();
+
+    std::shared_ptr<const MorphSnapshot> snapshot() const;
+
+    bool busy() const { return m_busy; }
+
+    // 当前任务的 k 搜索进度（每个任务开始时重置）
+    const KSearchProgress& progress() const { return m_progress; }
+
+private:
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_hasPending = false;
+    bool m_stopping = false;
+    MorphJob m_pending;
+    std::atomic<uint64_t> m_generation{0};
+    std::atomic<bool> m_busy{false};
+
+    std::shared_ptr<const MorphSnapshot> m_snapshot;
+    KSearchProgress m_progress;
+
+    // --- 以下只在工作线程上访问 ---
+    ShapeBlender m_blender; // 跨任务保留，使只改权重的任务可以跳过加载
+    ShapeBlender m_preview; // 用于生成临时快照
+    int m_completedStage = -1; // m_blender 中已经有效的最后一个阶段
+    std::string m_loadedA;
+    std::string m_loadedB;
+    std::shared_ptr<const Triangulation> m_fill; // 当前源多边形的剖分，重新加载前跨任务复用
+    std::shared_ptr<const ArapLaplacian> m_arapLaplacian; // m_fill 的预分解，随 m_fill 一起失效
+
+    /**
+     * @brief 返回源多边形 A 的三角剖分；只在加载后第一次用到时计算。
+     */
+    std::shared_ptr<const Triangulation> fillFor(const ShapeBlender& blender);
+
+    /**
+     * @brief 在 fill 上为当前计划建立 ARAP 插值。Laplacian 只在剖分改变后分解一次，
+     * 之后每次发布（对应关系或仿射基改变）只重做 O(n) 的逐三角形极分解。
+     */
+    std::shared_ptr<const ArapInterpolator> arapFor(const ShapeBlender& blender,
+                                                    const std::shared_ptr<const Triangulation>& fill);
+
+    void workerLoop();
+    void process(const MorphJob& job, uint64_t generation);
+    void publish(const ShapeBlender& blender, bool valid, bool provisional, uint64_t generation);
+    bool isStale(uint64_t generation) const { return m_generation != generation; }
+};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
 #include <string>
 #include <Eigen/Dense>
 
@@ -12,9 +15,16 @@
  */
 struct Polygon {
     std::vector<Eigen::Vector2d> vertices;
+
+    // 借用的外部顶点数组（交错的 x0, y0, x1, y1, ...），不拥有其内存。
+    // 非空时顶点从这里读取、vertices 为空；调用者必须保证数组比 Polygon 活得久。
+    const double* externalXY = nullptr;
+    // 保证 externalXY 有效的所有者（例如内存映射的二进制文件）；为空时由调用者负责。
+    std::shared_ptr<const void> externalOwner;
+
     int n = 0; // 顶点数
     double totalArea = 0.0;//多边形面积
-    bool signFlag;
+    bool signFlag = true; // 绕序：有向面积 >= 0（逆时针）时为 true
 
     // --- "角三角形" (v_prev, v_curr, v_next) 的属性 ---
 
@@ -40,14 +50,60 @@ struct Polygon {
         return (i == n - 1) ? 0 : i + 1;
     }
 
+    /**
+     * @brief 第 i 个顶点（无论顶点是自有的还是借用的）。
+     * 借用的数组只保证 double 对齐，所以用非对齐的 Map 读取。
+     */
+    inline Eigen::Map<const Eigen::Vector2d> vertex(int i) const {
+        return Eigen::Map<const Eigen::Vector2d>(externalXY ? externalXY + 2 * i : vertices[i].data());
+    }
+
 
     /**
-     * @brief 从JSON文件加载顶点。
+     * @brief 从JSON文件加载顶点。以 "SBP1" 开头的文件按二进制格式加载（见 loadBinary()），
+     * "<归档>.sba#<名字>" 从多边形归档中加载（见 PolygonArchive）。
      * @param filepath 指向JSON文件的路径。
      * @return 成功加载返回 true。
      */
     bool loadFromFile(const std::string& filepath);
 
+    /**
+     * @brief 以内存映射方式加载二进制多边形文件 (.sbp)，顶点直接在映射中使用，不解析也不拷贝。
+     * 文件格式（小端）：64 字节文件头（魔数 "SBP1"、版本、标志、顶点数、包围盒，其余保留），
+     * 然后是交错的 x0, y0, x1, y1, ... 双精度数组；若设置了 kBinaryHasIntrinsics，
+     * 其后依次是 7 个长度为 n 的内在属性数组，加载时直接拷贝而不重新计算。
+     */
+    bool loadBinary(const std::string& filepath);
+
+    /**
+     * @brief 从内存中的二进制多边形映像加载（例如归档中的一个条目，见 PolygonArchive）。
+     * @param owner 保证 data 有效的所有者；非空且数据按 double 对齐时顶点原地使用，否则拷贝。
+     * @param source 出错时报告的名称。
+     */
+    bool loadBinaryImage(const char* data, size_t size, std::shared_ptr<const void> owner, const std::string& source);
+
+    /**
+     * @brief 写出二进制多边形文件。先写同目录下的临时文件再改名，正在映射旧文件的读者看到的内容不变。
+     * @param withIntrinsics 是否同时保存内在属性（文件约大 4.5 倍，加载时省去三角函数计算）。
+     */
+    bool saveBinary(const std::string& filepath, bool withIntrinsics = true) const;
+    bool writeBinary(std::ostream& os, bool withIntrinsics = true) const;
+
+    static constexpr uint32_t kBinaryHasIntrinsics = 1u;
+
+    /**
+     * @brief 直接借用调用者的交错 xy 数组（不拷贝），并计算内在属性。
+     * @param xy 2 * count 个 double，在 Polygon 的整个生命周期内必须保持有效且不变。
+     * @param count 顶点数。
+     * @return 顶点数不少于 3 时返回 true。
+     */
+    bool borrowVertices(const double* xy, size_t count);
+
+    /**
+     * @brief 反转顶点顺序并重新计算内在属性。借用的顶点会先拷贝为自有的。
+     */
+    void reverse();
+
     /**
      * @brief 计算并填充 edge_lengths 和 angles 向量。
      * 遍历所有顶点，计算连接前一个、当前和后一个顶点的
@@ -55,7 +111,17 @@ struct Polygon {
      */
     void precomputeIntrinsics();
 
+    /**
+     * @brief 顶点和所有内在属性数组占用的堆内存（字节，不含借用的顶点）。
+     */
+    size_t memoryUsage() const;
+
 private:
+    /**
+     * @brief 用鞋带公式计算 totalArea（面积的绝对值）和 signFlag（绕序）。
+     */
+    void computeAreaAndWinding();
+
     /**
      * @brief 计算并返回一个三角形(p1, p2, p3)的三个角（单位：度）。
      * @param p1 顶点1
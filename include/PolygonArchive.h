@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Polygon.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 把大量多边形打包成一个文件 (.sba)，按名字 O(1) 打开其中任意一个。
+ * 文件布局（小端）：
+ *   64 字节文件头（魔数 "SBA1"、版本、条目数、桶数、各段偏移）
+ *   目录：每个条目 48 字节（名字哈希、内容哈希、偏移、大小、名字位置、顶点数、桶链表的下一项）
+ *   哈希桶：2 的幂个 uint32，指向该桶链表的第一个条目
+ *   名字：所有名字首尾相接（不含 '\0'）
+ *   数据：每个多边形一个 .sbp 映像（见 Polygon::loadBinary()），按页 (4096) 对齐
+ * 打开归档只映射文件并检查文件头，不读取目录；查找只访问一个桶链表，
+ * 加载时顶点数组直接在映射中使用。
+ *
+ * 其他接受多边形路径的地方可以用 "<归档>.sba#<名字>" 引用归档中的条目。
+ */
+class PolygonArchive {
+public:
+    /**
+     * @brief 目录中的一个条目。
+     */
+    struct Entry {
+        std::string_view name;  // 指向映射，归档存活期间有效
+        uint64_t contentHash = 0; // hashPolygon() 的结果，可直接作为缓存键
+        uint32_t vertexCount = 0;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    static constexpr size_t kPageSize = 4096;
+
+    bool open(const std::string& path);
+
+    const std::string& path() const { return m_path; }
+    size_t size() const { return m_entryCount; }
+
+    /**
+     * @brief 第 index 个条目（按打包时的顺序）。
+     */
+    Entry entry(size_t index) const;
+
+    /**
+     * @brief 按名字查找，返回条目编号；不存在时返回 -1。
+     */
+    long find(std::string_view name) const;
+
+    /**
+     * @brief 加载一个条目。返回的多边形共享归档的映射，可以比 PolygonArchive 对象活得久。
+     */
+    bool load(size_t index, Polygon& out) const;
+    bool load(std::string_view name, Polygon& out) const;
+
+    /**
+     * @brief 并行加载 inputs（JSON 或 .sbp 文件），写出归档（先写临时文件再改名）。
+     * @param inputs (名字, 路径) 对；名字必须唯一。
+     * @param threadCount 工作线程数；0 表示使用硬件并发数。
+     */
+    static bool build(const std::vector<std::pair<std::string, std::string>>& inputs, const std::string& outPath,
+                      unsigned threadCount = 0, bool withIntrinsics = true);
+
+    /**
+     * @brief 把 "<归档>.sba#<名字>" 拆成两部分；不是这种形式时返回 false。
+     */
+    static bool splitPath(const std::string& path, std::string& archivePath, std::string& name);
+
+private:
+    std::string m_path;
+    std::shared_ptr<const MappedFile> m_file;
+    size_t m_entryCount = 0;
+    size_t m_bucketCount = 0;
+    const char* m_entries = nullptr;
+    const char* m_buckets = nullptr;
+    const char* m_names = nullptr;
+    size_t m_namesSize = 0;
+};
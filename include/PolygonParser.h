@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief parsePolygonJson() 的结果。
+ */
+enum class PolygonParseStatus {
+    Ok,          // 解析成功
+    Error,       // 输入不是合法的 JSON（error 中给出位置）
+    Unsupported  // 合法的 JSON 但不是严格的 [[x, y], ...] 格式，应交给通用 JSON 解析器
+};
+
+/**
+ * @brief 解析失败的位置（从 1 开始的行号和列号）和原因。
+ */
+struct PolygonParseError {
+    size_t offset = 0;
+    size_t line = 0;
+    size_t column = 0;
+    std::string message;
+};
+
+/**
+ * @brief 专用于 [[x, y], ...] 顶点数组的单遍解析器，不构建 JSON DOM。
+ * 先统计 '[' 的个数预留顶点存储，然后逐个读取数字（std::from_chars，结果与 strtod 一致）
+ * 直接写入 out。遇到对象、字符串、多于两个坐标等格式外的合法 JSON 时返回 Unsupported。
+ */
+PolygonParseStatus parsePolygonJson(const char* data, size_t size, std::vector<Eigen::Vector2d>& out,
+                                    PolygonParseError& error);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 全局的分阶段计时记录，不依赖任何 GUI，命令行和界面共用。
+ * 每个阶段保留最近 kHistorySize 次耗时（毫秒）的环形历史，以及累计统计。
+ * 所有方法都是线程安全的。
+ */
+class Profiler {
+public:
+    static constexpr int kHistorySize = 120;
+
+    /**
+     * @brief 某个阶段的统计数据（拷贝，可在锁外随意读取）。
+     */
+    struct Stage {
+        std::string name;
+        std::vector<float> history; // 按时间顺序排列，最后一个是最新的
+        double lastMs = 0.0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        long long count = 0;
+
+        double averageMs() const { return count > 0 ? totalMs / count : 0.0; }
+    };
+
+    static Profiler& instance();
+
+    void record(const std::string& stage, double ms);
+
+    /**
+     * @brief 返回某个阶段的统计；从未记录过时返回空的 Stage。
+     */
+    Stage stage(const std::string& name) const;
+
+    /**
+     * @brief 按名称排序返回所有阶段的统计。
+     */
+    std::vector<Stage> stages() const;
+
+    void reset();
+
+    /**
+     * @brief 以文本表格输出所有阶段的统计，用于命令行的计时摘要。
+     */
+    void report(std::ostream& os) const;
+
+private:
+    struct Series {
+        std::vector<float> ring;
+        int head = 0;
+        Stage stats;
+    };
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Series> m_series;
+
+    Stage toStage(const Series& series) const;
+};
+
+/**
+ * @brief RAII 计时器：析构时把经过的时间记录到 Profiler 的对应阶段。
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* stage)
+        : m_stage(stage), m_start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+        Profiler::instance().record(m_stage, ms);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* m_stage;
+    std::chrono::steady_clock::time_point m_start;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "MorphPlan.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief 图像每边的最大像素数。16384 x 16384 的 RGBA 图像已占 1 GiB，帧级并行时每个线程各有一张。
+ */
+constexpr int kMaxRasterSize = 16384;
+
+/**
+ * @brief 8 位 RGBA 图像，按行紧密排列。
+ */
+struct RasterImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        rgba.resize(4 * static_cast<size_t>(w) * static_cast<size_t>(h));
+    }
+
+    /**
+     * @brief 写出二进制 PPM (P6)：丢弃 alpha（颜色已经与背景合成）。
+     */
+    bool writePpm(const std::string& path) const;
+
+    /**
+     * @brief 写出 RGBA PNG。压缩流只使用 deflate 的不压缩 (stored) 块：
+     * 不依赖 zlib，写出速度只受磁盘限制，代价是文件与原始像素一样大。
+     */
+    bool writePng(const std::string& path) const;
+};
+
+/**
+ * @brief 光栅化参数。
+ */
+struct RasterOptions {
+    int width = 512;
+    int height = 512;
+    int samples = 4;      // 每行像素的子扫描线数（纵向抗锯齿）；横向按跨度端点的精确覆盖率
+    int tileHeight = 32;  // 按块并行时每块的行数
+    std::array<uint8_t, 4> fill = {255, 255, 255, 255};
+    std::array<uint8_t, 4> background = {0, 0, 0, 255};
+};
+
+/**
+ * @brief 多边形坐标到像素坐标的映射：pixel = scale * xy + offset（y 轴与界面一样向下）。
+ */
+struct RasterTransform {
+    double scale = 1.0;
+    double offsetX = 0.0;
+    double offsetY = 0.0;
+
+    /**
+     * @brief 把包围盒等比缩放、居中放进 width x height，四周留出 margin 比例的边距。
+     */
+    static RasterTransform fit(double minX, double minY, double maxX, double maxY, int width, int height,
+                               double margin = 0.05);
+};
+
+/**
+ * @brief 扫描线光栅化：奇偶规则填充，边缘抗锯齿。
+ * 每条子扫描线求出与各边的交点，排序后两两配对成跨度；跨度两端按所占像素的比例累加覆盖率，
+ * 中间的整像素用差分数组一次性累加。图像按 tileHeight 行分块，各块互不依赖，可以并行渲染。
+ */
+class Rasterizer {
+public:
+    /**
+     * @brief 渲染一帧。xy 为 2 * n 个交错的坐标（例如 MorphPlan::evaluate() 的输出）。
+     * @param pool 非空时各块在线程池上并行渲染（块级并行），否则在调用线程上逐块渲染。
+     */
+    void render(const double* xy, int n, const RasterTransform& transform, const RasterOptions& options,
+                RasterImage& out, ThreadPool* pool = nullptr);
+
+private:
+    struct Edge {
+        double x0, y0; // y0 < y1，像素坐标
+        double y1;
+        double dxdy;
+    };
+
+    std::vector<Edge> m_edges; // 按 y0 升序
+
+    void renderTile(int rowBegin, int rowEnd, const RasterOptions& options, RasterImage& out) const;
+};
+
+/**
+ * @brief 渲染图像序列的并行方式。
+ */
+enum class RasterParallelism {
+    Frames, // 每个工作线程独立渲染并写出整帧（适合大量小图）
+    Tiles   // 逐帧渲染，每帧的各块分给所有线程（适合少量大图，帧按顺序完成）
+};
+
+/**
+ * @brief 图像格式。
+ */
+enum class RasterFormat {
+    Png,
+    Ppm
+};
+
+struct RasterSequenceStats {
+    int frames = 0;
+    double wallSeconds = 0.0;
+    double framesPerSecond = 0.0;
+};
+
+/**
+ * @brief 按给定的 t 把渐变渲染成 outDir/frame_XXXX.png（或 .ppm）。
+ * 先求出所有帧的总包围盒，使整个序列使用同一个视图。
+ * 尺寸超过 kMaxRasterSize、写出失败或渲染中抛出异常（例如内存不足）时记录到 std::cerr 并返回 false。
+ * @param threadCount 线程数；0 表示使用硬件并发数。
+ */
+bool renderMorphSequence(const MorphPlan& plan, const std::vector<float>& times, const RasterOptions& options,
+                         RasterFormat format, const std::string& outDir, RasterParallelism parallelism,
+                         unsigned threadCount = 0, RasterSequenceStats* stats = nullptr);
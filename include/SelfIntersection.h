@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MorphPlan.h"
+#include <set>
+#include <vector>
+
+/**
+ * @brief 多边形自交检测（Shamos–Hoey 扫描线）。
+ * 1. 所有顶点按 (x, y) 排序作为事件；竖直扫描线从左向右经过，状态结构保存与扫描线相交的边，
+ *    按扫描线上的 y 排序。边在左端点插入、右端点删除，只检查在状态结构中新变成相邻的两条边。
+ * 2. 只回答“有没有自交”而不枚举所有交点：找到第一对相交的边就停止，所以是 O(n log n)，
+ *    不依赖交点数 k。
+ * 3. 不相邻的边只要有公共点（包括端点接触、共线重叠）就算自交；相邻的边只有折返（共线重叠）才算。
+ *    重合的相邻顶点（长度为零的边）先合并掉，不算自交：源顶点多于目标顶点时，
+ *    多个源顶点对应同一个目标顶点，t = 1 的帧里本来就有这样的重复点。
+ * 检查器保存排序和状态结构的缓冲区，逐帧检查时应复用同一个对象。
+ */
+class SelfIntersectionChecker {
+public:
+    /**
+     * @brief xy 为 2 * n 个交错的坐标。没有自交时返回 true；否则 edgeA()/edgeB() 给出一对相交的边。
+     * 含 NaN/Inf 的多边形视为不简单（边号为 -1）。
+     */
+    bool isSimple(const double* xy, int n);
+    bool isSimple(const Polygon& poly);
+
+    // 最近一次 isSimple() 返回 false 时找到的两条边，边 i 为顶点 (i, i + 1)
+    int edgeA() const { return m_edgeA; }
+    int edgeB() const { return m_edgeB; }
+
+private:
+    /**
+     * @brief 按当前扫描线上的 y 比较两条边。
+     */
+    struct EdgeLess {
+        const SelfIntersectionChecker* checker;
+        bool operator()(int a, int b) const;
+    };
+
+    struct Edge {
+        double x, y;    // 左端点（按 (x, y) 字典序较小的一端）
+        double slope;   // 竖直边为 +inf
+        int leftVertex;
+    };
+    struct Event {
+        double x, y;
+        int vertex;
+    };
+
+    const double* m_xy = nullptr;
+    int m_n = 0;
+    std::vector<Edge> m_edges;
+    std::vector<Event> m_events; // 按 (x, y) 排序的顶点
+    std::multiset<int, EdgeLess> m_status{EdgeLess{this}};
+    std::vector<std::multiset<int, EdgeLess>::iterator> m_handles;
+    std::vector<double> m_ownedXY;    // isSimple(const Polygon&) 的坐标缓冲区
+    std::vector<double> m_compactXY;  // 合并重合的相邻顶点之后的坐标
+    std::vector<int> m_originalEdge;  // 合并后的边号 -> 原来的边号
+    int m_edgeA = -1;
+    int m_edgeB = -1;
+
+    bool sweep(const double* xy, int n);
+    bool intersects(int a, int b) const;
+    bool report(int a, int b);
+};
+
+/**
+ * @brief 在 t 区间上自适应地寻找第一个自交的帧。
+ */
+struct IntersectionScanOptions {
+    float tBegin = 0.0f;
+    float tEnd = 1.0f;
+    int initialSamples = 16;   // 先把区间均匀分成这么多段
+    double maxStep = 0.01;     // 相邻两次检查之间任一顶点的最大位移（相对于起始帧包围盒的对角线），超过就二分
+    float tolerance = 1e-4f;   // t 的最小步长，也是定位第一个自交 t 的精度
+};
+
+struct IntersectionScanResult {
+    bool found = false;
+    float firstBadT = 0.0f;  // 找到的最早的自交帧（精确到 tolerance）
+    float lastGoodT = 0.0f;  // firstBadT 之前最后一个检查通过的帧
+    int edgeA = -1;          // firstBadT 处相交的一对边
+    int edgeB = -1;
+    int checks = 0;          // 自交检查的次数
+    int evaluations = 0;     // 插值的次数
+};
+
+/**
+ * @brief 从 tBegin 向 tEnd 依次推进：下一个采样点上的顶点相对于上一个通过的帧移动超过 maxStep 时，
+ * 先把步长减半（只插值、不检查），位移足够小时才做一次 O(n log n) 的检查。
+ * 检查失败时在上一个通过的帧与它之间二分，定位第一个自交的 t。
+ * 形状变化慢的区间只做很少的检查，快速旋转的区间自动加密。
+ * @return 是否找到自交（同 result.found）。
+ */
+bool scanSelfIntersections(const MorphPlan& plan, const IntersectionScanOptions& options, IntersectionScanResult& result);
@@ -1,15 +1,23 @@
 #pragma once
 
 #include "Polygon.h"
+#include "MorphPlan.h"
 #include <map>
 #include <array>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+class MorphDiskCache;
 
 /**
  * @brief 存储用于仿射插值的最佳基（三对顶点）。
  */
 struct AffineBasis {
-    std::array<int, 3> polyA_indices;
-    std::array<int, 3> polyB_indices;
+    std::array<int, 3> polyA_indices = {0, 0, 0};
+    std::array<int, 3> polyB_indices = {0, 0, 0};
 };
 
 /**
@@ -26,6 +34,54 @@ struct SmoothPair {
     }
 };
 
+/**
+ * @brief sim_t 和 smooth_a 的全部权重。
+ * 用于在多个 ShapeBlender 之间传递同一组设置（例如时间轴的每一段）。
+ */
+struct BlendWeights {
+    float w1 = 0.5f;
+    float w2 = 0.5f;
+    float smooth_a_wS = 0.333f;
+    float smooth_a_wR = 0.333f;
+    float smooth_a_wA = 0.334f;
+};
+
+/**
+ * @brief 自动搜索最佳起点 k 的控制参数和实时进度。
+ * 搜索是"随时可停"的：搜索线程每跑完一个 k 就更新进度，
+ * 其他线程可以在任意时刻读取当前最优 k、它的代价以及代价下界，
+ * 并通过 cancel 或 timeBudgetSeconds 让搜索提前结束（结果为已找到的最优 k）。
+ */
+struct KSearchProgress {
+    double timeBudgetSeconds = 0.0; // <= 0 表示不限时
+
+    // 每当找到更好的 k 时，在搜索线程上调用（可为空）
+    std::function<void(int k, double cost)> onImproved;
+
+    std::atomic<bool> cancel{false};
+    std::atomic<bool> finished{false};
+    std::atomic<int> bestK{-1};
+    std::atomic<double> bestCost{std::numeric_limits<double>::infinity()};
+    std::atomic<double> lowerBound{0.0}; // 任何 k 的总代价都不会低于该值
+    std::atomic<int> tested{0};
+    std::atomic<int> total{0};
+    std::atomic<bool> truncated{false}; // 因取消或时间预算提前结束（结果不一定是全局最优）
+
+    /**
+     * @brief 开始新一轮搜索前清空进度（保留 timeBudgetSeconds 和 onImproved）。
+     */
+    void reset() {
+        cancel = false;
+        finished = false;
+        bestK = -1;
+        bestCost = std::numeric_limits<double>::infinity();
+        lowerBound = 0.0;
+        tested = 0;
+        total = 0;
+        truncated = false;
+    }
+};
+
 /**
  * @brief 封装模糊形状渐变算法的核心逻辑。
  * 协调整个渐变过程。
@@ -53,6 +109,28 @@ class ShapeBlender {
         */
         bool loadPolygons(const std::string& pathA, const std::string& pathB);
 
+        /**
+        * @brief 直接使用已加载（并已预计算内在属性）的多边形，不再读取文件。
+        * 与 loadPolygons() 一样会在绕序不一致时反转 B。
+        */
+        void setPolygons(const Polygon& polyA, const Polygon& polyB);
+
+        BlendWeights getWeights() const;
+        void setWeights(const BlendWeights& weights);
+
+        /**
+        * @brief 设置求解过程的输出流：info 接收进度信息，error 接收错误信息，默认为 std::cout 和 std::cerr。
+        * 传 nullptr 关闭对应的输出；嵌入到其他程序（如 C 接口）时用它避免向宿主的标准输出写东西。
+        */
+        void setLogStreams(std::ostream* info, std::ostream* error);
+
+        /**
+        * @brief 进度信息和错误信息的输出流；对应的流被关闭时返回一个丢弃所有输出的流。
+        * solveMorph() 等辅助函数也通过它们输出，与求解器使用同一个去处。
+        */
+        std::ostream& info() const;
+        std::ostream& error() const;
+
 
         /**
         * @brief 计算顶点对应关系。
@@ -60,8 +138,11 @@ class ShapeBlender {
         * G[i][j] = sim_t(A[i], B[j])。
         * 然后在代价图 (1 - G) 上运行n_A次动态规划，找到最短路径。
         * 这条路径就是顶点对应关系。
+        * 自动模式下按启发式估计从好到差依次尝试 k，若提供 progress，
+        * 则实时发布进度，并可被取消或在时间预算耗尽时提前结束。
+        * manual_k 必须为 -1（自动）或在 [0, A 的顶点数) 内，否则报错并清空对应关系和计划。
         */
-        void computeCorrespondence(int manual_k = -1);
+        void computeCorrespondence(int manual_k = -1, KSearchProgress* progress = nullptr);
 
 
         /**
@@ -71,6 +152,14 @@ class ShapeBlender {
         */
         void findOptimalBasis();
 
+        /**
+        * @brief 直接采用之前保存的求解结果（对应关系、最佳 k、仿射基、每个 k 的代价），
+        * 跳过搜索和选基，并重建插值计划。
+        * @return 结果与当前多边形不匹配（索引越界、长度不对）时返回 false，状态不变。
+        */
+        bool restoreSolution(const std::map<int, int>& correspondence, int bestK,
+                             const AffineBasis& basis, const std::vector<double>& kCosts);
+
 
         /**
         * @brief 计算并返回给定t值的插值多边形。
@@ -81,6 +170,7 @@ class ShapeBlender {
         * 4. 计算 X2 相对于 (A2, B2, C2) 的局部坐标 (u2, v2)
         * 5. 插值局部坐标 (u(t), v(t))
         * 6. 将 (u(t), v(t)) 转换回世界坐标，使用 (A(t), B(t), C(t))。
+        * 其中与 t 无关的部分（仿射分解、局部坐标）已预先存入 m_plan。
         */
         Polygon getInterpolatedPolygon(float t) const;
 
@@ -89,6 +179,21 @@ class ShapeBlender {
         const Polygon& getPolyA() const { return m_polyA; }
         const Polygon& getPolyB() const { return m_polyB; }
         int getBestK() const{return m_bestK;}
+        const MorphPlan& getPlan() const { return m_plan; }
+        const std::map<int, int>& getCorrespondence() const { return m_correspondence; }
+        const AffineBasis& getBasis() const { return m_basis; }
+        // 每个 k 的 DP 总代价；未尝试的 k 为 +inf
+        const std::vector<double>& getKCosts() const { return m_kCosts; }
+
+        /**
+        * @brief 常驻的表（两个多边形、对应关系、每个 k 的代价、插值计划）占用的堆内存（字节）。
+        */
+        size_t memoryUsage() const;
+
+        /**
+        * @brief 上一次 computeCorrespondence() 中代价图和 DP 表的峰值临时内存（字节）。
+        */
+        size_t scratchMemoryUsage() const { return m_scratchBytes; }
 
     private:
     Polygon m_polyA; // 源
@@ -97,6 +202,21 @@ class ShapeBlender {
     std::map<int, int> m_correspondence;
     AffineBasis m_basis;
     int m_bestK = 0;
+    std::vector<double> m_kCosts;
+    size_t m_scratchBytes = 0;
+    MorphPlan m_plan; // 由 m_correspondence 和 m_basis 派生，二者任一改变后重建
+    std::ostream* m_info = &std::cout;  // 为空时不输出
+    std::ostream* m_error = &std::cerr; // 为空时不输出
+
+    /**
+     * @brief 若 A 和 B 的绕序不一致，反转 B 并重新计算其内在属性。
+     */
+    void alignWinding();
+
+    /**
+     * @brief 根据当前的 m_correspondence 和 m_basis 重建 m_plan。
+     */
+    void rebuildPlan();
 
 
     /**
@@ -118,13 +238,33 @@ class ShapeBlender {
                                    const Eigen::Vector2d& a, 
                                    const Eigen::Vector2d& b, 
                                    const Eigen::Vector2d& c) const;
+};
 
-    /**
-     * @brief 将局部坐标 (u, v) 转换回世界坐标。
-     * X = B + u(A-B) + v(C-B)。
-     */
-    Eigen::Vector2d getWorldCoords(const Eigen::Vector2d& uv, 
-                                   const Eigen::Vector2d& a, 
-                                   const Eigen::Vector2d& b, 
-                                   const Eigen::Vector2d& c) const;
-};
\ No newline at end of file
+/**
+ * @brief 一对多边形的完整求解结果。
+ */
+struct MorphSolution {
+    MorphPlan plan;
+    std::map<int, int> correspondence;
+    AffineBasis basis;
+    int bestK = 0;
+    bool swapped = false; // 求解时是否交换了源和目标（此时 correspondence 为 dst -> src）
+};
+
+/**
+ * @brief 为一对已加载的多边形求解对应关系与仿射基。
+ * 算法要求源的顶点数不少于目标；若 src 更少，则交换两者求解，
+ * 并将计划标记为反向，使 plan.evaluate(0) 仍然对应 src。
+ * manual_k 是 src 的顶点编号（src[k] 对应 dst[0]）。交换求解时 DP 的起点只能固定 dst 的顶点，
+ * 这个约束无法表达，因此 src 顶点更少时手动 k (>= 0) 会被拒绝：报错并返回空的计划。
+ */
+MorphSolution solveMorph(const Polygon& src, const Polygon& dst, const BlendWeights& weights, int manual_k = -1);
+
+/**
+ * @brief 同上，但在调用者提供的 ShapeBlender 上求解，便于每个工作线程复用同一个实例。
+ * progress 可为空；非空时自动搜索可被取消或受时间预算限制。
+ * cache 非空时先查磁盘缓存，未命中再求解并写回（见 MorphDiskCache）。
+ */
+MorphSolution solveMorph(ShapeBlender& blender, const Polygon& src, const Polygon& dst,
+                         const BlendWeights& weights, int manual_k = -1, KSearchProgress* progress = nullptr,
+                         const MorphDiskCache* cache = nullptr);
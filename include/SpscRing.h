@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 单生产者 / 单消费者的无锁环形队列，槽位在构造时一次性分配并反复使用。
+ * 生产者：acquire() 取得队尾的空槽，原地填好后 publish()；
+ * 消费者：front() 取得队首的槽，处理完后 pop() 归还。
+ * 队满或队空时对应的调用返回 nullptr，等待策略（自旋、让出、休眠）由使用者决定。
+ * 读写索引单调递增，各占一条缓存行；每一端另外缓存对端的索引，只在看似满 / 空时才重新读取。
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @param capacity 槽位数，向上取整到 2 的幂。
+     * @param prototype 每个槽位的初始值，例如预先分配好大小的缓冲区。
+     */
+    explicit SpscRing(size_t capacity, const T& prototype = T()) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_slots.assign(size, prototype);
+        m_mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return m_slots.size(); }
+
+    // --- 生产者 ---
+
+    T* acquire() {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_slots.size()) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_slots.size()) return nullptr;
+        }
+        return &m_slots[tail & m_mask];
+    }
+
+    void publish() {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // --- 消费者 ---
+
+    T* front() {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return nullptr;
+        }
+        return &m_slots[head & m_mask];
+    }
+
+    void pop() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+
+    alignas(64) std::atomic<size_t> m_head{0}; // 消费者写
+    size_t m_cachedTail = 0;                    // 消费者私有
+    alignas(64) std::atomic<size_t> m_tail{0}; // 生产者写
+    size_t m_cachedHead = 0;                    // 生产者私有
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 固定线程数的简单线程池。
+ * submit() 把任务放入队列并返回 std::future；析构时等待队列中的任务全部完成。
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threadCount 工作线程数；0 表示使用硬件并发数。
+     */
+    explicit ThreadPool(unsigned threadCount = 0) {
+        if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+
+        m_workers.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+     * @brief 当前线程在池中的编号 [0, size())；不在池内时返回 -1。
+     * 可用于索引每个工作线程独占的工作区。
+     */
+    static int currentWorkerIndex() { return workerIndexSlot(); }
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        m_cv.notify_one();
+        return future;
+    }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+
+    static int& workerIndexSlot() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    void workerLoop(unsigned index) {
+        workerIndexSlot() = static_cast<int>(index);
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping && m_tasks.empty()) return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Polygon.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 简单多边形的三角剖分，用于填充绘制。
+ * 1. build()：扫描线把多边形分解成 y 单调的子多边形（start/split/end/merge/regular 五类顶点，
+ *    状态结构为按扫描线上 x 排序的 std::multiset），再用栈逐个剖分单调多边形，总共 O(n log n)。
+ * 2. 插值多边形与源多边形 A 的顶点顺序相同，因此 A 的索引缓冲可以原样用于每一帧：
+ *    只要每个三角形都保持原来的朝向（没有翻折），它们就仍然铺满插值多边形。
+ *    firstInvertedTriangle() 以 O(n) 检查这一点，失效的帧应退回到只画轮廓。
+ */
+class Triangulation {
+public:
+    /**
+     * @brief 剖分 xy（2 * n 个交错坐标）描述的简单多边形，顺时针或逆时针均可。
+     * 多边形自交或退化（三角形数不是 n - 2，或面积之和与多边形面积不符）时返回 false。
+     */
+    bool build(const double* xy, int n);
+    bool build(const Polygon& poly);
+
+    bool empty() const { return m_indices.empty(); }
+    int vertexCount() const { return m_n; }
+    int triangleCount() const { return static_cast<int>(m_indices.size() / 3); }
+
+    /**
+     * @brief 每 3 个为一个三角形的顶点编号，在 build() 的坐标系中全部为逆时针。
+     */
+    const std::vector<uint32_t>& indices() const { return m_indices; }
+
+    /**
+     * @brief 按同样的顶点顺序给出一帧，返回第一个翻转（有向面积为负）的三角形；全部有效时返回 -1。
+     */
+    int firstInvertedTriangle(const double* xy) const;
+
+    bool validFor(const double* xy) const { return firstInvertedTriangle(xy) < 0; }
+
+    size_t memoryUsage() const { return m_indices.capacity() * sizeof(uint32_t); }
+
+private:
+    std::vector<uint32_t> m_indices;
+    int m_n = 0;
+};
@@ -0,0 +1,155 @@
+#ifndef SHAPEBLENDER_C_H
+#define SHAPEBLENDER_C_H
+
+/**
+ * @brief 算法核心的稳定 C 接口。
+ * 只使用不透明句柄和 C 基本类型，不跨越边界传递任何 C++ 对象或异常，
+ * 可以从 C 插件或其他语言的 FFI 直接调用。
+ *
+ * 顶点统一使用交错的 double 数组 (x0, y0, x1, y1, ...)，count 为顶点数：
+ * - 输入的顶点数组被借用而不是拷贝，调用者要保证它在 blender 使用期间有效；
+ * - 插值帧直接写入调用者提供的内存。
+ *
+ * 所有函数返回 sb_status，失败时可用 sb_last_error() 取得当前线程上一次错误的描述；
+ * 库不向标准输出或标准错误写任何内容。
+ */
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(SHAPEBLENDER_SHARED)
+#  if defined(SHAPEBLENDER_BUILDING)
+#    define SB_API __declspec(dllexport)
+#  else
+#    define SB_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define SB_API __attribute__((visibility("default")))
+#else
+#  define SB_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 只有在不兼容地修改本头文件时才递增 */
+#define SB_API_VERSION 1
+
+typedef struct sb_blender sb_blender;
+typedef struct sb_plan sb_plan;
+typedef struct sb_bvh sb_bvh;
+
+typedef enum sb_status {
+    SB_OK = 0,
+    SB_ERR_INVALID_ARGUMENT = 1,  /* 空指针、非有限坐标、t 不是有限值等 */
+    SB_ERR_TOO_FEW_VERTICES = 2,  /* 多边形少于 3 个顶点 */
+    SB_ERR_NOT_READY = 3,         /* 尚未设置多边形或尚未求解 */
+    SB_ERR_DEGENERATE = 4,        /* 找不到非退化的仿射基 */
+    SB_ERR_BUFFER_TOO_SMALL = 5,  /* 输出缓冲区放不下一帧 */
+    SB_ERR_OUT_OF_MEMORY = 6,
+    SB_ERR_INTERNAL = 7
+} sb_status;
+
+/* 与 C++ 的 BlendWeights 一一对应 */
+typedef struct sb_weights {
+    double w1;
+    double w2;
+    double smooth_a_wS;
+    double smooth_a_wR;
+    double smooth_a_wA;
+} sb_weights;
+
+SB_API int sb_api_version(void);
+
+/* 当前线程上一次失败的描述；没有失败时为空字符串。指针在下一次调用前有效。 */
+SB_API const char* sb_last_error(void);
+
+SB_API const char* sb_status_string(sb_status status);
+
+SB_API void sb_default_weights(sb_weights* out);
+
+/* ---------------- blender：持有一对多边形和求解结果 ---------------- */
+
+SB_API sb_status sb_blender_create(sb_blender** out);
+SB_API void sb_blender_destroy(sb_blender* blender);
+
+SB_API sb_status sb_blender_set_weights(sb_blender* blender, const sb_weights* weights);
+
+/**
+ * 设置源多边形 A 和目标多边形 B（借用，不拷贝）。
+ * 数组必须保持有效且不被修改，直到下一次 sb_blender_set_polygons 或 blender 被销毁。
+ * A 的顶点数少于 B 时会在内部交换求解，插值方向不变。
+ */
+SB_API sb_status sb_blender_set_polygons(sb_blender* blender,
+                                         const double* xyA, size_t countA,
+                                         const double* xyB, size_t countB);
+
+/**
+ * 求解顶点对应关系和仿射基。
+ * manual_k < 0 时自动搜索起点 k；budget_seconds > 0 时自动搜索最多运行这么久并采用已找到的最优 k。
+ * k 是顶点较多的多边形的顶点编号，表示它的第 k 个顶点对应另一个多边形的 0 号顶点：
+ * 通常是 A[k] 对应 B[0]；A 的顶点数少于 B（交换求解）时是 B[k] 对应 A[0]，必须小于 B 的顶点数。
+ */
+SB_API sb_status sb_blender_solve(sb_blender* blender, int manual_k, double budget_seconds);
+
+/* 上一次求解采用的起点 k（含义同 sb_blender_solve 的 manual_k）；尚未求解时为 -1 */
+SB_API int sb_blender_best_k(const sb_blender* blender);
+
+/**
+ * 取出上一次求解的插值计划。计划是自包含的：不引用输入的顶点数组，
+ * 生命周期独立于 blender，可以在多个线程上同时调用 sb_plan_evaluate。
+ */
+SB_API sb_status sb_blender_get_plan(const sb_blender* blender, sb_plan** out);
+
+/* ---------------- plan：每帧 O(n) 的插值 ---------------- */
+
+SB_API void sb_plan_destroy(sb_plan* plan);
+
+/* 每一帧的顶点数：A、B 中较多的那个顶点数（A 的顶点数少于 B 时为 B 的顶点数） */
+SB_API size_t sb_plan_vertex_count(const sb_plan* plan);
+
+/**
+ * 计算 t 时刻的插值多边形，写入 out_xy（capacity 个顶点，即 2 * capacity 个 double）。
+ */
+SB_API sb_status sb_plan_evaluate(const sb_plan* plan, double t, double* out_xy, size_t capacity);
+
+/**
+ * 依次计算 count 个 t，第 f 帧写入 out_xy + 2 * vertex_count * f。
+ * capacity 为整个缓冲区能容纳的顶点数。
+ */
+SB_API sb_status sb_plan_evaluate_many(const sb_plan* plan, const double* ts, size_t count,
+                                       double* out_xy, size_t capacity);
+
+/* ---------------- bvh：任意 t 上的点包含和射线查询 ---------------- */
+
+/* 射线与插值多边形最近的交点；边 i 为顶点 (i, i + 1) */
+typedef struct sb_ray_hit {
+    int edge;           /* 没有交点时为 -1 */
+    double distance;    /* 沿单位化方向的距离 */
+    double x, y;
+    double edge_param;  /* 交点在边上的位置，0 为顶点 i，1 为顶点 i + 1 */
+} sb_ray_hit;
+
+/**
+ * 为计划建立运动包围体层次：按 t 分成 slabs 个时间片（<= 0 时用默认值 16），
+ * 之后任意 t 上的查询都是 O(log n)，不必逐帧重建。bvh 复制了计划，生命周期独立于 plan，
+ * 可以在多个线程上同时查询。
+ */
+SB_API sb_status sb_bvh_create(const sb_plan* plan, int slabs, sb_bvh** out);
+SB_API void sb_bvh_destroy(sb_bvh* bvh);
+
+/* (x, y) 是否在 t 时刻的多边形内部（奇偶规则）；结果写入 out_inside（0 或 1） */
+SB_API sb_status sb_bvh_contains(const sb_bvh* bvh, double t, double x, double y, int* out_inside);
+
+/**
+ * 从 (origin_x, origin_y) 沿 (dir_x, dir_y) 的射线在 max_distance 之内的第一个交点。
+ * 没有交点时仍返回 SB_OK，out_hit->edge 为 -1。
+ */
+SB_API sb_status sb_bvh_raycast(const sb_bvh* bvh, double t, double origin_x, double origin_y,
+                                double dir_x, double dir_y, double max_distance, sb_ray_hit* out_hit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHAPEBLENDER_C_H */
@@ -0,0 +1,99 @@
+#include "AdaptiveSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool adaptiveSampleTimes(const MorphPlan& plan, const AdaptiveSamplingOptions& options, std::vector<float>& times){
+    times.clear();
+    if (plan.empty() || !(options.tolerance > 0.0) || !(options.tEnd >= options.tBegin) ||
+        !std::isfinite(options.tBegin) || !std::isfinite(options.tEnd)) {
+        return false;
+    }
+
+    times.push_back(options.tBegin);
+    if (options.tEnd == options.tBegin) return true;
+
+    // 区间 [t0, t1] 内任一顶点离 t0 的最远距离的上界，逐顶点取两个上界中较紧的一个：
+    // speed * dt，或者精确的弦长 |p(t1) - p(t0)| 加上轨迹偏离弦的距离 accel * dt^2 / 8
+    const int n = plan.n;
+    std::vector<double> from(2 * static_cast<size_t>(n));
+    std::vector<double> to(2 * static_cast<size_t>(n));
+    std::vector<double> speed(n);
+    std::vector<double> accel(n);
+    float fromT = options.tBegin;
+    plan.evaluate(fromT, from.data());
+    auto fits = [&](float t0, float t1) {
+        if (t0 != fromT) {
+            fromT = t0;
+            plan.evaluate(fromT, from.data());
+        }
+        const double dt = static_cast<double>(t1) - t0;
+        plan.evaluate(t1, to.data());
+        plan.speedBounds(t0, t1, speed.data(), accel.data());
+        for (int i = 0; i < n; ++i) {
+            const double chord = std::hypot(to[2 * i] - from[2 * i], to[2 * i + 1] - from[2 * i + 1]);
+            if (std::min(speed[i] * dt, chord + accel[i] * dt * dt * 0.125) > options.tolerance) return false;
+        }
+        return true;
+    };
+    auto next = [](float t) { return std::nextafter(t, std::numeric_limits<float>::infinity()); };
+
+    float t0 = options.tBegin;
+    double step = (static_cast<double>(options.tEnd) - options.tBegin) / 16.0;
+    while (t0 < options.tEnd) {
+        const double remaining = static_cast<double>(options.tEnd) - t0;
+        auto endOf = [&](double length) {
+            return length >= remaining ? options.tEnd : std::max(next(t0), static_cast<float>(t0 + length));
+        };
+
+        // lo 可行、hi 不可行（hi = 0 表示还没找到不可行的步长）
+        double lo = 0.0;
+        double hi = 0.0;
+        double length = std::min(step, remaining);
+        if (fits(t0, endOf(length))) {
+            lo = length;
+            while (lo < remaining) {
+                length = std::min(2.0 * lo, remaining);
+                if (!fits(t0, endOf(length))) {
+                    hi = length;
+                    break;
+                }
+                lo = length;
+            }
+        } else {
+            hi = length;
+            while (lo == 0.0 && endOf(hi * 0.5) > next(t0)) {
+                if (fits(t0, endOf(hi * 0.5))) {
+                    lo = hi * 0.5;
+                } else {
+                    hi *= 0.5;
+                }
+            }
+        }
+        if (hi > 0.0 && lo > 0.0) {
+            while (hi - lo > 0.01 * hi) {
+                const double mid = 0.5 * (lo + hi);
+                if (fits(t0, endOf(mid))) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+        }
+
+        // 连一个 float 间隔的步长都不满足：容差相对运动速度过小
+        if (lo == 0.0) {
+            times.clear();
+            return false;
+        }
+        const float t1 = endOf(lo);
+        times.push_back(t1);
+        if (static_cast<int>(times.size()) > options.maxFrames) {
+            times.clear();
+            return false;
+        }
+        step = lo;
+        t0 = t1;
+    }
+    return true;
+}
@@ -0,0 +1,176 @@
+#include "ArapInterpolator.h"
+#include "Profiler.h"
+#include <cmath>
+
+bool ArapLaplacian::build(const Triangulation& triangulation){
+    m_n = 0;
+    m_factorBytes = 0;
+    const int n = triangulation.vertexCount();
+    if (triangulation.empty() || n < 3) return false;
+
+    ScopedTimer timer("arap_factor");
+    // 每个三角形的每条边贡献 |p_j - p_i - d|^2；去掉固定在原点的 0 号顶点后，下标整体减一
+    const std::vector<uint32_t>& indices = triangulation.indices();
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(indices.size() * 4);
+    for (size_t k = 0; k < indices.size(); k += 3) {
+        for (int e = 0; e < 3; ++e) {
+            const int i = static_cast<int>(indices[k + e]) - 1;
+            const int j = static_cast<int>(indices[k + (e + 1) % 3]) - 1;
+            if (i >= 0) triplets.emplace_back(i, i, 1.0);
+            if (j >= 0) triplets.emplace_back(j, j, 1.0);
+            if (i >= 0 && j >= 0) {
+                triplets.emplace_back(i, j, -1.0);
+                triplets.emplace_back(j, i, -1.0);
+            }
+        }
+    }
+    Eigen::SparseMatrix<double> laplacian(n - 1, n - 1);
+    laplacian.setFromTriplets(triplets.begin(), triplets.end());
+
+    m_ldlt.compute(laplacian);
+    if (m_ldlt.info() != Eigen::Success) return false;
+
+    m_n = n;
+    const auto& factor = m_ldlt.matrixL().nestedExpression();
+    m_factorBytes = static_cast<size_t>(factor.nonZeros()) * (sizeof(double) + sizeof(int)) +
+                    static_cast<size_t>(n) * (3 * sizeof(int) + sizeof(double));
+    return true;
+}
+
+void ArapLaplacian::solve(Eigen::MatrixX2d& rhs) const{
+    rhs = m_ldlt.solve(rhs);
+}
+
+size_t ArapLaplacian::memoryUsage() const{
+    return m_factorBytes;
+}
+
+bool ArapInterpolator::build(const MorphPlan& plan, const Triangulation& triangulation,
+                             std::shared_ptr<const ArapLaplacian> laplacian){
+    m_triangles.clear();
+    m_laplacian.reset();
+    m_n = 0;
+    const int n = plan.n;
+    if (n < 3 || triangulation.vertexCount() != n || !laplacian || laplacian->vertexCount() != n) return false;
+
+    // 源 (t_f = 0) 和目标 (t_f = 1) 的顶点，按计划的顶点顺序
+    const MorphPlan::Frame source = plan.frameAt(plan.reversed ? 1.0f : 0.0f);
+    const MorphPlan::Frame target = plan.frameAt(plan.reversed ? 0.0f : 1.0f);
+    std::vector<Eigen::Vector2d> a(n), b(n);
+    for (int i = 0; i < n; ++i) {
+        a[i] = plan.evaluateVertex(source, i);
+        b[i] = plan.evaluateVertex(target, i);
+    }
+
+    // 源三角形退化（面积为零）时退回到计划整体的线性部分 R(theta) C
+    const double cosTheta = std::cos(plan.theta);
+    const double sinTheta = std::sin(plan.theta);
+    Eigen::Matrix2d rotation;
+    rotation << cosTheta, -sinTheta, sinTheta, cosTheta;
+    const Eigen::Matrix2d global = rotation * plan.C_mat;
+
+    const std::vector<uint32_t>& indices = triangulation.indices();
+    m_triangles.resize(indices.size() / 3);
+    for (size_t k = 0; k < m_triangles.size(); ++k) {
+        Triangle& tri = m_triangles[k];
+        for (int e = 0; e < 3; ++e) tri.v[e] = static_cast<int>(indices[3 * k + e]);
+        for (int e = 0; e < 3; ++e) {
+            const Eigen::Vector2d edge = a[tri.v[(e + 1) % 3]] - a[tri.v[e]];
+            tri.edges[e][0] = edge.x();
+            tri.edges[e][1] = edge.y();
+        }
+
+        Eigen::Matrix2d from, to;
+        from << a[tri.v[1]] - a[tri.v[0]], a[tri.v[2]] - a[tri.v[0]];
+        to << b[tri.v[1]] - b[tri.v[0]], b[tri.v[2]] - b[tri.v[0]];
+        const double det = from.determinant();
+        const double scale = from.squaredNorm();
+        const Eigen::Matrix2d map = std::abs(det) > 1e-12 * scale ? Eigen::Matrix2d(to * from.inverse()) : global;
+
+        // 2x2 极分解：R(phi0) 是最接近 map 的旋转，R^T map 对称
+        const double phi0 = std::atan2(map(1, 0) - map(0, 1), map(0, 0) + map(1, 1));
+        const double c = std::cos(phi0);
+        const double s = std::sin(phi0);
+        const Eigen::Matrix2d stretch = (Eigen::Matrix2d() << c, s, -s, c).finished() * map;
+        tri.phi = plan.theta + std::remainder(phi0 - plan.theta, 2.0 * M_PI);
+        tri.sxx = stretch(0, 0);
+        tri.sxy = 0.5 * (stretch(0, 1) + stretch(1, 0));
+        tri.syy = stretch(1, 1);
+    }
+
+    m_meanUv1.setZero();
+    m_meanUv2.setZero();
+    for (int i = 0; i < n; ++i) {
+        m_meanUv1 += plan.uv1[i];
+        m_meanUv2 += plan.uv2[i];
+    }
+    m_meanUv1 /= n;
+    m_meanUv2 /= n;
+    m_plan = plan;
+    m_laplacian = std::move(laplacian);
+    m_n = n;
+    return true;
+}
+
+void ArapInterpolator::evaluate(float t, double* outXY) const{
+    if (m_n == 0) return;
+
+    const MorphPlan::Frame frame = m_plan.frameAt(t);
+    const double s = frame.t_f;
+
+    // 组装 b(s)：每条边的目标向量 M_k(s) (a_j - a_i)
+    Eigen::MatrixX2d rhs = Eigen::MatrixX2d::Zero(m_n - 1, 2);
+    for (const Triangle& tri : m_triangles) {
+        const double c = std::cos(s * tri.phi);
+        const double sn = std::sin(s * tri.phi);
+        const double k00 = 1.0 - s + s * tri.sxx;
+        const double k01 = s * tri.sxy;
+        const double k11 = 1.0 - s + s * tri.syy;
+        const double m00 = c * k00 - sn * k01;
+        const double m01 = c * k01 - sn * k11;
+        const double m10 = sn * k00 + c * k01;
+        const double m11 = sn * k01 + c * k11;
+        for (int e = 0; e < 3; ++e) {
+            const double dx = m00 * tri.edges[e][0] + m01 * tri.edges[e][1];
+            const double dy = m10 * tri.edges[e][0] + m11 * tri.edges[e][1];
+            const int i = tri.v[e] - 1;
+            const int j = tri.v[(e + 1) % 3] - 1;
+            if (j >= 0) {
+                rhs(j, 0) += dx;
+                rhs(j, 1) += dy;
+            }
+            if (i >= 0) {
+                rhs(i, 0) -= dx;
+                rhs(i, 1) -= dy;
+            }
+        }
+    }
+    m_laplacian->solve(rhs);
+
+    // 0 号顶点在原点；整体平移到仿射插值的质心
+    Eigen::Vector2d sum = Eigen::Vector2d::Zero();
+    for (int i = 0; i < m_n - 1; ++i) sum += rhs.row(i).transpose();
+    const Eigen::Vector2d meanUv = (1.0 - s) * m_meanUv1 + s * m_meanUv2;
+    const Eigen::Vector2d shift = frame.origin + meanUv.x() * frame.ab + meanUv.y() * frame.cb - sum / m_n;
+
+    outXY[0] = shift.x();
+    outXY[1] = shift.y();
+    for (int i = 1; i < m_n; ++i) {
+        outXY[2 * i] = rhs(i - 1, 0) + shift.x();
+        outXY[2 * i + 1] = rhs(i - 1, 1) + shift.y();
+    }
+}
+
+void ArapInterpolator::evaluate(float t, Polygon& out) const{
+    out.externalXY = nullptr;
+    out.externalOwner.reset();
+    out.vertices.resize(m_n);
+    out.n = m_n;
+    if (m_n > 0) evaluate(t, out.vertices.front().data());
+}
+
+size_t ArapInterpolator::memoryUsage() const{
+    return m_triangles.capacity() * sizeof(Triangle) +
+           (m_plan.uv1.capacity() + m_plan.uv2.capacity()) * sizeof(Eigen::Vector2d);
+}
@@ -0,0 +1,488 @@
+#include "FrameCodec.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace {
+
+constexpr char kStreamMagic[4] = {'S', 'B', 'Z', '1'};
+constexpr char kIndexMagic[4] = {'S', 'B', 'Z', 'I'};
+constexpr uint32_t kStreamVersion = 1;
+constexpr size_t kHeaderSize = 4 + 4 + 4 + 4 + 8;
+constexpr size_t kTrailerSize = 8 + 4;
+constexpr size_t kRecordHeaderSize = 4 + 4 + 1;
+
+enum Predictor : uint8_t {
+    kSpatial = 0, // 关键帧：与同一帧中的前一个顶点之差
+    kDelta = 1,   // 与上一帧之差
+    kLinear = 2   // 沿轨迹线性外推：2 * 上一帧 - 上上帧
+};
+
+constexpr int kBlockSize = 32;   // 每组残差共用一个 Rice 参数
+constexpr int kEscapeQuotient = 20; // 商达到该值时改为直接写出数值的位数和各位
+
+inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline int bitLength(uint64_t v) {
+    int bits = 0;
+    while (v) {
+        ++bits;
+        v >>= 1;
+    }
+    return bits;
+}
+
+/**
+ * @brief 低位在前的位写入器。
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::string& out) : m_out(out) {}
+
+    void put(uint64_t bits, int count) {
+        while (count > 32) {
+            put(bits & 0xFFFFFFFFu, 32);
+            bits >>= 32;
+            count -= 32;
+        }
+        m_acc |= (bits & ((uint64_t(1) << count) - 1)) << m_count;
+        m_count += count;
+        while (m_count >= 8) {
+            m_out.push_back(static_cast<char>(m_acc & 0xFF));
+            m_acc >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    void flush() {
+        if (m_count > 0) m_out.push_back(static_cast<char>(m_acc & 0xFF));
+        m_acc = 0;
+        m_count = 0;
+    }
+
+private:
+    std::string& m_out;
+    uint64_t m_acc = 0;
+    int m_count = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const char* data, size_t size)
+        : m_p(reinterpret_cast<const unsigned char*>(data)), m_end(m_p + size) {}
+
+    bool get(int count, uint64_t& value) {
+        value = 0;
+        int shift = 0;
+        while (count > 32) {
+            uint64_t low;
+            if (!get(32, low)) return false;
+            value |= low << shift;
+            shift += 32;
+            count -= 32;
+        }
+        while (m_count < count) {
+            if (m_p == m_end) return false;
+            m_acc |= static_cast<uint64_t>(*m_p++) << m_count;
+            m_count += 8;
+        }
+        value |= (m_acc & ((uint64_t(1) << count) - 1)) << shift;
+        m_acc >>= count;
+        m_count -= count;
+        return true;
+    }
+
+    /**
+     * @brief 读取连续的 1，最多 limit 个；遇到 0 时消耗它。
+     */
+    bool unary(int limit, int& ones) {
+        ones = 0;
+        while (ones < limit) {
+            uint64_t bit;
+            if (!get(1, bit)) return false;
+            if (bit == 0) return true;
+            ++ones;
+        }
+        return true;
+    }
+
+private:
+    const unsigned char* m_p;
+    const unsigned char* m_end;
+    uint64_t m_acc = 0;
+    int m_count = 0;
+};
+
+uint64_t riceCost(const uint64_t* values, int count, int k) {
+    uint64_t bits = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint64_t q = values[i] >> k;
+        bits += q < kEscapeQuotient ? q + 1 + k : kEscapeQuotient + 6 + bitLength(values[i]);
+    }
+    return bits;
+}
+
+/**
+ * @brief 残差的自适应 Rice 编码：每 kBlockSize 个一组，先写 5 位参数 k，
+ * 再为每个值写 (v >> k) 个 1、一个 0 和低 k 位；商过大时写 kEscapeQuotient 个 1、6 位的位数和数值本身。
+ */
+void encodeResiduals(const std::vector<int64_t>& residuals, std::string& out) {
+    BitWriter writer(out);
+    uint64_t block[kBlockSize];
+    for (size_t start = 0; start < residuals.size(); start += kBlockSize) {
+        const int count = static_cast<int>(std::min<size_t>(kBlockSize, residuals.size() - start));
+        uint64_t sum = 0;
+        for (int i = 0; i < count; ++i) {
+            block[i] = zigzag(residuals[start + i]);
+            sum += std::min<uint64_t>(block[i], uint64_t(1) << 40);
+        }
+
+        // 均值的位数附近就是最优参数，只比较相邻的三个
+        const int guess = std::max(0, bitLength(sum / count) - 1);
+        int best = guess;
+        uint64_t bestCost = riceCost(block, count, guess);
+        for (int k : {guess - 1, guess + 1}) {
+            if (k < 0 || k > 31) continue;
+            const uint64_t cost = riceCost(block, count, k);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = k;
+            }
+        }
+
+        writer.put(static_cast<uint64_t>(best), 5);
+        for (int i = 0; i < count; ++i) {
+            const uint64_t v = block[i];
+            const uint64_t q = v >> best;
+            if (q < kEscapeQuotient) {
+                writer.put((uint64_t(1) << q) - 1, static_cast<int>(q));
+                writer.put(0, 1);
+                writer.put(v, best);
+            } else {
+                writer.put((uint64_t(1) << kEscapeQuotient) - 1, kEscapeQuotient);
+                const int bits = std::max(1, bitLength(v));
+                writer.put(static_cast<uint64_t>(bits - 1), 6);
+                writer.put(v, bits);
+            }
+        }
+    }
+    writer.flush();
+}
+
+/**
+ * @brief values 个残差编码后的最大字节数：每值最多 kEscapeQuotient + 6 + 64 位，每组另有 5 位参数。
+ */
+uint64_t maxPayloadSize(size_t values) {
+    const uint64_t bits = static_cast<uint64_t>(values) * (kEscapeQuotient + 6 + 64) + (values + kBlockSize - 1) / kBlockSize * 5;
+    return (bits + 7) / 8;
+}
+
+bool decodeResiduals(const std::string& payload, std::vector<int64_t>& residuals) {
+    BitReader reader(payload.data(), payload.size());
+    for (size_t start = 0; start < residuals.size(); start += kBlockSize) {
+        const size_t count = std::min<size_t>(kBlockSize, residuals.size() - start);
+        uint64_t k;
+        if (!reader.get(5, k)) return false;
+        for (size_t i = 0; i < count; ++i) {
+            int q;
+            if (!reader.unary(kEscapeQuotient, q)) return false;
+            uint64_t v;
+            if (q < kEscapeQuotient) {
+                uint64_t low;
+                if (!reader.get(static_cast<int>(k), low)) return false;
+                v = (static_cast<uint64_t>(q) << k) | low;
+            } else {
+                uint64_t bits;
+                if (!reader.get(6, bits) || !reader.get(static_cast<int>(bits) + 1, v)) return false;
+            }
+            residuals[start + i] = unzigzag(v);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 按预测方式求残差（编码）或由残差还原（解码）。坐标按 x0..x(n-1), y0..y(n-1) 分通道排列。
+ */
+void predict(Predictor predictor, const std::vector<int64_t>& prev, const std::vector<int64_t>& prev2,
+             size_t index, size_t channelStart, const std::vector<int64_t>& current, int64_t& prediction) {
+    switch (predictor) {
+        case kSpatial: prediction = index == channelStart ? 0 : current[index - 1]; break;
+        case kDelta: prediction = prev[index]; break;
+        case kLinear: prediction = 2 * prev[index] - prev2[index]; break;
+    }
+}
+
+template <typename T>
+void putValue(std::string& out, T value) {
+    value = littleEndian(value);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T getValue(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return littleEndian(value);
+}
+
+} // namespace
+
+void FrameStreamEncoder::write(const void* data, size_t size){
+    m_os->write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    m_bytesWritten += size;
+}
+
+bool FrameStreamEncoder::open(std::ostream& os, int vertexCount, const FrameCodecOptions& options){
+    if (vertexCount <= 0 || !(options.precision > 0.0) || options.keyframeInterval <= 0) return false;
+
+    m_os = &os;
+    m_vertexCount = vertexCount;
+    m_options = options;
+    m_frameCount = 0;
+    m_bytesWritten = 0;
+    m_keyframes.clear();
+    const size_t values = 2 * static_cast<size_t>(vertexCount);
+    m_prev.assign(values, 0);
+    m_prev2.assign(values, 0);
+    m_quantized.resize(values);
+    m_residuals.resize(values);
+    m_candidate.resize(values);
+
+    std::string header(kStreamMagic, sizeof(kStreamMagic));
+    putValue(header, kStreamVersion);
+    putValue(header, static_cast<uint32_t>(vertexCount));
+    putValue(header, static_cast<uint32_t>(options.keyframeInterval));
+    putValue(header, options.precision);
+    write(header.data(), header.size());
+    return static_cast<bool>(*m_os);
+}
+
+bool FrameStreamEncoder::addFrame(float t, const double* xy){
+    if (!m_os) return false;
+    const size_t n = static_cast<size_t>(m_vertexCount);
+    const double scale = 1.0 / m_options.precision;
+    for (size_t i = 0; i < n; ++i) {
+        const double x = xy[2 * i] * scale;
+        const double y = xy[2 * i + 1] * scale;
+        if (!std::isfinite(x) || !std::isfinite(y) || std::abs(x) > 4e18 || std::abs(y) > 4e18) return false;
+        m_quantized[i] = std::llround(x);
+        m_quantized[n + i] = std::llround(y);
+    }
+
+    const int inGroup = m_frameCount % m_options.keyframeInterval;
+    Predictor predictor = kSpatial;
+    if (inGroup == 0) {
+        m_keyframes.emplace_back(static_cast<uint32_t>(m_frameCount), m_bytesWritten);
+        for (size_t i = 0; i < 2 * n; ++i) {
+            int64_t prediction;
+            predict(kSpatial, m_prev, m_prev2, i, i < n ? 0 : n, m_quantized, prediction);
+            m_residuals[i] = m_quantized[i] - prediction;
+        }
+    } else {
+        // 组内第二帧起才有两帧历史可供外推；选择绝对残差和更小的预测方式
+        predictor = kDelta;
+        uint64_t deltaCost = 0;
+        for (size_t i = 0; i < 2 * n; ++i) {
+            m_residuals[i] = m_quantized[i] - m_prev[i];
+            deltaCost += zigzag(m_residuals[i]);
+        }
+        if (inGroup >= 2) {
+            uint64_t linearCost = 0;
+            for (size_t i = 0; i < 2 * n; ++i) {
+                m_candidate[i] = m_quantized[i] - (2 * m_prev[i] - m_prev2[i]);
+                linearCost += zigzag(m_candidate[i]);
+            }
+            if (linearCost < deltaCost) {
+                predictor = kLinear;
+                m_residuals.swap(m_candidate);
+            }
+        }
+    }
+
+    m_payload.clear();
+    encodeResiduals(m_residuals, m_payload);
+
+    std::string record;
+    putValue(record, static_cast<uint32_t>(m_payload.size()));
+    putValue(record, t);
+    record.push_back(static_cast<char>(predictor));
+    write(record.data(), record.size());
+    write(m_payload.data(), m_payload.size());
+
+    m_prev2.swap(m_prev);
+    m_prev.swap(m_quantized);
+    ++m_frameCount;
+    return static_cast<bool>(*m_os);
+}
+
+bool FrameStreamEncoder::finish(){
+    if (!m_os) return false;
+
+    // 结束标记：数据长度为 0 的记录
+    std::string tail;
+    putValue(tail, static_cast<uint32_t>(0));
+    const uint64_t indexOffset = m_bytesWritten + tail.size();
+    putValue(tail, static_cast<uint32_t>(m_frameCount));
+    putValue(tail, static_cast<uint32_t>(m_keyframes.size()));
+    for (const auto& [frame, offset] : m_keyframes) {
+        putValue(tail, frame);
+        putValue(tail, offset);
+    }
+    putValue(tail, indexOffset);
+    tail.append(kIndexMagic, sizeof(kIndexMagic));
+    write(tail.data(), tail.size());
+    m_os->flush();
+
+    const bool ok = static_cast<bool>(*m_os);
+    m_os = nullptr;
+    return ok;
+}
+
+bool FrameStreamDecoder::fail(const std::string& message){
+    m_error = message;
+    return false;
+}
+
+bool FrameStreamDecoder::open(std::istream& is){
+    m_is = &is;
+    m_frameCount = -1;
+    m_position = 0;
+    m_ended = false;
+    m_keyframes.clear();
+    m_error.clear();
+
+    char header[kHeaderSize];
+    if (!is.read(header, sizeof(header))) return fail("truncated header");
+    if (std::memcmp(header, kStreamMagic, sizeof(kStreamMagic)) != 0 || getValue<uint32_t>(header + 4) != kStreamVersion) {
+        return fail("unsupported stream format or version");
+    }
+    const uint32_t vertexCount = getValue<uint32_t>(header + 8);
+    m_keyframeInterval = static_cast<int>(getValue<uint32_t>(header + 12));
+    m_precision = getValue<double>(header + 16);
+    if (vertexCount == 0 || vertexCount > (1u << 28) || m_keyframeInterval <= 0 || !(m_precision > 0.0)) {
+        return fail("corrupt header");
+    }
+    m_vertexCount = static_cast<int>(vertexCount);
+    const size_t values = 2 * static_cast<size_t>(vertexCount);
+    auto allocate = [&]() {
+        m_prev.assign(values, 0);
+        m_prev2.assign(values, 0);
+        m_quantized.resize(values);
+        m_residuals.resize(values);
+    };
+
+    // 可定位的流：从尾部读取关键帧索引，然后回到第一帧
+    const std::streampos dataStart = is.tellg();
+    if (dataStart == std::streampos(-1) || !is.seekg(0, std::ios::end)) {
+        is.clear();
+        allocate();
+        return true;
+    }
+    const std::streamoff end = is.tellg();
+    char trailer[kTrailerSize];
+    if (end < static_cast<std::streamoff>(kHeaderSize + kTrailerSize)
+        || !is.seekg(end - static_cast<std::streamoff>(kTrailerSize)) || !is.read(trailer, sizeof(trailer))
+        || std::memcmp(trailer + 8, kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        return fail("missing keyframe index (stream not finished?)");
+    }
+    const uint64_t indexOffset = getValue<uint64_t>(trailer);
+    char counts[8];
+    if (indexOffset > static_cast<uint64_t>(end) || !is.seekg(static_cast<std::streamoff>(indexOffset)) || !is.read(counts, sizeof(counts))) {
+        return fail("corrupt keyframe index");
+    }
+    const uint32_t frameCount = getValue<uint32_t>(counts);
+    const uint32_t keyCount = getValue<uint32_t>(counts + 4);
+    if (static_cast<uint64_t>(keyCount) * 12 + indexOffset + sizeof(counts) + kTrailerSize != static_cast<uint64_t>(end)) {
+        return fail("corrupt keyframe index");
+    }
+    std::string entries(static_cast<size_t>(keyCount) * 12, '\0');
+    if (!is.read(entries.data(), static_cast<std::streamsize>(entries.size()))) return fail("corrupt keyframe index");
+    for (uint32_t k = 0; k < keyCount; ++k) {
+        m_keyframes.emplace_back(getValue<uint32_t>(entries.data() + 12 * k), getValue<uint64_t>(entries.data() + 12 * k + 4));
+    }
+    // 每个值至少占 1 位：损坏的顶点数不能让我们按它分配远超流长度的内存
+    if (frameCount > 0 && values / 8 > static_cast<uint64_t>(end)) return fail("corrupt header");
+    m_frameCount = static_cast<int>(frameCount);
+    allocate();
+
+    if (!is.seekg(dataStart)) return fail("seek failed");
+    return true;
+}
+
+bool FrameStreamDecoder::next(float& t, double* xy){
+    if (!m_is || m_ended) return false;
+
+    char record[kRecordHeaderSize];
+    if (!m_is->read(record, 4)) return fail("truncated stream");
+    const uint32_t payloadSize = getValue<uint32_t>(record);
+    if (payloadSize == 0) {
+        m_ended = true;
+        return false;
+    }
+    if (payloadSize > maxPayloadSize(m_residuals.size())) return fail("corrupt frame record");
+    if (!m_is->read(record + 4, kRecordHeaderSize - 4)) return fail("truncated stream");
+    t = getValue<float>(record + 4);
+    const Predictor predictor = static_cast<Predictor>(record[8]);
+    if (predictor > kLinear) return fail("corrupt frame record");
+    if (predictor == kSpatial) {
+        if (m_position % m_keyframeInterval != 0) return fail("unexpected keyframe");
+    } else if (m_position % m_keyframeInterval == 0 || (predictor == kLinear && m_position % m_keyframeInterval < 2)) {
+        // 组内的前几帧缺少预测所需的历史，说明是从关键帧之外的位置开始解码的
+        return fail("frame depends on frames before the keyframe");
+    }
+
+    m_payload.resize(payloadSize);
+    if (!m_is->read(m_payload.data(), payloadSize)) return fail("truncated stream");
+    if (!decodeResiduals(m_payload, m_residuals)) return fail("corrupt frame payload");
+
+    const size_t n = static_cast<size_t>(m_vertexCount);
+    for (size_t i = 0; i < 2 * n; ++i) {
+        int64_t prediction;
+        predict(predictor, m_prev, m_prev2, i, i < n ? 0 : n, m_quantized, prediction);
+        m_quantized[i] = m_residuals[i] + prediction;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        xy[2 * i] = static_cast<double>(m_quantized[i]) * m_precision;
+        xy[2 * i + 1] = static_cast<double>(m_quantized[n + i]) * m_precision;
+    }
+
+    m_prev2.swap(m_prev);
+    m_prev.swap(m_quantized);
+    ++m_position;
+    return true;
+}
+
+bool FrameStreamDecoder::seek(int frame){
+    if (!m_is) return false;
+    if (m_frameCount < 0) return fail("stream is not seekable");
+    if (frame < 0 || frame >= m_frameCount) return fail("frame out of range");
+
+    // 最近的、不晚于目标帧的关键帧
+    const std::pair<uint32_t, uint64_t>* key = nullptr;
+    for (const auto& entry : m_keyframes) {
+        if (entry.first <= static_cast<uint32_t>(frame) && (!key || entry.first > key->first)) key = &entry;
+    }
+    if (!key) return fail("no keyframe before frame");
+
+    m_is->clear();
+    if (!m_is->seekg(static_cast<std::streamoff>(key->second))) return fail("seek failed");
+    m_position = static_cast<int>(key->first);
+    m_ended = false;
+
+    std::vector<double> scratch(2 * static_cast<size_t>(m_vertexCount));
+    float t;
+    while (m_position < frame) {
+        if (!next(t, scratch.data())) return m_error.empty() ? fail("frame out of range") : false;
+    }
+    return true;
+}
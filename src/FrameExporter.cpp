@@ -0,0 +1,299 @@
+#include "FrameExporter.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+constexpr size_t kViewBoxWidth = 80; // viewBox 占位的宽度，足够容纳 4 个 %.10g
+
+/**
+ * @brief 等待对端时的退避：先自旋，再让出时间片，最后短暂休眠，避免长时间空转占满一个核。
+ */
+void backoff(int& spins) {
+    if (spins < 64) {
+        ++spins;
+    } else if (spins < 128) {
+        ++spins;
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void appendNumber(std::string& text, const char* format, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), format, value);
+    text.append(buffer, static_cast<size_t>(length));
+}
+
+} // namespace
+
+FrameExporter::~FrameExporter(){
+    if (!m_ring) return;
+    stopWriter();
+    m_out.close();
+    std::error_code ec;
+    std::filesystem::remove(m_tmpPath, ec);
+}
+
+bool FrameExporter::formatFromPath(const std::string& path, ExportFormat& format){
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (extension == ".csv") {
+        format = ExportFormat::Csv;
+    } else if (extension == ".svg") {
+        format = ExportFormat::Svg;
+    } else if (extension == ".sbz") {
+        format = ExportFormat::Compressed;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool FrameExporter::open(const std::string& path, ExportFormat format, int vertexCount, size_t ringSlots,
+                         const FrameCodecOptions& codec){
+    if (m_ring) {
+        m_error = "exporter is already open";
+        return false;
+    }
+    if (vertexCount <= 0 || ringSlots == 0) {
+        m_error = "exporter needs at least one vertex and one ring slot";
+        return false;
+    }
+
+    m_format = format;
+    m_vertexCount = vertexCount;
+    m_path = path;
+    m_tmpPath = path + ".tmp";
+    m_error.clear();
+    m_stats = ExportStats();
+    m_writerWaitSeconds = 0.0;
+    m_written = 0;
+    m_closed = false;
+    m_failed = false;
+
+    m_out.open(m_tmpPath, std::ios::binary | std::ios::trunc);
+    if (!m_out.is_open()) {
+        m_error = "failed to create " + m_tmpPath;
+        return false;
+    }
+
+    bool ok = true;
+    switch (format) {
+        case ExportFormat::Csv:
+            m_out << "frame,t,vertex,x,y\n";
+            break;
+        case ExportFormat::Svg:
+            // 所有帧写完才知道范围：先留出定宽的空白，finish() 时回填
+            m_out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"";
+            m_viewBoxPos = m_out.tellp();
+            m_out << std::string(kViewBoxWidth, ' ')
+                  << "\">\n<g fill=\"none\" stroke=\"black\" stroke-width=\"1\" vector-effect=\"non-scaling-stroke\">\n";
+            break;
+        case ExportFormat::Compressed:
+            ok = m_encoder.open(m_out, vertexCount, codec);
+            break;
+    }
+    if (!ok || !m_out) {
+        m_error = "failed to write " + m_tmpPath;
+        m_out.close();
+        std::error_code ec;
+        std::filesystem::remove(m_tmpPath, ec);
+        return false;
+    }
+
+    ExportFrame prototype;
+    prototype.xy.resize(2 * static_cast<size_t>(vertexCount));
+    m_ring = std::make_unique<SpscRing<ExportFrame>>(ringSlots, prototype);
+    m_writer = std::thread([this]() { writerLoop(); });
+    return true;
+}
+
+ExportFrame* FrameExporter::acquire(){
+    if (!m_ring || m_failed.load(std::memory_order_acquire)) return nullptr;
+    ExportFrame* slot = m_ring->acquire();
+    if (slot) return slot;
+
+    // 队列满：写线程跟不上，生产者在这里等待（背压）
+    const auto start = std::chrono::steady_clock::now();
+    int spins = 0;
+    while (!(slot = m_ring->acquire())) {
+        if (m_failed.load(std::memory_order_acquire)) return nullptr;
+        backoff(spins);
+    }
+    m_stats.producerWaitSeconds += secondsSince(start);
+    return slot;
+}
+
+void FrameExporter::commit(){
+    m_ring->publish();
+    ++m_stats.frames;
+}
+
+void FrameExporter::stopWriter(){
+    m_closed.store(true, std::memory_order_release);
+    if (m_writer.joinable()) m_writer.join();
+}
+
+void FrameExporter::writerLoop(){
+    int spins = 0;
+    bool waiting = false;
+    std::chrono::steady_clock::time_point waitStart;
+    for (;;) {
+        ExportFrame* frame = m_ring->front();
+        if (!frame) {
+            // 先读 closed 再重新检查队列：生产者在标记结束之前提交的帧一定能看到
+            if (m_closed.load(std::memory_order_acquire) && !(frame = m_ring->front())) break;
+            if (!frame) {
+                if (!waiting) {
+                    waiting = true;
+                    waitStart = std::chrono::steady_clock::now();
+                }
+                backoff(spins);
+                continue;
+            }
+        }
+        if (waiting) {
+            m_writerWaitSeconds += secondsSince(waitStart);
+            waiting = false;
+        }
+        spins = 0;
+
+        // 失败后继续排空队列，但不再写入
+        if (!m_failed.load(std::memory_order_relaxed)) {
+            ScopedTimer timer("serialize");
+            if (!writeFrame(*frame)) {
+                m_error = "failed to write " + m_tmpPath;
+                m_failed.store(true, std::memory_order_release);
+            }
+        }
+        m_ring->pop();
+    }
+}
+
+bool FrameExporter::writeFrame(const ExportFrame& frame){
+    const int n = m_vertexCount;
+    const double* xy = frame.xy.data();
+    m_text.clear();
+
+    switch (m_format) {
+        case ExportFormat::Csv: {
+            std::string prefix = std::to_string(m_written) + ",";
+            appendNumber(prefix, "%.9g", frame.t);
+            prefix += ",";
+            for (int i = 0; i < n; ++i) {
+                m_text += prefix;
+                m_text += std::to_string(i);
+                appendNumber(m_text, ",%.10g", xy[2 * i]);
+                appendNumber(m_text, ",%.10g\n", xy[2 * i + 1]);
+            }
+            break;
+        }
+        case ExportFormat::Svg: {
+            m_text += "<path id=\"frame_" + std::to_string(m_written) + "\" data-t=\"";
+            appendNumber(m_text, "%.9g", frame.t);
+            m_text += "\" d=\"";
+            for (int i = 0; i < n; ++i) {
+                const double x = xy[2 * i];
+                const double y = xy[2 * i + 1];
+                if (m_written == 0 && i == 0) {
+                    m_minX = m_maxX = x;
+                    m_minY = m_maxY = y;
+                }
+                m_minX = std::min(m_minX, x);
+                m_maxX = std::max(m_maxX, x);
+                m_minY = std::min(m_minY, y);
+                m_maxY = std::max(m_maxY, y);
+
+                m_text += i == 0 ? "M" : " L";
+                appendNumber(m_text, "%.10g", x);
+                appendNumber(m_text, " %.10g", y);
+            }
+            m_text += " Z\"/>\n";
+            break;
+        }
+        case ExportFormat::Compressed:
+            if (!m_encoder.addFrame(frame.t, xy)) return false;
+            break;
+    }
+
+    m_out.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+    ++m_written;
+    return static_cast<bool>(m_out);
+}
+
+bool FrameExporter::writeTrailer(){
+    switch (m_format) {
+        case ExportFormat::Csv:
+            break;
+        case ExportFormat::Svg: {
+            m_out << "</g>\n</svg>\n";
+            const std::streampos end = m_out.tellp();
+
+            // 四周留出 2% 的边距；没有帧时给一个单位正方形
+            double margin = 0.02 * std::max(m_maxX - m_minX, m_maxY - m_minY);
+            if (m_written == 0) {
+                m_minX = m_minY = 0.0;
+                m_maxX = m_maxY = 1.0;
+                margin = 0.0;
+            }
+            std::string viewBox;
+            appendNumber(viewBox, "%.10g", m_minX - margin);
+            appendNumber(viewBox, " %.10g", m_minY - margin);
+            appendNumber(viewBox, " %.10g", m_maxX - m_minX + 2.0 * margin);
+            appendNumber(viewBox, " %.10g", m_maxY - m_minY + 2.0 * margin);
+            m_out.seekp(m_viewBoxPos);
+            m_out.write(viewBox.data(), static_cast<std::streamsize>(std::min(viewBox.size(), kViewBoxWidth)));
+            m_out.seekp(end);
+            break;
+        }
+        case ExportFormat::Compressed:
+            if (!m_encoder.finish()) return false;
+            break;
+    }
+    m_out.flush();
+    m_stats.bytes = static_cast<uint64_t>(m_out.tellp());
+    return static_cast<bool>(m_out);
+}
+
+bool FrameExporter::finish(){
+    if (!m_ring) return false;
+
+    // 结束流：写线程写完队列中剩余的帧后退出
+    stopWriter();
+    m_ring.reset();
+    m_stats.writerWaitSeconds = m_writerWaitSeconds;
+
+    bool ok = !m_failed.load(std::memory_order_acquire);
+    if (ok && !writeTrailer()) {
+        m_error = "failed to write " + m_tmpPath;
+        ok = false;
+    }
+    m_out.close();
+    std::error_code ec;
+    if (ok && !m_out) {
+        m_error = "failed to write " + m_tmpPath;
+        ok = false;
+    }
+    if (!ok) {
+        std::filesystem::remove(m_tmpPath, ec);
+        return false;
+    }
+
+    std::filesystem::rename(m_tmpPath, m_path, ec);
+    if (ec) {
+        m_error = "failed to rename " + m_tmpPath + ": " + ec.message();
+        std::filesystem::remove(m_tmpPath, ec);
+        return false;
+    }
+    return true;
+}
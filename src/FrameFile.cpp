@@ -0,0 +1,164 @@
+#include "FrameFile.h"
+#include <climits>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+struct FrameHeader {
+    char magic[4];          // "SBF1"
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t frameCount;
+    uint64_t frameStride;
+    uint64_t timesOffset;
+    uint64_t framesOffset;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(FrameHeader) == 64, "FrameHeader must stay 64 bytes");
+
+constexpr char kFrameMagic[4] = {'S', 'B', 'F', '1'};
+constexpr uint32_t kFrameVersion = 1;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+size_t FrameFileFormat::frameStride(int vertexCount){
+    return alignUp(2 * sizeof(float) * static_cast<size_t>(vertexCount), kAlignment);
+}
+
+FrameFileWriter::~FrameFileWriter(){
+    if (!m_file) return;
+    m_file.reset();
+    std::error_code ec;
+    std::filesystem::remove(m_tmpPath, ec);
+}
+
+bool FrameFileWriter::open(const std::string& path, int vertexCount, int frameCount){
+    m_file.reset();
+    if (vertexCount <= 0 || frameCount <= 0) {
+        m_error = "frame file needs at least one vertex and one frame";
+        return false;
+    }
+
+    m_path = path;
+    m_tmpPath = path + ".tmp";
+    m_vertexCount = vertexCount;
+    m_frameCount = frameCount;
+    m_stride = FrameFileFormat::frameStride(vertexCount);
+    m_timesOffset = sizeof(FrameHeader);
+    m_framesOffset = alignUp(m_timesOffset + sizeof(float) * static_cast<size_t>(frameCount), FrameFileFormat::kAlignment);
+
+    std::string error;
+    m_file = MappedFile::create(m_tmpPath, m_framesOffset + m_stride * static_cast<size_t>(frameCount), &error);
+    if (!m_file) {
+        m_error = "failed to create " + m_tmpPath + ": " + error;
+        return false;
+    }
+
+    FrameHeader header = {};
+    std::memcpy(header.magic, kFrameMagic, sizeof(kFrameMagic));
+    header.version = littleEndian(kFrameVersion);
+    header.vertexCount = littleEndian(static_cast<uint32_t>(vertexCount));
+    header.frameCount = littleEndian(static_cast<uint32_t>(frameCount));
+    header.frameStride = littleEndian(static_cast<uint64_t>(m_stride));
+    header.timesOffset = littleEndian(static_cast<uint64_t>(m_timesOffset));
+    header.framesOffset = littleEndian(static_cast<uint64_t>(m_framesOffset));
+    std::memcpy(m_file->writableData(), &header, sizeof(header));
+    return true;
+}
+
+float* FrameFileWriter::frame(int k){
+    return reinterpret_cast<float*>(m_file->writableData() + m_framesOffset + m_stride * static_cast<size_t>(k));
+}
+
+void FrameFileWriter::setTime(int k, float t){
+    std::memcpy(m_file->writableData() + m_timesOffset + sizeof(float) * static_cast<size_t>(k), &t, sizeof(t));
+}
+
+bool FrameFileWriter::finish(){
+    if (!m_file) return false;
+
+    // 调用者按本机字节序写入；大端主机在这里统一转换
+    if (!hostIsLittleEndian()) {
+        float* times = reinterpret_cast<float*>(m_file->writableData() + m_timesOffset);
+        for (int k = 0; k < m_frameCount; ++k) times[k] = littleEndian(times[k]);
+        for (int k = 0; k < m_frameCount; ++k) {
+            float* xy = frame(k);
+            for (int i = 0; i < 2 * m_vertexCount; ++i) xy[i] = littleEndian(xy[i]);
+        }
+    }
+
+    // 解除映射即可，内核会写回页面；改名保证读者不会看到写了一半的文件
+    m_file.reset();
+    std::error_code ec;
+    std::filesystem::rename(m_tmpPath, m_path, ec);
+    if (ec) {
+        m_error = "failed to rename " + m_tmpPath + ": " + ec.message();
+        std::filesystem::remove(m_tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool FrameFile::open(const std::string& path){
+    m_file.reset();
+    m_vertexCount = 0;
+    m_frameCount = 0;
+
+    if (!hostIsLittleEndian()) {
+        std::cerr << "Error: Frame files can only be mapped on little-endian hosts: " << path << std::endl;
+        return false;
+    }
+
+    std::string error;
+    std::shared_ptr<const MappedFile> file = MappedFile::open(path, &error);
+    if (!file) {
+        std::cerr << "Error: Failed to open frame file: " << path << " (" << error << ")" << std::endl;
+        return false;
+    }
+
+    FrameHeader header;
+    if (file->size() < sizeof(header)) {
+        std::cerr << "Error: Truncated frame file: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kFrameMagic, sizeof(kFrameMagic)) != 0 || header.version != kFrameVersion) {
+        std::cerr << "Error: Unsupported frame file format or version: " << path << std::endl;
+        return false;
+    }
+
+    const uint64_t vertexCount = header.vertexCount;
+    const uint64_t frameCount = header.frameCount;
+    const bool valid = vertexCount > 0 && vertexCount <= INT_MAX && frameCount > 0 && frameCount <= INT_MAX
+        && header.frameStride == FrameFileFormat::frameStride(static_cast<int>(vertexCount))
+        && header.timesOffset >= sizeof(header) && header.timesOffset + sizeof(float) * frameCount <= header.framesOffset
+        && header.framesOffset % FrameFileFormat::kAlignment == 0
+        && header.framesOffset <= file->size() && (file->size() - header.framesOffset) / header.frameStride >= frameCount;
+    if (!valid) {
+        std::cerr << "Error: Corrupt frame file header: " << path << std::endl;
+        return false;
+    }
+
+    m_file = std::move(file);
+    m_vertexCount = static_cast<int>(vertexCount);
+    m_frameCount = static_cast<int>(frameCount);
+    m_stride = static_cast<size_t>(header.frameStride);
+    m_timesOffset = static_cast<size_t>(header.timesOffset);
+    m_framesOffset = static_cast<size_t>(header.framesOffset);
+    return true;
+}
+
+float FrameFile::time(int k) const{
+    float t;
+    std::memcpy(&t, m_file->data() + m_timesOffset + sizeof(float) * static_cast<size_t>(k), sizeof(t));
+    return t;
+}
+
+const float* FrameFile::frame(int k) const{
+    return reinterpret_cast<const float*>(m_file->data() + m_framesOffset + m_stride * static_cast<size_t>(k));
+}
@@ -0,0 +1,263 @@
+#include "KineticBvh.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr int kMaxDepth = 64; // 中位数划分的树深约为 log2(n / leafSize)，远小于它
+
+float floorFloat(double v) {
+    float f = static_cast<float>(v);
+    if (static_cast<double>(f) > v) f = std::nextafter(f, -std::numeric_limits<float>::infinity());
+    return f;
+}
+
+float ceilFloat(double v) {
+    float f = static_cast<float>(v);
+    if (static_cast<double>(f) < v) f = std::nextafter(f, std::numeric_limits<float>::infinity());
+    return f;
+}
+
+inline double cross(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+} // namespace
+
+bool KineticBvh::build(const MorphPlan& plan, const KineticBvhOptions& options){
+    m_nodes.clear();
+    m_edges.clear();
+    m_boxes.clear();
+    const int n = plan.n;
+    if (n < 3) return false;
+
+    m_plan = plan;
+    m_slabs = std::max(1, options.slabs);
+    const int leafSize = std::max(1, options.leafSize);
+
+    // 拓扑：t = 0.5 时各边中点的中位数划分
+    std::vector<double> xy(2 * static_cast<size_t>(n));
+    m_plan.evaluate(0.5f, xy.data());
+    std::vector<double> centers(2 * static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        const int j = i + 1 == n ? 0 : i + 1;
+        centers[2 * i] = 0.5 * (xy[2 * i] + xy[2 * j]);
+        centers[2 * i + 1] = 0.5 * (xy[2 * i + 1] + xy[2 * j + 1]);
+    }
+    m_edges.resize(n);
+    for (int i = 0; i < n; ++i) m_edges[i] = i;
+    m_nodes.reserve(2 * static_cast<size_t>((n + leafSize - 1) / leafSize));
+    m_nodes.emplace_back();
+    buildNode(0, 0, n, centers, leafSize);
+
+    // 每个时间片：顶点在两端的位置，向外扩展半个时间片内能移动的最远距离
+    const int nodes = nodeCount();
+    m_boxes.resize(static_cast<size_t>(m_slabs) * nodes);
+    std::vector<double> xy0(2 * static_cast<size_t>(n));
+    std::vector<double> xy1(2 * static_cast<size_t>(n));
+    std::vector<double> speed(n);
+    std::vector<double> accel(n);
+    std::vector<double> vertexBox(4 * static_cast<size_t>(n));
+    m_plan.evaluate(0.0f, xy0.data());
+    for (int s = 0; s < m_slabs; ++s) {
+        const float t0 = static_cast<float>(s) / m_slabs;
+        const float t1 = s + 1 == m_slabs ? 1.0f : static_cast<float>(s + 1) / m_slabs;
+        m_plan.evaluate(t1, xy1.data());
+        m_plan.speedBounds(t0, t1, speed.data(), accel.data());
+        const double span = static_cast<double>(t1) - static_cast<double>(t0);
+
+        for (int i = 0; i < n; ++i) {
+            const double x0 = xy0[2 * i], y0 = xy0[2 * i + 1];
+            const double x1 = xy1[2 * i], y1 = xy1[2 * i + 1];
+            // 轨迹离最近的端点不超过 speed * span / 2，离两端的连线（在端点包围盒内）不超过 accel * span^2 / 8；
+            // 取较紧的一个，另加一点余量覆盖 evaluate() 的舍入误差
+            const double reach = std::min(speed[i] * 0.5 * span, accel[i] * 0.125 * span * span);
+            const double pad = reach + 1e-9 * (1.0 + std::max({std::abs(x0), std::abs(y0), std::abs(x1), std::abs(y1)}));
+            vertexBox[4 * i] = std::min(x0, x1) - pad;
+            vertexBox[4 * i + 1] = std::min(y0, y1) - pad;
+            vertexBox[4 * i + 2] = std::max(x0, x1) + pad;
+            vertexBox[4 * i + 3] = std::max(y0, y1) + pad;
+        }
+
+        // 子节点总是排在父节点之后，倒序遍历即可自底向上合并
+        Box* boxes = m_boxes.data() + static_cast<size_t>(s) * nodes;
+        for (int node = nodes - 1; node >= 0; --node) {
+            const Node& nd = m_nodes[node];
+            Box& box = boxes[node];
+            if (nd.count == 0) {
+                const Box& a = boxes[nd.child];
+                const Box& b = boxes[nd.child + 1];
+                box = {std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+                continue;
+            }
+            double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+            for (int k = nd.first; k < nd.first + nd.count; ++k) {
+                const int e = m_edges[k];
+                for (int v : {e, e + 1 == n ? 0 : e + 1}) {
+                    minX = std::min(minX, vertexBox[4 * v]);
+                    minY = std::min(minY, vertexBox[4 * v + 1]);
+                    maxX = std::max(maxX, vertexBox[4 * v + 2]);
+                    maxY = std::max(maxY, vertexBox[4 * v + 3]);
+                }
+            }
+            box = {floorFloat(minX), floorFloat(minY), ceilFloat(maxX), ceilFloat(maxY)};
+        }
+        xy0.swap(xy1);
+    }
+    return true;
+}
+
+int KineticBvh::buildNode(int node, int begin, int end, const std::vector<double>& centers, int leafSize){
+    if (end - begin <= leafSize) {
+        m_nodes[node].first = begin;
+        m_nodes[node].count = end - begin;
+        return node;
+    }
+
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for (int k = begin; k < end; ++k) {
+        const int e = m_edges[k];
+        minX = std::min(minX, centers[2 * e]);
+        maxX = std::max(maxX, centers[2 * e]);
+        minY = std::min(minY, centers[2 * e + 1]);
+        maxY = std::max(maxY, centers[2 * e + 1]);
+    }
+    const int axis = maxX - minX >= maxY - minY ? 0 : 1;
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(m_edges.begin() + begin, m_edges.begin() + mid, m_edges.begin() + end,
+                     [&](int a, int b) { return centers[2 * a + axis] < centers[2 * b + axis]; });
+
+    const int child = nodeCount();
+    m_nodes[node].child = child;
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+    buildNode(child, begin, mid, centers, leafSize);
+    buildNode(child + 1, mid, end, centers, leafSize);
+    return node;
+}
+
+const KineticBvh::Box* KineticBvh::slabBoxes(float t) const{
+    const int slab = std::min(m_slabs - 1, std::max(0, static_cast<int>(std::floor(t * m_slabs))));
+    return m_boxes.data() + static_cast<size_t>(slab) * nodeCount();
+}
+
+bool KineticBvh::contains(float t, double x, double y) const{
+    if (empty() || !std::isfinite(t)) return false;
+    t = std::min(1.0f, std::max(0.0f, t));
+    const Box* boxes = slabBoxes(t);
+    const MorphPlan::Frame frame = m_plan.frameAt(t);
+    const int n = m_plan.n;
+
+    // 向 +x 方向的水平射线与边的交点个数的奇偶性；只需访问与该射线相交的节点
+    bool inside = false;
+    int stack[kMaxDepth];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const int node = stack[--top];
+        const Box& box = boxes[node];
+        if (box.maxX < x || box.minY > y || box.maxY < y) continue;
+        const Node& nd = m_nodes[node];
+        if (nd.count == 0) {
+            stack[top++] = nd.child;
+            stack[top++] = nd.child + 1;
+            continue;
+        }
+        for (int k = nd.first; k < nd.first + nd.count; ++k) {
+            const int e = m_edges[k];
+            const Eigen::Vector2d a = m_plan.evaluateVertex(frame, e);
+            const Eigen::Vector2d b = m_plan.evaluateVertex(frame, e + 1 == n ? 0 : e + 1);
+            if ((a.y() > y) != (b.y() > y) && x < a.x() + (y - a.y()) * (b.x() - a.x()) / (b.y() - a.y())) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+bool KineticBvh::raycast(float t, double originX, double originY, double dirX, double dirY, double maxDistance,
+                         RayHit& hit) const{
+    hit = RayHit();
+    const double length = std::hypot(dirX, dirY);
+    if (empty() || !std::isfinite(t) || !(length > 0.0) || !std::isfinite(length)) return false;
+    t = std::min(1.0f, std::max(0.0f, t));
+    const double dx = dirX / length;
+    const double dy = dirY / length;
+    const double invX = 1.0 / dx;
+    const double invY = 1.0 / dy;
+    const Box* boxes = slabBoxes(t);
+    const MorphPlan::Frame frame = m_plan.frameAt(t);
+    const int n = m_plan.n;
+
+    // 射线进入包围盒的距离；不相交时为 +inf
+    auto entry = [&](const Box& box, double best) {
+        double lo = 0.0, hi = best;
+        for (int axis = 0; axis < 2; ++axis) {
+            const double o = axis == 0 ? originX : originY;
+            const double inv = axis == 0 ? invX : invY;
+            const double d = axis == 0 ? dx : dy;
+            const double bmin = axis == 0 ? box.minX : box.minY;
+            const double bmax = axis == 0 ? box.maxX : box.maxY;
+            if (d == 0.0) {
+                if (o < bmin || o > bmax) return HUGE_VAL;
+                continue;
+            }
+            double near = (bmin - o) * inv;
+            double far = (bmax - o) * inv;
+            if (near > far) std::swap(near, far);
+            lo = std::max(lo, near);
+            hi = std::min(hi, far);
+            if (lo > hi) return HUGE_VAL;
+        }
+        return lo;
+    };
+
+    double best = maxDistance;
+    int stack[kMaxDepth];
+    int top = 0;
+    if (entry(boxes[0], best) == HUGE_VAL) return false;
+    stack[top++] = 0;
+    while (top > 0) {
+        const int node = stack[--top];
+        const Node& nd = m_nodes[node];
+        if (nd.count == 0) {
+            // 先访问较近的子节点（后入栈），找到交点后可以剪掉较远的那个
+            const double da = entry(boxes[nd.child], best);
+            const double db = entry(boxes[nd.child + 1], best);
+            const int nearChild = da <= db ? nd.child : nd.child + 1;
+            const double nearEntry = std::min(da, db);
+            const double farEntry = std::max(da, db);
+            if (farEntry != HUGE_VAL) stack[top++] = nearChild == nd.child ? nd.child + 1 : nd.child;
+            if (nearEntry != HUGE_VAL) stack[top++] = nearChild;
+            continue;
+        }
+        if (entry(boxes[node], best) == HUGE_VAL) continue; // best 可能在入栈之后变小了
+        for (int k = nd.first; k < nd.first + nd.count; ++k) {
+            const int e = m_edges[k];
+            const Eigen::Vector2d a = m_plan.evaluateVertex(frame, e);
+            const Eigen::Vector2d b = m_plan.evaluateVertex(frame, e + 1 == n ? 0 : e + 1);
+            const double ex = b.x() - a.x();
+            const double ey = b.y() - a.y();
+            const double denom = cross(dx, dy, ex, ey);
+            if (denom == 0.0) continue; // 平行（包括共线）的边不算交点
+            const double ax = a.x() - originX;
+            const double ay = a.y() - originY;
+            const double distance = cross(ax, ay, ex, ey) / denom;
+            const double param = cross(ax, ay, dx, dy) / denom;
+            if (distance < 0.0 || distance > best || param < 0.0 || param > 1.0) continue;
+            best = distance;
+            hit.edge = e;
+            hit.distance = distance;
+            hit.edgeParam = param;
+            hit.x = originX + distance * dx;
+            hit.y = originY + distance * dy;
+        }
+    }
+    return hit.edge >= 0;
+}
+
+size_t KineticBvh::memoryUsage() const{
+    return m_nodes.capacity() * sizeof(Node) + m_edges.capacity() * sizeof(int) + m_boxes.capacity() * sizeof(Box) +
+           (m_plan.uv1.capacity() + m_plan.uv2.capacity()) * sizeof(Eigen::Vector2d);
+}
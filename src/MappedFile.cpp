@@ -0,0 +1,130 @@
+#include "MappedFile.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHAPEBLENDER_HAS_MMAP 1
+#endif
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path, std::string* error){
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return std::shared_ptr<const MappedFile>();
+    };
+
+    // 构造函数是私有的，不能用 make_shared
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef SHAPEBLENDER_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail(std::strerror(errno));
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        const std::string message = std::strerror(errno);
+        ::close(fd);
+        return fail(message);
+    }
+    file->m_size = static_cast<size_t>(info.st_size);
+    if (file->m_size > 0) {
+        void* mapping = ::mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            const std::string message = std::strerror(errno);
+            ::close(fd);
+            return fail(message);
+        }
+        file->m_data = static_cast<const char*>(mapping);
+        file->m_mapped = true;
+    }
+    // 映射建立后就不再需要文件描述符
+    ::close(fd);
+#else
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f.is_open()) return fail("cannot open file");
+    const std::streamoff size = f.tellg();
+    f.seekg(0, std::ios::beg);
+    file->m_size = size > 0 ? static_cast<size_t>(size) : 0;
+    if (file->m_size > 0) {
+        // new double[] 保证缓冲区至少按 double 对齐，与页对齐的 mmap 一样可以原地读取数组
+        char* buffer = reinterpret_cast<char*>(new double[(file->m_size + sizeof(double) - 1) / sizeof(double)]);
+        file->m_data = buffer;
+        if (!f.read(buffer, static_cast<std::streamsize>(file->m_size))) return fail("read failed");
+    }
+#endif
+    return file;
+}
+
+std::shared_ptr<MappedFile> MappedFile::create(const std::string& path, size_t size, std::string* error){
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return std::shared_ptr<MappedFile>();
+    };
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->m_size = size;
+    file->m_writable = true;
+    file->m_path = path;
+
+#ifdef SHAPEBLENDER_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return fail(std::strerror(errno));
+    // 截断后再扩展，新的文件内容全部为零
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const std::string message = std::strerror(errno);
+        ::close(fd);
+        return fail(message);
+    }
+    if (size > 0) {
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            const std::string message = std::strerror(errno);
+            ::close(fd);
+            return fail(message);
+        }
+        file->m_data = static_cast<const char*>(mapping);
+        file->m_mapped = true;
+    }
+    ::close(fd);
+#else
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) return fail("cannot create file");
+    }
+    if (size > 0) file->m_data = reinterpret_cast<char*>(new double[(size + sizeof(double) - 1) / sizeof(double)]());
+#endif
+    return file;
+}
+
+bool MappedFile::flush(std::string* error){
+    if (!m_writable || !m_data) return true;
+#ifdef SHAPEBLENDER_HAS_MMAP
+    if (m_mapped) {
+        if (::msync(const_cast<char*>(m_data), m_size, MS_SYNC) == 0) return true;
+        if (error) *error = std::strerror(errno);
+        return false;
+    }
+#endif
+    std::ofstream f(m_path, std::ios::binary | std::ios::trunc);
+    f.write(m_data, static_cast<std::streamsize>(m_size));
+    if (f) return true;
+    if (error) *error = "write failed";
+    return false;
+}
+
+MappedFile::~MappedFile(){
+    if (!m_data) return;
+#ifdef SHAPEBLENDER_HAS_MMAP
+    if (m_mapped) {
+        // MAP_SHARED 的修改在解除映射后仍由内核写回文件
+        ::munmap(const_cast<char*>(m_data), m_size);
+        return;
+    }
+#endif
+    if (m_writable) flush();
+    delete[] reinterpret_cast<const double*>(m_data);
+}
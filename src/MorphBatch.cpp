@@ -0,0 +1,368 @@
+#include "MorphBatch.h"
+#include "FrameFile.h"
+#include "MorphDiskCache.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "../lib/json/nlohmann/json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+/**
+ * @brief 每个工作线程独占的工作区，在该线程处理的所有任务之间复用，
+ * 避免为每对多边形重新分配顶点、内在属性和输出缓冲区。
+ */
+struct MorphBatch::Workspace {
+    ShapeBlender blender;
+    Polygon polyA;
+    Polygon polyB;
+    Polygon frame;
+    std::string text;
+};
+
+namespace {
+
+/**
+ * @brief 从清单的一行解析出任务；失败时把原因写入 job.error。
+ */
+void parseJob(const std::string& line, const std::filesystem::path& baseDir, BatchJob& job) {
+    nlohmann::json entry;
+    try {
+        entry = nlohmann::json::parse(line);
+    } catch (const nlohmann::json::parse_error& e) {
+        job.error = std::string("invalid JSON: ") + e.what();
+        return;
+    }
+    if (!entry.is_object()) {
+        job.error = "manifest line is not a JSON object";
+        return;
+    }
+
+    try {
+        if (!entry.contains("pathA") || !entry.contains("pathB")) {
+            job.error = "missing pathA or pathB";
+            return;
+        }
+        auto resolve = [&baseDir](const std::string& p) {
+            std::filesystem::path path(p);
+            return path.is_absolute() ? path.string() : (baseDir / path).string();
+        };
+        job.pathA = resolve(entry["pathA"].get<std::string>());
+        job.pathB = resolve(entry["pathB"].get<std::string>());
+
+        if (entry.contains("frames")) job.frameCount = entry["frames"].get<int>();
+        if (entry.contains("k")) job.manualK = entry["k"].get<int>();
+        if (entry.contains("output")) job.output = entry["output"].get<std::string>();
+
+        if (entry.contains("weights")) {
+            const auto& w = entry["weights"];
+            BlendWeights& weights = job.weights;
+            // 与命令行一致：只给出 w1 时 w2 = 1 - w1，只给出 wS、wR 时 wA = 1 - wS - wR
+            if (w.contains("w1")) {
+                weights.w1 = w["w1"].get<float>();
+                weights.w2 = 1.0f - weights.w1;
+            }
+            if (w.contains("w2")) weights.w2 = w["w2"].get<float>();
+            if (w.contains("smooth_a_wS")) weights.smooth_a_wS = w["smooth_a_wS"].get<float>();
+            if (w.contains("smooth_a_wR")) weights.smooth_a_wR = w["smooth_a_wR"].get<float>();
+            if (w.contains("smooth_a_wS") || w.contains("smooth_a_wR")) {
+                weights.smooth_a_wA = 1.0f - weights.smooth_a_wS - weights.smooth_a_wR;
+            }
+            if (w.contains("smooth_a_wA")) weights.smooth_a_wA = w["smooth_a_wA"].get<float>();
+        }
+    } catch (const nlohmann::json::exception& e) {
+        job.error = std::string("invalid field: ") + e.what();
+        return;
+    }
+
+    if (job.frameCount < 1) job.error = "frames must be >= 1";
+    else if (job.manualK < -1) job.error = "k must be >= 0 (or -1 for the auto search)";
+    else if (job.output.find('/') != std::string::npos || job.output.find('\\') != std::string::npos) {
+        job.error = "output must be a plain file name";
+    }
+}
+
+void appendDouble(std::string& text, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    text.append(buffer, static_cast<size_t>(length));
+}
+
+/**
+ * @brief 最近秩法求百分位数（values 已升序排列）。
+ */
+double percentile(const std::vector<double>& values, double q) {
+    if (values.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(q * values.size()));
+    return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+} // namespace
+
+bool MorphBatch::loadManifest(const std::string& path, const BatchJob& defaults){
+    m_jobs.clear();
+
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        std::cerr << "Error: Failed to open batch manifest: " << path << std::endl;
+        return false;
+    }
+
+    const std::filesystem::path baseDir = std::filesystem::path(path).parent_path();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(f, line)) {
+        ++lineNumber;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        BatchJob job = defaults;
+        job.line = lineNumber;
+        job.output.clear();
+        job.error.clear();
+        parseJob(line, baseDir, job);
+        m_jobs.push_back(std::move(job));
+    }
+    return true;
+}
+
+BatchSummary MorphBatch::run(const std::string& outDir, unsigned threadCount, const ResultCallback& onResult) const{
+    BatchSummary summary;
+    summary.total = static_cast<int>(m_jobs.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to create output directory " << outDir << ": " << ec.message() << std::endl;
+        summary.failed = summary.total;
+        return summary;
+    }
+
+    std::vector<double> latencies(m_jobs.size(), -1.0);
+    std::atomic<size_t> next{0};
+    std::atomic<int> succeeded{0};
+    std::mutex callbackMutex;
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threadCount);
+        summary.threads = pool.size();
+
+        // 每个工作线程一个循环任务，从共享计数器领取下一个任务；
+        // 同时在途的任务数因此不超过线程数，工作区也只需每线程一份
+        // submit 返回的 future 不保留：每个任务的异常都在循环内捕获，记为该任务失败后继续领取下一个
+        for (unsigned w = 0; w < pool.size(); ++w) {
+            pool.submit([&]() {
+                Workspace ws;
+                for (size_t i = next++; i < m_jobs.size(); i = next++) {
+                    const BatchJob& job = m_jobs[i];
+                    BatchResult result;
+                    result.line = job.line;
+
+                    const auto jobStart = std::chrono::steady_clock::now();
+                    if (job.error.empty()) {
+                        try {
+                            result.ok = process(job, outDir, ws, result);
+                        } catch (const std::exception& e) {
+                            result.ok = false;
+                            result.error = e.what();
+                            // 工作区可能停在半途的状态，下一个任务从头开始
+                            ws = Workspace();
+                        }
+                    } else {
+                        result.error = job.error;
+                    }
+                    result.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - jobStart).count();
+
+                    bool delivered = true;
+                    if (onResult) {
+                        std::lock_guard<std::mutex> lock(callbackMutex);
+                        try {
+                            onResult(result);
+                        } catch (const std::exception& e) {
+                            std::cerr << "Error: Batch result callback failed for line " << result.line << ": " << e.what() << std::endl;
+                            delivered = false;
+                        }
+                    }
+                    // 回调抛出异常时结果没有被处理，不计入成功数
+                    if (result.ok && delivered) {
+                        latencies[i] = result.latencyMs;
+                        ++succeeded;
+                    }
+                }
+            });
+        }
+        // 线程池析构时等待所有任务完成
+    }
+    summary.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    summary.succeeded = succeeded.load();
+    summary.failed = summary.total - summary.succeeded;
+    if (summary.wallSeconds > 0.0) summary.pairsPerSecond = summary.succeeded / summary.wallSeconds;
+
+    std::vector<double> okLatencies;
+    okLatencies.reserve(latencies.size());
+    for (double ms : latencies) {
+        if (ms >= 0.0) okLatencies.push_back(ms);
+    }
+    std::sort(okLatencies.begin(), okLatencies.end());
+    summary.p50Ms = percentile(okLatencies, 0.50);
+    summary.p99Ms = percentile(okLatencies, 0.99);
+    return summary;
+}
+
+bool MorphBatch::process(const BatchJob& job, const std::string& outDir, Workspace& ws, BatchResult& result) const{
+    {
+        ScopedTimer timer("load");
+        if (!ws.polyA.loadFromFile(job.pathA)) {
+            result.error = "failed to load " + job.pathA;
+            return false;
+        }
+        if (!ws.polyB.loadFromFile(job.pathB)) {
+            result.error = "failed to load " + job.pathB;
+            return false;
+        }
+    }
+    // k 是 A 的顶点编号；越界的 k 会让求解越界访问，在这里就记为失败
+    if (job.manualK >= ws.polyA.n) {
+        result.error = "k = " + std::to_string(job.manualK) + " is out of range (polygon A has " +
+                       std::to_string(ws.polyA.n) + " vertices)";
+        return false;
+    }
+    if (job.manualK >= 0 && ws.polyA.n < ws.polyB.n) {
+        result.error = "k needs polygon A to have at least as many vertices as polygon B (" +
+                       std::to_string(ws.polyA.n) + " < " + std::to_string(ws.polyB.n) + ")";
+        return false;
+    }
+
+    KSearchProgress progress;
+    progress.timeBudgetSeconds = m_searchBudget;
+    const MorphDiskCache cache(m_cacheDir);
+    MorphSolution solution = solveMorph(ws.blender, ws.polyA, ws.polyB, job.weights, job.manualK, &progress,
+                                        m_cacheDir.empty() ? nullptr : &cache);
+    if (solution.plan.empty()) {
+        result.error = "failed to solve the morph";
+        return false;
+    }
+    result.bestK = solution.bestK;
+
+    const char* extension = "sbf";
+    switch (m_format) {
+        case BatchFormat::Frames: extension = "sbf"; break;
+        case BatchFormat::Compressed: extension = "sbz"; break;
+        case BatchFormat::Csv: extension = "csv"; break;
+        case BatchFormat::Svg: extension = "svg"; break;
+        case BatchFormat::Json: extension = "json"; break;
+    }
+    char defaultName[32];
+    std::snprintf(defaultName, sizeof(defaultName), "line_%06d.%s", job.line, extension);
+    const std::filesystem::path path = std::filesystem::path(outDir) / (job.output.empty() ? defaultName : job.output);
+    result.outputPath = path.string();
+
+    ScopedTimer timer("write");
+    switch (m_format) {
+        case BatchFormat::Frames: return writeFrames(job, solution, path, result);
+        case BatchFormat::Compressed: return writeExported(job, solution, path, ExportFormat::Compressed, result);
+        case BatchFormat::Csv: return writeExported(job, solution, path, ExportFormat::Csv, result);
+        case BatchFormat::Svg: return writeExported(job, solution, path, ExportFormat::Svg, result);
+        case BatchFormat::Json: return writeJson(job, solution, path, ws, result);
+    }
+    return false;
+}
+
+bool MorphBatch::writeFrames(const BatchJob& job, const MorphSolution& solution, const std::filesystem::path& path,
+                             BatchResult& result) const{
+    // 帧直接求值到映射的文件中，不经过任何中间缓冲区
+    FrameFileWriter writer;
+    if (!writer.open(path.string(), solution.plan.n, job.frameCount)) {
+        result.error = writer.error();
+        return false;
+    }
+    for (int f = 0; f < job.frameCount; ++f) {
+        float t = job.frameCount == 1 ? 0.0f : static_cast<float>(f) / (job.frameCount - 1);
+        solution.plan.evaluate(t, writer.frame(f));
+        writer.setTime(f, t);
+    }
+    if (!writer.finish()) {
+        result.error = writer.error();
+        return false;
+    }
+    return true;
+}
+
+bool MorphBatch::writeExported(const BatchJob& job, const MorphSolution& solution, const std::filesystem::path& path,
+                               ExportFormat format, BatchResult& result) const{
+    // 帧直接求值到导出器的槽位中，序列化在导出器的写线程上与下一帧的求值重叠
+    FrameExporter exporter;
+    if (!exporter.open(path.string(), format, solution.plan.n, 8, m_codec)) {
+        result.error = exporter.error();
+        return false;
+    }
+    for (int f = 0; f < job.frameCount; ++f) {
+        ExportFrame* frame = exporter.acquire();
+        if (!frame) break;
+        frame->t = job.frameCount == 1 ? 0.0f : static_cast<float>(f) / (job.frameCount - 1);
+        solution.plan.evaluate(frame->t, frame->xy.data());
+        exporter.commit();
+    }
+    if (!exporter.finish()) {
+        result.error = exporter.error();
+        return false;
+    }
+    return true;
+}
+
+bool MorphBatch::writeJson(const BatchJob& job, const MorphSolution& solution, const std::filesystem::path& path,
+                           Workspace& ws, BatchResult& result) const{
+    // 输出：{"line": ..., "pathA": ..., "pathB": ..., "bestK": ..., "frames": [{"t": ..., "vertices": [[x, y], ...]}, ...]}
+    std::string& text = ws.text;
+    text.clear();
+    text += "{\"line\": " + std::to_string(job.line);
+    text += ", \"pathA\": " + nlohmann::json(job.pathA).dump();
+    text += ", \"pathB\": " + nlohmann::json(job.pathB).dump();
+    text += ", \"bestK\": " + std::to_string(solution.bestK);
+    text += ", \"frames\": [";
+    for (int f = 0; f < job.frameCount; ++f) {
+        float t = job.frameCount == 1 ? 0.0f : static_cast<float>(f) / (job.frameCount - 1);
+        solution.plan.evaluate(t, ws.frame);
+
+        if (f > 0) text += ", ";
+        text += "{\"t\": ";
+        appendDouble(text, t);
+        text += ", \"vertices\": [";
+        for (int i = 0; i < ws.frame.n; ++i) {
+            if (i > 0) text += ", ";
+            text += "[";
+            appendDouble(text, ws.frame.vertices[i].x());
+            text += ", ";
+            appendDouble(text, ws.frame.vertices[i].y());
+            text += "]";
+        }
+        text += "]}";
+    }
+    text += "]}\n";
+
+    // 先写临时文件再改名，中途被打断时不会留下半个输出
+    const std::filesystem::path tmp = path.string() + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        f.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!f) {
+            result.error = "failed to write " + tmp.string();
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        result.error = "failed to rename " + tmp.string() + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
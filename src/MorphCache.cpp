@@ -0,0 +1,114 @@
+#include "MorphCache.h"
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+void fnv1a(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+}
+
+template <typename T>
+void fnv1aValue(uint64_t& hash, const T& value) {
+    fnv1a(hash, &value, sizeof(value));
+}
+
+} // namespace
+
+uint64_t hashPolygon(const Polygon& poly){
+    uint64_t hash = kFnvOffset;
+    fnv1aValue(hash, poly.n);
+    for (int i = 0; i < poly.n; ++i) {
+        const double xy[2] = {poly.vertex(i).x(), poly.vertex(i).y()};
+        fnv1a(hash, xy, sizeof(xy));
+    }
+    return hash;
+}
+
+uint64_t morphKey(const Polygon& polyA, const Polygon& polyB, const BlendWeights& weights, int manual_k){
+    uint64_t hash = kFnvOffset;
+    fnv1aValue(hash, hashPolygon(polyA));
+    fnv1aValue(hash, hashPolygon(polyB));
+    for (float w : {weights.w1, weights.w2, weights.smooth_a_wS, weights.smooth_a_wR, weights.smooth_a_wA}) {
+        fnv1aValue(hash, w);
+    }
+    fnv1aValue(hash, manual_k);
+    return hash;
+}
+
+MorphCache::Entry MorphCache::getOrSolve(const Polygon& polyA, const Polygon& polyB, const BlendWeights& weights,
+                                         int manual_k, Lookup* lookup){
+    const uint64_t key = morphKey(polyA, polyB, weights, manual_k);
+
+    std::shared_ptr<InFlight> flight;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (Entry* cached = m_lru.get(key)) {
+            ++m_stats.hits;
+            if (lookup) *lookup = Lookup::Hit;
+            return *cached;
+        }
+
+        auto it = m_inFlight.find(key);
+        if (it != m_inFlight.end()) {
+            // 其他线程正在求解同一个键，等它完成
+            std::shared_ptr<InFlight> other = it->second;
+            ++m_stats.coalesced;
+            if (lookup) *lookup = Lookup::Coalesced;
+            m_cv.wait(lock, [&other]() { return other->done; });
+            return other->result;
+        }
+
+        ++m_stats.misses;
+        if (lookup) *lookup = Lookup::Miss;
+        flight = std::make_shared<InFlight>();
+        m_inFlight[key] = flight;
+    }
+
+    // 在锁外求解，不阻塞其他键的查询
+    Entry result;
+    try {
+        auto solution = std::make_shared<MorphSolution>(solveMorph(polyA, polyB, weights, manual_k));
+        if (!solution->plan.empty()) result = std::move(solution);
+    } catch (...) {
+        // 保证等待的线程被唤醒，然后把异常交给调用者
+        std::lock_guard<std::mutex> lock(m_mutex);
+        flight->done = true;
+        m_inFlight.erase(key);
+        m_cv.notify_all();
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (result) m_stats.evictions += m_lru.put(key, result);
+        flight->result = result;
+        flight->done = true;
+        m_inFlight.erase(key);
+    }
+    m_cv.notify_all();
+    return result;
+}
+
+void MorphCache::setCapacity(size_t capacity){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.evictions += m_lru.setCapacity(capacity);
+}
+
+void MorphCache::clear(){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lru.clear();
+}
+
+MorphCache::Stats MorphCache::stats() const{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.entries = m_lru.size();
+    stats.capacity = m_lru.capacity();
+    return stats;
+}
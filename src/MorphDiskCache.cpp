@@ -0,0 +1,235 @@
+#include "MorphDiskCache.h"
+#include "MorphCache.h"
+#include "Profiler.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <unistd.h>
+
+/*
+ * 文件格式（本机字节序，魔数同时用于识别字节序不同的文件）：
+ *   char[4]  "SBC1"
+ *   uint32   版本
+ *   uint64   键、A 的顶点哈希、B 的顶点哈希
+ *   int32    A 的顶点数 m、B 的顶点数 n
+ *   float[5] w1, w2, smooth_a_wS, smooth_a_wR, smooth_a_wA
+ *   int32    手动 k、最佳 k
+ *   int32[6] 仿射基在 A、B 中的索引
+ *   uint32   对应关系对数 c
+ *   uint64   负载的 FNV-1a 校验和
+ *   负载：c 个 (int32 i_A, int32 i_B)，然后 m 个 double（每个 k 的代价）
+ */
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'B', 'C', '1'};
+constexpr uint32_t kVersion = 1;
+
+uint64_t checksum(const char* data, size_t size) {
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename T>
+void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief 带边界检查的顺序读取。
+ */
+struct Reader {
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+
+    template <typename T>
+    bool get(T& value) {
+        if (size - pos < sizeof(T)) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+};
+
+struct Header {
+    uint64_t key = 0;
+    uint64_t hashA = 0;
+    uint64_t hashB = 0;
+    int32_t m = 0;
+    int32_t n = 0;
+    float weights[5] = {};
+    int32_t manualK = -1;
+};
+
+Header makeHeader(const ShapeBlender& blender, int manual_k) {
+    const BlendWeights w = blender.getWeights();
+    Header header;
+    header.key = morphKey(blender.getPolyA(), blender.getPolyB(), w, manual_k);
+    header.hashA = hashPolygon(blender.getPolyA());
+    header.hashB = hashPolygon(blender.getPolyB());
+    header.m = blender.getPolyA().n;
+    header.n = blender.getPolyB().n;
+    const float weights[5] = {w.w1, w.w2, w.smooth_a_wS, w.smooth_a_wR, w.smooth_a_wA};
+    std::memcpy(header.weights, weights, sizeof(weights));
+    header.manualK = manual_k;
+    return header;
+}
+
+} // namespace
+
+std::string MorphDiskCache::pathFor(const ShapeBlender& blender, int manual_k) const{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.sbc",
+                  static_cast<unsigned long long>(morphKey(blender.getPolyA(), blender.getPolyB(), blender.getWeights(), manual_k)));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+bool MorphDiskCache::load(ShapeBlender& blender, int manual_k) const{
+    ScopedTimer timer("cache_load");
+    if (blender.getPolyA().n == 0 || blender.getPolyB().n == 0) return false;
+
+    const std::string path = pathFor(blender, manual_k);
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) return false;
+    const std::string bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    const Header expected = makeHeader(blender, manual_k);
+    auto reject = [&path](const char* reason) {
+        std::cerr << "Warning: Ignoring cache file " << path << " (" << reason << ")." << std::endl;
+        return false;
+    };
+
+    Reader in{bytes.data(), bytes.size()};
+    char magic[4];
+    uint32_t version = 0;
+    Header header;
+    int32_t bestK = 0;
+    int32_t basis[6];
+    uint32_t pairCount = 0;
+    uint64_t payloadHash = 0;
+    bool ok = in.get(magic) && in.get(version)
+           && in.get(header.key) && in.get(header.hashA) && in.get(header.hashB)
+           && in.get(header.m) && in.get(header.n) && in.get(header.weights)
+           && in.get(header.manualK) && in.get(bestK) && in.get(basis)
+           && in.get(pairCount) && in.get(payloadHash);
+    if (!ok) return reject("truncated header");
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) return reject("bad magic");
+    if (version != kVersion) return reject("unsupported version");
+
+    // 键只是文件名；逐项比较输入，防止哈希碰撞或文件被改名
+    if (header.key != expected.key || header.hashA != expected.hashA || header.hashB != expected.hashB
+        || header.m != expected.m || header.n != expected.n || header.manualK != expected.manualK
+        || std::memcmp(header.weights, expected.weights, sizeof(header.weights)) != 0) {
+        return reject("inputs do not match");
+    }
+
+    const size_t payloadSize = static_cast<size_t>(pairCount) * 2 * sizeof(int32_t) + static_cast<size_t>(header.m) * sizeof(double);
+    if (pairCount > static_cast<uint32_t>(header.m) || bytes.size() - in.pos != payloadSize) return reject("bad payload size");
+    if (checksum(bytes.data() + in.pos, payloadSize) != payloadHash) return reject("checksum mismatch");
+
+    std::map<int, int> correspondence;
+    for (uint32_t p = 0; p < pairCount; ++p) {
+        int32_t i_A = 0, i_B = 0;
+        in.get(i_A);
+        in.get(i_B);
+        correspondence[i_A] = i_B;
+    }
+    std::vector<double> kCosts(header.m);
+    for (double& cost : kCosts) in.get(cost);
+
+    AffineBasis affine;
+    for (int k = 0; k < 3; ++k) {
+        affine.polyA_indices[k] = basis[k];
+        affine.polyB_indices[k] = basis[3 + k];
+    }
+    if (!blender.restoreSolution(correspondence, bestK, affine, kCosts)) return reject("indices out of range");
+
+    std::cout << "Loaded cached correspondence and basis from " << path << " (k = " << bestK << ")." << std::endl;
+    return true;
+}
+
+bool MorphDiskCache::store(const ShapeBlender& blender, int manual_k) const{
+    const Header header = makeHeader(blender, manual_k);
+    const auto& correspondence = blender.getCorrespondence();
+    const auto& kCosts = blender.getKCosts();
+    if (header.m == 0 || correspondence.empty() || static_cast<int>(kCosts.size()) != header.m) return false;
+
+    std::string payload;
+    payload.reserve(correspondence.size() * 2 * sizeof(int32_t) + kCosts.size() * sizeof(double));
+    for (const auto& [i_A, i_B] : correspondence) {
+        put(payload, static_cast<int32_t>(i_A));
+        put(payload, static_cast<int32_t>(i_B));
+    }
+    for (double cost : kCosts) put(payload, cost);
+
+    const AffineBasis& basis = blender.getBasis();
+    std::string bytes;
+    bytes.append(kMagic, sizeof(kMagic));
+    put(bytes, kVersion);
+    put(bytes, header.key);
+    put(bytes, header.hashA);
+    put(bytes, header.hashB);
+    put(bytes, header.m);
+    put(bytes, header.n);
+    put(bytes, header.weights);
+    put(bytes, header.manualK);
+    put(bytes, static_cast<int32_t>(blender.getBestK()));
+    for (int k = 0; k < 3; ++k) put(bytes, static_cast<int32_t>(basis.polyA_indices[k]));
+    for (int k = 0; k < 3; ++k) put(bytes, static_cast<int32_t>(basis.polyB_indices[k]));
+    put(bytes, static_cast<uint32_t>(correspondence.size()));
+    put(bytes, checksum(payload.data(), payload.size()));
+    bytes += payload;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to create cache directory " << m_directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    // 每个进程的每个线程用自己的临时文件（线程 id 只在进程内唯一，所以带上 pid），
+    // 改名是原子的，读者不会看到写了一半的文件
+    const std::string path = pathFor(blender, manual_k);
+    const std::string tmp = path + ".tmp" + std::to_string(getpid()) + "." +
+                            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!f) {
+            std::cerr << "Error: Failed to write cache file " << tmp << std::endl;
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to write cache file " << path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool MorphDiskCache::solve(ShapeBlender& blender, int manual_k, KSearchProgress* progress) const{
+    if (load(blender, manual_k)) {
+        if (progress) progress->finished = true;
+        return true;
+    }
+
+    KSearchProgress localProgress;
+    KSearchProgress* search = progress ? progress : &localProgress;
+    blender.computeCorrespondence(manual_k, search);
+    blender.findOptimalBasis();
+
+    if (!search->truncated && !blender.getPlan().empty()) store(blender, manual_k);
+    return false;
+}
@@ -0,0 +1,84 @@
+#include "MorphFanOut.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+bool MorphFanOut::loadSource(const std::string& path){
+    if (!m_source.loadFromFile(path)) {
+        std::cerr << "Failed to load fan-out source: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MorphFanOut::setSource(const Polygon& source){
+    m_source = source;
+}
+
+int MorphFanOut::run(const std::vector<std::string>& targetPaths, const ResultCallback& onResult, unsigned threadCount) const{
+    auto prepare = [&targetPaths](int i, Result& result) {
+        result.path = targetPaths[i];
+        if (!result.target.loadFromFile(result.path)) {
+            std::cerr << "Failed to load fan-out target: " << result.path << std::endl;
+            return false;
+        }
+        return true;
+    };
+    return runTasks(static_cast<int>(targetPaths.size()), prepare, onResult, threadCount);
+}
+
+int MorphFanOut::run(const std::vector<Polygon>& targets, const ResultCallback& onResult, unsigned threadCount) const{
+    auto prepare = [&targets](int i, Result& result) {
+        result.target = targets[i];
+        return result.target.n >= 3;
+    };
+    return runTasks(static_cast<int>(targets.size()), prepare, onResult, threadCount);
+}
+
+int MorphFanOut::runTasks(int count, const std::function<bool(int, Result&)>& prepare,
+                          const ResultCallback& onResult, unsigned threadCount) const{
+    if (m_source.n < 3) {
+        std::cerr << "Error: Fan-out source polygon is not loaded." << std::endl;
+        return 0;
+    }
+
+    std::atomic<int> succeeded{0};
+    std::mutex callbackMutex;
+    {
+        ThreadPool pool(threadCount);
+        for (int i = 0; i < count; ++i) {
+            // submit 返回的 future 不保留：异常都在任务内捕获，以 ok = false 的结果交给回调
+            pool.submit([&, i]() {
+                Result result;
+                result.index = i;
+                try {
+                    if (prepare(i, result)) {
+                        // 源只读共享：solveMorph 在自己的 ShapeBlender 副本上求解，不会修改源
+                        result.solution = solveMorph(m_source, result.target, m_weights, m_manualK);
+                        result.ok = !result.solution.plan.empty();
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Fan-out target " << i << (result.path.empty() ? "" : " (" + result.path + ")")
+                              << " failed: " << e.what() << std::endl;
+                    result.ok = false;
+                }
+
+                bool delivered = true;
+                if (onResult) {
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    try {
+                        onResult(result);
+                    } catch (const std::exception& e) {
+                        std::cerr << "Error: Fan-out result callback failed for target " << i << ": " << e.what() << std::endl;
+                        delivered = false;
+                    }
+                }
+                // 回调抛出异常时结果没有被处理，不计入成功数
+                if (result.ok && delivered) ++succeeded;
+            });
+        }
+        // 线程池析构时等待所有任务完成
+    }
+    return succeeded.load();
+}
@@ -0,0 +1,134 @@
+#include "MorphPlan.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+void MorphPlan::frameBasis(float t, double& t_f, Eigen::Vector2d& origin, Eigen::Vector2d& ab, Eigen::Vector2d& cb) const {
+    t_f = static_cast<double>(t);
+    if (reversed) t_f = 1.0 - t_f;
+
+    //插值旋转 B
+    double theta_t = t_f * theta;
+    Eigen::Matrix2d B_t;
+    B_t << std::cos(theta_t), -std::sin(theta_t),
+           std::sin(theta_t),  std::cos(theta_t);
+
+    //插值缩放 C 和平移 T
+    Eigen::Matrix2d C_t = t_f * C_mat;
+    Eigen::Vector2d T_t = t_f * T_vec;
+
+    //重新组合 A
+    Eigen::Matrix2d A_t = (1.0 - t_f) * Eigen::Matrix2d::Identity() + B_t * C_t;
+
+    //----- 应用变化 ----------
+    const Eigen::Vector2d a_t = A_t * basisA + T_t;
+    const Eigen::Vector2d b_t = A_t * basisB + T_t;
+    const Eigen::Vector2d c_t = A_t * basisC + T_t;
+    origin = b_t;
+    ab = a_t - b_t;
+    cb = c_t - b_t;
+}
+
+void MorphPlan::evaluate(float t, double* outXY) const {
+    if (n == 0) return;
+
+    double t_f;
+    Eigen::Vector2d b_t, ab, cb;
+    frameBasis(t, t_f, b_t, ab, cb);
+
+    for (int i = 0; i < n; ++i) {
+        Eigen::Vector2d uv_t = (1.0 - t_f) * uv1[i] + t_f * uv2[i];
+        Eigen::Map<Eigen::Vector2d>(outXY + 2 * i) = b_t + uv_t[0] * ab + uv_t[1] * cb;
+    }
+}
+
+void MorphPlan::evaluate(float t, float* outXY) const {
+    if (n == 0) return;
+
+    double t_f;
+    Eigen::Vector2d b_t, ab, cb;
+    frameBasis(t, t_f, b_t, ab, cb);
+
+    // 以双精度计算，只在写出时舍入
+    for (int i = 0; i < n; ++i) {
+        Eigen::Vector2d uv_t = (1.0 - t_f) * uv1[i] + t_f * uv2[i];
+        Eigen::Map<Eigen::Vector2f>(outXY + 2 * i) = (b_t + uv_t[0] * ab + uv_t[1] * cb).cast<float>();
+    }
+}
+
+void MorphPlan::evaluate(float t, Polygon& out) const {
+    out.externalXY = nullptr;
+    out.externalOwner.reset();
+    out.vertices.resize(n);
+    out.n = n;
+    // std::vector<Eigen::Vector2d> 的元素是连续紧密排列的两个 double
+    if (n > 0) evaluate(t, out.vertices.front().data());
+}
+
+Polygon MorphPlan::evaluate(float t) const {
+    Polygon result;
+    evaluate(t, result);
+    return result;
+}
+
+MorphPlan::Frame MorphPlan::frameAt(float t) const {
+    Frame frame;
+    frameBasis(t, frame.t_f, frame.origin, frame.ab, frame.cb);
+    return frame;
+}
+
+void MorphPlan::speedBounds(float t0, float t1, double* outSpeed, double* outAccel) const {
+    if (n == 0) return;
+
+    // 换算到插值参数 s = t_f 的区间 [sa, sb]；ds/dt = ±1，速度上界不变
+    double sa = reversed ? 1.0 - t1 : t0;
+    double sb = reversed ? 1.0 - t0 : t1;
+    if (sa > sb) std::swap(sa, sb);
+    const double smax = std::max(std::abs(sa), std::abs(sb));
+    const double angle = std::abs(theta);
+
+    // Frobenius 范数是谱范数的上界
+    const double cn = C_mat.norm();
+    const double ci = (C_mat - Eigen::Matrix2d::Identity()).norm();
+
+    // A'(s) = R C - I + s theta R' C，其中 |R(phi) - I| = 2|sin(phi / 2)| <= min(|phi|, 2)
+    const double phi = smax * angle;
+    const double aPrime = std::min(phi, 2.0) * cn + ci + phi * cn;
+    // |A(s)| <= |1 - s| + |s| |C|，在区间端点处取到最大
+    const double aNorm = std::max(std::abs(1.0 - sa) + std::abs(sa) * cn, std::abs(1.0 - sb) + std::abs(sb) * cn);
+
+    // 所有顶点共有的项 b(s) = A(s) basisB + s T：在区间中点精确求导，再用 |b''| 的上界覆盖整个区间
+    const double sm = 0.5 * (sa + sb);
+    const double c = std::cos(sm * theta);
+    const double d = std::sin(sm * theta);
+    Eigen::Matrix2d R, Rp;
+    R << c, -d, d, c;
+    Rp << -d, -c, c, -d; // R(phi + pi / 2)
+    const Eigen::Matrix2d aPrimeMid = R * C_mat - Eigen::Matrix2d::Identity() + sm * theta * Rp * C_mat;
+    // A''(s) = 2 theta R' C + s theta^2 R'' C
+    const double aSecond = (2.0 * angle + smax * angle * angle) * cn;
+    const double common = (aPrimeMid * basisB + T_vec).norm() + aSecond * basisB.norm() * 0.5 * (sb - sa);
+
+    // 每个顶点：d/ds [A r_i] = A' r_i + A r_i'，|r_i| 是 s 的凸函数，最大值在区间端点
+    const Eigen::Vector2d dA = basisA - basisB;
+    const Eigen::Vector2d dC = basisC - basisB;
+    for (int i = 0; i < n; ++i) {
+        const Eigen::Vector2d r1 = uv1[i][0] * dA + uv1[i][1] * dC;
+        const Eigen::Vector2d r2 = uv2[i][0] * dA + uv2[i][1] * dC;
+        const Eigen::Vector2d dr = r2 - r1;
+        const double reach = std::max((r1 + sa * dr).norm(), (r1 + sb * dr).norm());
+        outSpeed[i] = common + aPrime * reach + aNorm * dr.norm();
+        // p_i'' = A'' (basisB + r_i) + 2 A' r_i'（平移项对 s 线性，二阶导为零）
+        if (outAccel) {
+            const double arm = std::max((basisB + r1 + sa * dr).norm(), (basisB + r1 + sb * dr).norm());
+            outAccel[i] = aSecond * arm + 2.0 * aPrime * dr.norm();
+        }
+    }
+}
+
+double MorphPlan::maxSpeedBound(float t0, float t1) const {
+    if (n == 0) return 0.0;
+    std::vector<double> speed(n);
+    speedBounds(t0, t1, speed.data());
+    return *std::max_element(speed.begin(), speed.end());
+}
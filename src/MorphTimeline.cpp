@@ -0,0 +1,153 @@
+#include "MorphTimeline.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iostream>
+
+bool MorphTimeline::load(const std::vector<std::string>& paths,
+                         const BlendWeights& weights,
+                         const std::vector<double>& times){
+    if (paths.size() < 2) {
+        std::cerr << "Error: Timeline needs at least 2 keyframes." << std::endl;
+        return false;
+    }
+
+    // 每个关键帧只加载一次（含 precomputeIntrinsics），各文件互不依赖，并行加载
+    std::vector<Polygon> keyframes(paths.size());
+    std::vector<std::future<bool>> loads;
+    loads.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        loads.push_back(std::async(std::launch::async, [&keyframes, &paths, i]() {
+            return keyframes[i].loadFromFile(paths[i]);
+        }));
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < loads.size(); ++i) {
+        if (!loads[i].get()) {
+            std::cerr << "Failed to load keyframe " << i << ": " << paths[i] << std::endl;
+            ok = false;
+        }
+    }
+    if (!ok) return false;
+
+    return build(std::move(keyframes), weights, times);
+}
+
+bool MorphTimeline::build(std::vector<Polygon> keyframes,
+                          const BlendWeights& weights,
+                          const std::vector<double>& times){
+    m_keyframes.clear();
+    m_segments.clear();
+    m_times.clear();
+    m_bucketSegment.clear();
+
+    const size_t count = keyframes.size();
+    if (count < 2) {
+        std::cerr << "Error: Timeline needs at least 2 keyframes." << std::endl;
+        return false;
+    }
+
+    if (times.empty()) {
+        m_times.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_times[i] = static_cast<double>(i) / static_cast<double>(count - 1);
+        }
+    } else {
+        if (times.size() != count) {
+            std::cerr << "Error: Timeline has " << count << " keyframes but "
+                      << times.size() << " times." << std::endl;
+            return false;
+        }
+        for (size_t i = 1; i < count; ++i) {
+            if (!(times[i] > times[i - 1])) {
+                std::cerr << "Error: Keyframe times must be strictly increasing." << std::endl;
+                return false;
+            }
+        }
+        m_times = times;
+    }
+
+    m_keyframes = std::move(keyframes);
+
+    // 每一段只读它两端的关键帧，段与段之间没有依赖，并行求解
+    std::vector<std::future<MorphPlan>> solves;
+    solves.reserve(count - 1);
+    for (size_t i = 0; i + 1 < count; ++i) {
+        solves.push_back(std::async(std::launch::async, [this, &weights, i]() {
+            return solveMorph(m_keyframes[i], m_keyframes[i + 1], weights).plan;
+        }));
+    }
+
+    m_segments.reserve(count - 1);
+    bool ok = true;
+    for (size_t i = 0; i < solves.size(); ++i) {
+        m_segments.push_back(solves[i].get());
+        if (m_segments.back().empty()) {
+            std::cerr << "Error: Failed to solve timeline segment " << i << "." << std::endl;
+            ok = false;
+        }
+    }
+
+    buildLookup();
+    std::cout << "Timeline built: " << count << " keyframes, " << m_segments.size() << " segments." << std::endl;
+    return ok;
+}
+
+void MorphTimeline::buildLookup(){
+    const int segments = segmentCount();
+    const double span = endTime() - startTime();
+
+    double minDuration = span;
+    for (int i = 0; i < segments; ++i) {
+        minDuration = std::min(minDuration, m_times[i + 1] - m_times[i]);
+    }
+
+    // 桶宽 <= 最短段长；对极短的段设上限，避免查找表过大
+    const double wanted = std::ceil(span / minDuration);
+    const int buckets = static_cast<int>(std::clamp(wanted, static_cast<double>(segments), 65536.0));
+
+    m_bucketScale = buckets / span;
+    m_bucketSegment.resize(buckets);
+
+    int seg = 0;
+    for (int b = 0; b < buckets; ++b) {
+        const double bucketStart = startTime() + b / m_bucketScale;
+        while (seg + 1 < segments && m_times[seg + 1] <= bucketStart) ++seg;
+        m_bucketSegment[b] = seg;
+    }
+}
+
+int MorphTimeline::locate(double globalTime, double& localT) const{
+    if (m_segments.empty()) {
+        localT = 0.0;
+        return -1;
+    }
+
+    const double T = std::clamp(globalTime, startTime(), endTime());
+    const int last = static_cast<int>(m_bucketSegment.size()) - 1;
+    const int bucket = std::min(static_cast<int>((T - startTime()) * m_bucketScale), last);
+
+    int seg = m_bucketSegment[bucket];
+    while (seg + 1 < segmentCount() && m_times[seg + 1] <= T) ++seg;
+
+    localT = (T - m_times[seg]) / (m_times[seg + 1] - m_times[seg]);
+    localT = std::clamp(localT, 0.0, 1.0);
+    return seg;
+}
+
+void MorphTimeline::evaluate(double globalTime, Polygon& out) const{
+    double localT = 0.0;
+    int seg = locate(globalTime, localT);
+    if (seg < 0) {
+        out = Polygon();
+        return;
+    }
+    m_segments[seg].evaluate(static_cast<float>(localT), out);
+}
+
+Polygon MorphTimeline::evaluate(double globalTime) const{
+    Polygon result;
+    evaluate(globalTime, result);
+    return result;
+}
@@ -0,0 +1,191 @@
+#include "MorphWorker.h"
+#include "MorphDiskCache.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+
+MorphWorker::MorphWorker(){
+    m_snapshot = std::make_shared<const MorphSnapshot>();
+    m_thread = std::thread([this]() { workerLoop(); });
+}
+
+MorphWorker::~MorphWorker(){
+    stop();
+}
+
+void MorphWorker::stop(){
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        ++m_generation; // 正在运行的任务不再发布结果
+        m_progress.cancel = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void MorphWorker::submit(const MorphJob& job){
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = job;
+        m_hasPending = true;
+        ++m_generation;
+        // 正在运行的任务已经过时
+        m_progress.cancel = true;
+    }
+    m_cv.notify_one();
+}
+
+void MorphWorker::stopSearch(){
+    m_progress.cancel = true;
+}
+
+std::shared_ptr<const MorphSnapshot> MorphWorker::snapshot() const{
+    return std::atomic_load(&m_snapshot);
+}
+
+void MorphWorker::workerLoop(){
+    for (;;) {
+        MorphJob job;
+        uint64_t generation = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stopping || m_hasPending; });
+            if (m_stopping) return;
+
+            job = m_pending;
+            m_hasPending = false;
+            generation = m_generation;
+
+            // 在锁内重置，保证之后的 submit() 一定能取消这个任务
+            m_progress.reset();
+            m_progress.timeBudgetSeconds = job.searchBudgetSeconds;
+            m_busy = true;
+        }
+
+        process(job, generation);
+        m_busy = false;
+    }
+}
+
+void MorphWorker::process(const MorphJob& job, uint64_t generation){
+    // 之前的阶段没有完成（例如被取消），或者换了文件，就要从更早的阶段开始
+    int from = std::min(static_cast<int>(job.from), m_completedStage + 1);
+    if (job.pathA != m_loadedA || job.pathB != m_loadedB) from = static_cast<int>(MorphStage::Load);
+
+    if (from <= static_cast<int>(MorphStage::Load)) {
+        m_completedStage = -1;
+        if (!m_blender.loadPolygons(job.pathA, job.pathB)) {
+            std::cerr << "Error Loading polygons. Check paths." << std::endl;
+            m_loadedA.clear();
+            m_loadedB.clear();
+            if (!isStale(generation)) publish(ShapeBlender(), false, false, generation);
+            return;
+        }
+        m_loadedA = job.pathA;
+        m_loadedB = job.pathB;
+        m_fill.reset();
+        m_arapLaplacian.reset();
+        m_completedStage = static_cast<int>(MorphStage::Load);
+        if (isStale(generation)) return;
+    }
+
+    m_blender.setWeights(job.weights);
+
+    const MorphDiskCache cache(job.cacheDir);
+    if (from <= static_cast<int>(MorphStage::Correspondence)) {
+        m_completedStage = static_cast<int>(MorphStage::Load);
+
+        // 命中磁盘缓存时对应关系和仿射基都已恢复，直接发布
+        if (!job.cacheDir.empty() && cache.load(m_blender, job.manualK)) {
+            m_completedStage = static_cast<int>(MorphStage::Basis);
+            if (!isStale(generation)) publish(m_blender, true, false, generation);
+            return;
+        }
+
+        // 每找到更好的 k，就在预览副本上重走该 k 并发布临时快照
+        m_preview = m_blender;
+        m_progress.onImproved = [this, generation](int k, double) {
+            if (isStale(generation)) return;
+            m_preview.computeCorrespondence(k);
+            m_preview.findOptimalBasis();
+            publish(m_preview, true, true, generation);
+        };
+        m_blender.computeCorrespondence(job.manualK, &m_progress);
+        m_progress.onImproved = nullptr;
+
+        // 被新任务取代时放弃结果；被 stopSearch() 停止时采用已找到的最优 k
+        if (isStale(generation)) return;
+        m_completedStage = static_cast<int>(MorphStage::Correspondence);
+    }
+
+    m_blender.findOptimalBasis();
+    m_completedStage = static_cast<int>(MorphStage::Basis);
+    if (isStale(generation)) return;
+
+    // 只缓存完整搜索的结果；被 stopSearch() 或时间预算截断的结果下次应重新搜索
+    if (!job.cacheDir.empty() && from <= static_cast<int>(MorphStage::Correspondence) && !m_progress.truncated) {
+        cache.store(m_blender, job.manualK);
+    }
+
+    publish(m_blender, true, false, generation);
+}
+
+void MorphWorker::publish(const ShapeBlender& blender, bool valid, bool provisional, uint64_t generation){
+    auto snap = std::make_shared<MorphSnapshot>();
+    snap->polyA = blender.getPolyA();
+    snap->polyB = blender.getPolyB();
+    snap->correspondence = blender.getCorrespondence();
+    snap->basis = blender.getBasis();
+    snap->bestK = blender.getBestK();
+    snap->plan = blender.getPlan();
+    if (valid) {
+        snap->fill = fillFor(blender);
+        if (snap->fill) snap->arap = arapFor(blender, snap->fill);
+    }
+    snap->valid = valid;
+    snap->provisional = provisional;
+    snap->generation = generation;
+    snap->blenderBytes = blender.memoryUsage();
+    snap->scratchBytes = blender.scratchMemoryUsage();
+
+    std::atomic_store(&m_snapshot, std::shared_ptr<const MorphSnapshot>(std::move(snap)));
+    if (onPublish) onPublish();
+}
+
+std::shared_ptr<const Triangulation> MorphWorker::fillFor(const ShapeBlender& blender){
+    const MorphPlan& plan = blender.getPlan();
+    const Polygon& source = blender.getPolyA();
+    if (plan.n == 0 || source.n != plan.n) return nullptr;
+
+    if (!m_fill) {
+        auto fill = std::make_shared<Triangulation>();
+        {
+            ScopedTimer timer("triangulate");
+            if (!fill->build(source)) {
+                std::cerr << "Source polygon is not simple; filled preview disabled." << std::endl;
+            }
+        }
+        m_fill = std::move(fill);
+        m_arapLaplacian.reset();
+    }
+    // 剖分失败时也缓存下来，避免每次发布都重试
+    return m_fill->empty() ? nullptr : m_fill;
+}
+
+std::shared_ptr<const ArapInterpolator> MorphWorker::arapFor(const ShapeBlender& blender,
+                                                             const std::shared_ptr<const Triangulation>& fill){
+    if (!m_arapLaplacian) {
+        auto laplacian = std::make_shared<ArapLaplacian>();
+        if (!laplacian->build(*fill)) {
+            std::cerr << "ARAP system could not be factored; ARAP interpolation disabled." << std::endl;
+        }
+        m_arapLaplacian = std::move(laplacian);
+    }
+    // 分解失败时同样缓存下来，不再重试
+    if (m_arapLaplacian->empty()) return nullptr;
+
+    auto arap = std::make_shared<ArapInterpolator>();
+    if (!arap->build(blender.getPlan(), *fill, m_arapLaplacian)) return nullptr;
+    return arap;
+}
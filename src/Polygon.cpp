@@ -1,33 +1,125 @@
 #include "Polygon.h"
+#include "MappedFile.h"
+#include "PolygonArchive.h"
+#include "PolygonParser.h"
 #include <fstream>
 #include <iostream>
 #include <numeric>
 #include "../lib/json/nlohmann/json.hpp"
 #include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <unistd.h>
 
 //for Pi
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+namespace {
+
+/**
+ * @brief 二进制多边形文件的文件头（小端，64 字节，使其后的 double 数组保持对齐）。
+ */
+struct BinaryHeader {
+    char magic[4];          // "SBP1"
+    uint32_t version;
+    uint32_t flags;         // Polygon::kBinaryHasIntrinsics
+    uint32_t count;         // 顶点数
+    double bbox[4];         // minX, minY, maxX, maxY
+    uint8_t reserved[16];
+};
+static_assert(sizeof(BinaryHeader) == 64, "BinaryHeader must stay 64 bytes");
+
+constexpr char kBinaryMagic[4] = {'S', 'B', 'P', '1'};
+constexpr uint32_t kBinaryVersion = 1;
+constexpr int kIntrinsicArrays = 7;
+
+/**
+ * @brief 从文件中读取 count 个小端 double。
+ */
+void readDoubles(const char* src, size_t count, double* dst) {
+    std::memcpy(dst, src, count * sizeof(double));
+    if (!hostIsLittleEndian()) {
+        for (size_t i = 0; i < count; ++i) dst[i] = littleEndian(dst[i]);
+    }
+}
+
+void writeDoubles(std::ostream& os, const double* values, size_t count) {
+    if (hostIsLittleEndian()) {
+        os.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(double)));
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const double v = littleEndian(values[i]);
+        os.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+}
+
+} // namespace
+
 bool Polygon::loadFromFile(const std::string& filepath){
     vertices.clear();
+    externalXY = nullptr;
+    externalOwner.reset();
+
+    // "<归档>.sba#<名字>"：从多边形归档中加载
+    std::string archivePath, name;
+    if (PolygonArchive::splitPath(filepath, archivePath, name)) {
+        PolygonArchive archive;
+        return archive.open(archivePath) && archive.load(name, *this);
+    }
     
-    std::ifstream f(filepath);
+    std::ifstream f(filepath, std::ios::binary);
     if (!f.is_open()) {
         std::cerr << "Error: Failed to open polygon file: " << filepath << std::endl;
         return false;
     }
 
-    try{
-        nlohmann::json data = nlohmann::json::parse(f);
-        for(const auto& item : data){
-            vertices.push_back(Eigen::Vector2d(item[0].get<double>(), item[1].get<double>()));
-        }
-    } catch(nlohmann::json::parse_error& e){
-        std::cerr << "Error: Failed to parse JSON file: " << filepath << "\n" << e.what() << std::endl;
+    char magic[sizeof(kBinaryMagic)] = {};
+    if (f.read(magic, sizeof(magic)) && std::memcmp(magic, kBinaryMagic, sizeof(magic)) == 0) {
+        f.close();
+        return loadBinary(filepath);
+    }
+    f.clear();
+
+    // 整个文件读入一块缓冲区，交给专用解析器直接填充 vertices
+    f.seekg(0, std::ios::end);
+    const std::streamoff fileSize = f.tellg();
+    f.seekg(0, std::ios::beg);
+    std::string text(fileSize > 0 ? static_cast<size_t>(fileSize) : 0, '\0');
+    if (!f.read(text.data(), static_cast<std::streamsize>(text.size()))) {
+        std::cerr << "Error: Failed to read polygon file: " << filepath << std::endl;
         return false;
     }
 
+    PolygonParseError error;
+    switch (parsePolygonJson(text.data(), text.size(), vertices, error)) {
+        case PolygonParseStatus::Ok:
+            break;
+        case PolygonParseStatus::Error:
+            vertices.clear();
+            std::cerr << "Error: Failed to parse JSON file: " << filepath << ":" << error.line << ":" << error.column
+                      << ": " << error.message << std::endl;
+            return false;
+        case PolygonParseStatus::Unsupported:
+            // 格式外的输入（对象、多余的坐标、BOM 等）交给通用 JSON 解析器
+            vertices.clear();
+            try{
+                nlohmann::json data = nlohmann::json::parse(text);
+                for(const auto& item : data){
+                    vertices.push_back(Eigen::Vector2d(item.at(0).get<double>(), item.at(1).get<double>()));
+                }
+            } catch(nlohmann::json::exception& e){
+                vertices.clear();
+                std::cerr << "Error: Failed to parse JSON file: " << filepath << "\n" << e.what() << std::endl;
+                return false;
+            }
+            break;
+    }
+
     n = vertices.size();
     if(n < 3){
         std::cerr << "Error: Polygon must have at least 3 vertices." << std::endl;
@@ -39,6 +131,174 @@ bool Polygon::loadFromFile(const std::string& filepath){
 
 }
 
+bool Polygon::loadBinary(const std::string& filepath){
+    vertices.clear();
+    externalXY = nullptr;
+    externalOwner.reset();
+    n = 0;
+
+    std::string error;
+    std::shared_ptr<const MappedFile> file = MappedFile::open(filepath, &error);
+    if (!file) {
+        std::cerr << "Error: Failed to open polygon file: " << filepath << " (" << error << ")" << std::endl;
+        return false;
+    }
+    return loadBinaryImage(file->data(), file->size(), file, filepath);
+}
+
+bool Polygon::loadBinaryImage(const char* data, size_t size, std::shared_ptr<const void> owner, const std::string& source){
+    vertices.clear();
+    externalXY = nullptr;
+    externalOwner.reset();
+    n = 0;
+
+    BinaryHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "Error: Truncated polygon file: " << source << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    const uint32_t version = littleEndian(header.version);
+    const uint32_t flags = littleEndian(header.flags);
+    const size_t count = littleEndian(header.count);
+    if (std::memcmp(header.magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0 || version != kBinaryVersion) {
+        std::cerr << "Error: Unsupported polygon file format or version: " << source << std::endl;
+        return false;
+    }
+    if (count < 3 || count > static_cast<size_t>(INT_MAX)) {
+        std::cerr << "Error: Polygon must have at least 3 vertices." << std::endl;
+        return false;
+    }
+
+    const bool hasIntrinsics = (flags & kBinaryHasIntrinsics) != 0;
+    const size_t expectedSize = sizeof(header) + count * sizeof(double) * (2 + (hasIntrinsics ? kIntrinsicArrays : 0));
+    if (size != expectedSize) {
+        std::cerr << "Error: Polygon file has " << size << " bytes, expected " << expectedSize << ": " << source << std::endl;
+        return false;
+    }
+
+    const char* payload = data + sizeof(header);
+    n = static_cast<int>(count);
+    if (hostIsLittleEndian() && owner && reinterpret_cast<uintptr_t>(payload) % alignof(double) == 0) {
+        // 映射是页对齐的，文件头为 64 字节，顶点数组可以原地使用
+        externalXY = reinterpret_cast<const double*>(payload);
+        externalOwner = std::move(owner);
+    } else {
+        vertices.resize(count);
+        readDoubles(payload, 2 * count, vertices.front().data());
+    }
+
+    if (!hasIntrinsics) {
+        precomputeIntrinsics();
+        return true;
+    }
+
+    const char* arrays = payload + 2 * count * sizeof(double);
+    for (std::vector<double>* v : {&edge_e0_lengths, &edge_e1_lengths, &edge_e2_lengths,
+                                   &angles_curr, &angles_prev, &angles_next, &cornerTriangle_areas}) {
+        v->resize(count);
+        readDoubles(arrays, count, v->data());
+        arrays += count * sizeof(double);
+    }
+
+    // 总面积只需要一次鞋带公式，不需要三角函数
+    computeAreaAndWinding();
+    return true;
+}
+
+bool Polygon::saveBinary(const std::string& filepath, bool withIntrinsics) const{
+    // 已加载的多边形可能正借用旧文件的映射：先写临时文件再改名，旧的映射保持不变
+    const std::string tmp = filepath + ".tmp" + std::to_string(getpid()) + "." +
+                            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::error_code ec;
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        if (!f.is_open() || !writeBinary(f, withIntrinsics) || !f.flush()) {
+            std::cerr << "Error: Failed to write polygon file: " << filepath << std::endl;
+            f.close();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, filepath, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to write polygon file " << filepath << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool Polygon::writeBinary(std::ostream& os, bool withIntrinsics) const{
+    if (n < 3) {
+        std::cerr << "Error: Polygon must have at least 3 vertices." << std::endl;
+        return false;
+    }
+    if (withIntrinsics && edge_e0_lengths.size() != static_cast<size_t>(n)) {
+        // 例如 MorphPlan::evaluate() 输出的帧只有顶点
+        Polygon copy = *this;
+        copy.precomputeIntrinsics();
+        return copy.writeBinary(os, true);
+    }
+
+    BinaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    header.version = littleEndian(kBinaryVersion);
+    header.flags = littleEndian(withIntrinsics ? kBinaryHasIntrinsics : 0u);
+    header.count = littleEndian(static_cast<uint32_t>(n));
+
+    double bbox[4] = {vertex(0).x(), vertex(0).y(), vertex(0).x(), vertex(0).y()};
+    std::vector<double> xy(2 * static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        xy[2 * i] = vertex(i).x();
+        xy[2 * i + 1] = vertex(i).y();
+        bbox[0] = std::min(bbox[0], xy[2 * i]);
+        bbox[1] = std::min(bbox[1], xy[2 * i + 1]);
+        bbox[2] = std::max(bbox[2], xy[2 * i]);
+        bbox[3] = std::max(bbox[3], xy[2 * i + 1]);
+    }
+    for (int k = 0; k < 4; ++k) header.bbox[k] = littleEndian(bbox[k]);
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeDoubles(os, xy.data(), xy.size());
+    if (withIntrinsics) {
+        for (const std::vector<double>* v : {&edge_e0_lengths, &edge_e1_lengths, &edge_e2_lengths,
+                                             &angles_curr, &angles_prev, &angles_next, &cornerTriangle_areas}) {
+            writeDoubles(os, v->data(), v->size());
+        }
+    }
+    return static_cast<bool>(os);
+}
+
+bool Polygon::borrowVertices(const double* xy, size_t count){
+    vertices.clear();
+    externalXY = xy;
+    externalOwner.reset();
+    n = static_cast<int>(count);
+    if(n < 3 || xy == nullptr){
+        std::cerr << "Error: Polygon must have at least 3 vertices." << std::endl;
+        return false;
+    }
+
+    precomputeIntrinsics();
+    return true;
+}
+
+void Polygon::reverse(){
+    if(externalXY){
+        vertices.resize(n);
+        for(int i = 0; i < n; ++i){
+            vertices[i] = vertex(n - 1 - i);
+        }
+        externalXY = nullptr;
+        externalOwner.reset();
+    }else{
+        std::reverse(vertices.begin(), vertices.end());
+    }
+    precomputeIntrinsics();
+}
+
 std::array<double, 3> Polygon::computeTriangleAngles(
     const Eigen::Vector2d& p1, 
     const Eigen::Vector2d& p2, 
@@ -82,13 +342,11 @@ void Polygon::precomputeIntrinsics(){
     angles_next.resize(n);
     cornerTriangle_areas.resize(n);
 
-    totalArea = 0.0;
-
    for (int i = 0; i < n; ++i) {
         //获取顶点
-        const auto& v_prev = vertices[get_prev_idx(i)];
-        const auto& v_curr = vertices[i];
-        const auto& v_next = vertices[get_next_idx(i)];
+        const Eigen::Vector2d v_prev = vertex(get_prev_idx(i));
+        const Eigen::Vector2d v_curr = vertex(i);
+        const Eigen::Vector2d v_next = vertex(get_next_idx(i));
 
         edge_e1_lengths[i] = (v_curr - v_prev).norm(); // e1 (prev -> curr)
         edge_e2_lengths[i] = (v_next - v_curr).norm(); // e2 (curr -> next)
@@ -108,14 +366,25 @@ void Polygon::precomputeIntrinsics(){
     }
 
     //用鞋带公式，计算多边形的总面积
-     for (int i = 0; i < n; ++i)
-     {
-        const auto& p1 = vertices[i];
-        const auto& p2 = vertices[get_next_idx(i)];
-        totalArea+= (p1.x() * p2.y() - p1.y() * p2.x());
-     }
-
-     signFlag = (totalArea < 0) ? -1 : 1;
-     totalArea = 0.5 * std::abs(totalArea);
-     
-}
\ No newline at end of file
+    computeAreaAndWinding();
+}
+
+void Polygon::computeAreaAndWinding(){
+    double signedArea = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const auto p1 = vertex(i);
+        const auto p2 = vertex(get_next_idx(i));
+        signedArea += (p1.x() * p2.y() - p1.y() * p2.x());
+    }
+    signFlag = signedArea >= 0;
+    totalArea = 0.5 * std::abs(signedArea);
+}
+
+size_t Polygon::memoryUsage() const{
+    size_t bytes = vertices.capacity() * sizeof(Eigen::Vector2d);
+    for (const auto* v : {&edge_e1_lengths, &edge_e2_lengths, &edge_e0_lengths,
+                          &angles_curr, &angles_prev, &angles_next, &cornerTriangle_areas}) {
+        bytes += v->capacity() * sizeof(double);
+    }
+    return bytes;
+}
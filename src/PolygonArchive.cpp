@@ -0,0 +1,323 @@
+#include "PolygonArchive.h"
+#include "MorphCache.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+struct ArchiveHeader {
+    char magic[4];          // "SBA1"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t bucketCount;   // 2 的幂
+    uint64_t entriesOffset;
+    uint64_t bucketsOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(ArchiveHeader) == 64, "ArchiveHeader must stay 64 bytes");
+
+struct ArchiveEntry {
+    uint64_t nameHash;
+    uint64_t contentHash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t vertexCount;
+    uint32_t next;          // 同一桶中的下一个条目，kNoEntry 表示链表结束
+};
+static_assert(sizeof(ArchiveEntry) == 48, "ArchiveEntry must stay 48 bytes");
+
+constexpr char kArchiveMagic[4] = {'S', 'B', 'A', '1'};
+constexpr uint32_t kArchiveVersion = 1;
+constexpr uint32_t kNoEntry = 0xFFFFFFFFu;
+
+uint64_t hashName(std::string_view name) {
+    uint64_t hash = 1469598103934665603ull;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+ArchiveEntry readEntry(const char* data) {
+    ArchiveEntry e;
+    std::memcpy(&e, data, sizeof(e));
+    e.nameHash = littleEndian(e.nameHash);
+    e.contentHash = littleEndian(e.contentHash);
+    e.offset = littleEndian(e.offset);
+    e.size = littleEndian(e.size);
+    e.nameOffset = littleEndian(e.nameOffset);
+    e.nameLength = littleEndian(e.nameLength);
+    e.vertexCount = littleEndian(e.vertexCount);
+    e.next = littleEndian(e.next);
+    return e;
+}
+
+template <typename T>
+void put(std::ostream& os, T value) {
+    value = littleEndian(value);
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+bool PolygonArchive::open(const std::string& path){
+    m_file.reset();
+    m_entryCount = 0;
+    m_path = path;
+
+    std::string error;
+    std::shared_ptr<const MappedFile> file = MappedFile::open(path, &error);
+    if (!file) {
+        std::cerr << "Error: Failed to open polygon archive: " << path << " (" << error << ")" << std::endl;
+        return false;
+    }
+
+    ArchiveHeader header;
+    if (file->size() < sizeof(header)) {
+        std::cerr << "Error: Truncated polygon archive: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kArchiveMagic, sizeof(kArchiveMagic)) != 0 || littleEndian(header.version) != kArchiveVersion) {
+        std::cerr << "Error: Unsupported polygon archive format or version: " << path << std::endl;
+        return false;
+    }
+
+    const size_t entryCount = littleEndian(header.entryCount);
+    const size_t bucketCount = littleEndian(header.bucketCount);
+    const uint64_t entriesOffset = littleEndian(header.entriesOffset);
+    const uint64_t bucketsOffset = littleEndian(header.bucketsOffset);
+    const uint64_t namesOffset = littleEndian(header.namesOffset);
+    const uint64_t namesSize = littleEndian(header.namesSize);
+
+    // 只检查各段都在文件内；条目本身在使用时才检查，打开的代价与条目数无关
+    auto inside = [&file](uint64_t offset, uint64_t size) { return offset <= file->size() && size <= file->size() - offset; };
+    if (bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0
+        || !inside(entriesOffset, static_cast<uint64_t>(entryCount) * sizeof(ArchiveEntry))
+        || !inside(bucketsOffset, static_cast<uint64_t>(bucketCount) * sizeof(uint32_t))
+        || !inside(namesOffset, namesSize)) {
+        std::cerr << "Error: Corrupt polygon archive table of contents: " << path << std::endl;
+        return false;
+    }
+
+    m_file = std::move(file);
+    m_entryCount = entryCount;
+    m_bucketCount = bucketCount;
+    m_entries = m_file->data() + entriesOffset;
+    m_buckets = m_file->data() + bucketsOffset;
+    m_names = m_file->data() + namesOffset;
+    m_namesSize = static_cast<size_t>(namesSize);
+    return true;
+}
+
+PolygonArchive::Entry PolygonArchive::entry(size_t index) const{
+    Entry result;
+    if (index >= m_entryCount) return result;
+
+    const ArchiveEntry e = readEntry(m_entries + index * sizeof(ArchiveEntry));
+    if (e.nameOffset <= m_namesSize && e.nameLength <= m_namesSize - e.nameOffset) {
+        result.name = std::string_view(m_names + e.nameOffset, e.nameLength);
+    }
+    result.contentHash = e.contentHash;
+    result.vertexCount = e.vertexCount;
+    result.offset = e.offset;
+    result.size = e.size;
+    return result;
+}
+
+long PolygonArchive::find(std::string_view name) const{
+    if (m_entryCount == 0) return -1;
+
+    const uint64_t nameHash = hashName(name);
+    uint32_t index;
+    std::memcpy(&index, m_buckets + (nameHash & (m_bucketCount - 1)) * sizeof(uint32_t), sizeof(index));
+    index = littleEndian(index);
+
+    // 链表长度不会超过条目数；超过说明文件损坏成了环
+    for (size_t steps = 0; index != kNoEntry && index < m_entryCount && steps < m_entryCount; ++steps) {
+        const ArchiveEntry e = readEntry(m_entries + static_cast<size_t>(index) * sizeof(ArchiveEntry));
+        if (e.nameHash == nameHash && e.nameLength == name.size() && e.nameOffset <= m_namesSize
+            && e.nameLength <= m_namesSize - e.nameOffset && std::memcmp(m_names + e.nameOffset, name.data(), name.size()) == 0) {
+            return static_cast<long>(index);
+        }
+        index = e.next;
+    }
+    return -1;
+}
+
+bool PolygonArchive::load(size_t index, Polygon& out) const{
+    if (!m_file || index >= m_entryCount) {
+        std::cerr << "Error: Polygon archive entry " << index << " out of range: " << m_path << std::endl;
+        return false;
+    }
+    const Entry e = entry(index);
+    if (e.offset > m_file->size() || e.size > m_file->size() - e.offset) {
+        std::cerr << "Error: Corrupt polygon archive entry " << index << ": " << m_path << std::endl;
+        return false;
+    }
+    return out.loadBinaryImage(m_file->data() + e.offset, static_cast<size_t>(e.size), m_file,
+                               m_path + "#" + std::string(e.name));
+}
+
+bool PolygonArchive::load(std::string_view name, Polygon& out) const{
+    const long index = find(name);
+    if (index < 0) {
+        std::cerr << "Error: Polygon " << name << " not found in archive " << m_path << std::endl;
+        return false;
+    }
+    return load(static_cast<size_t>(index), out);
+}
+
+bool PolygonArchive::splitPath(const std::string& path, std::string& archivePath, std::string& name){
+    const size_t hash = path.rfind(".sba#");
+    if (hash == std::string::npos) return false;
+    archivePath = path.substr(0, hash + 4);
+    name = path.substr(hash + 5);
+    return true;
+}
+
+bool PolygonArchive::build(const std::vector<std::pair<std::string, std::string>>& inputs, const std::string& outPath,
+                           unsigned threadCount, bool withIntrinsics){
+    {
+        std::unordered_set<std::string> seen;
+        for (const auto& [name, path] : inputs) {
+            if (!seen.insert(name).second) {
+                std::cerr << "Error: Duplicate polygon name in archive: " << name << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // 1. 并行加载并编码每个多边形
+    struct Encoded {
+        std::string image;
+        uint64_t contentHash = 0;
+        uint32_t vertexCount = 0;
+        bool ok = false;
+    };
+    std::vector<Encoded> encoded(inputs.size());
+    {
+        std::atomic<size_t> next{0};
+        ThreadPool pool(threadCount);
+        for (unsigned w = 0; w < pool.size(); ++w) {
+            pool.submit([&]() {
+                Polygon poly;
+                for (size_t i = next++; i < inputs.size(); i = next++) {
+                    if (!poly.loadFromFile(inputs[i].second)) continue;
+                    std::ostringstream image;
+                    if (!poly.writeBinary(image, withIntrinsics)) continue;
+                    encoded[i].image = image.str();
+                    encoded[i].contentHash = hashPolygon(poly);
+                    encoded[i].vertexCount = static_cast<uint32_t>(poly.n);
+                    encoded[i].ok = true;
+                }
+            });
+        }
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!encoded[i].ok) {
+            std::cerr << "Error: Failed to pack " << inputs[i].second << std::endl;
+            return false;
+        }
+    }
+
+    // 2. 布局：目录和桶紧跟文件头，数据从下一页开始，每个多边形按页对齐
+    const uint32_t entryCount = static_cast<uint32_t>(inputs.size());
+    uint32_t bucketCount = 1;
+    while (bucketCount < 2 * entryCount) bucketCount <<= 1;
+
+    std::vector<ArchiveEntry> entries(entryCount);
+    std::vector<uint32_t> buckets(bucketCount, kNoEntry);
+    std::string names;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        ArchiveEntry& e = entries[i];
+        const std::string& name = inputs[i].first;
+        e.nameHash = hashName(name);
+        e.contentHash = encoded[i].contentHash;
+        e.nameOffset = static_cast<uint32_t>(names.size());
+        e.nameLength = static_cast<uint32_t>(name.size());
+        e.vertexCount = encoded[i].vertexCount;
+        names += name;
+
+        uint32_t& head = buckets[e.nameHash & (bucketCount - 1)];
+        e.next = head;
+        head = i;
+    }
+
+    const uint64_t entriesOffset = sizeof(ArchiveHeader);
+    const uint64_t bucketsOffset = entriesOffset + static_cast<uint64_t>(entryCount) * sizeof(ArchiveEntry);
+    const uint64_t namesOffset = bucketsOffset + static_cast<uint64_t>(bucketCount) * sizeof(uint32_t);
+    size_t offset = alignUp(static_cast<size_t>(namesOffset + names.size()), kPageSize);
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        entries[i].offset = offset;
+        entries[i].size = encoded[i].image.size();
+        offset = alignUp(offset + encoded[i].image.size(), kPageSize);
+    }
+
+    // 3. 写出（先写临时文件再改名，读者不会看到写了一半的归档）
+    const std::string tmp = outPath + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        if (!f.is_open()) {
+            std::cerr << "Error: Failed to write polygon archive: " << tmp << std::endl;
+            return false;
+        }
+        f.write(kArchiveMagic, sizeof(kArchiveMagic));
+        put(f, kArchiveVersion);
+        put(f, entryCount);
+        put(f, bucketCount);
+        put(f, entriesOffset);
+        put(f, bucketsOffset);
+        put(f, namesOffset);
+        put(f, static_cast<uint64_t>(names.size()));
+        const uint8_t reserved[sizeof(ArchiveHeader::reserved)] = {};
+        f.write(reinterpret_cast<const char*>(reserved), sizeof(reserved));
+        for (const ArchiveEntry& e : entries) {
+            put(f, e.nameHash);
+            put(f, e.contentHash);
+            put(f, e.offset);
+            put(f, e.size);
+            put(f, e.nameOffset);
+            put(f, e.nameLength);
+            put(f, e.vertexCount);
+            put(f, e.next);
+        }
+        for (uint32_t b : buckets) put(f, b);
+        f.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        const std::string padding(kPageSize, '\0');
+        size_t written = static_cast<size_t>(namesOffset + names.size());
+        for (uint32_t i = 0; i < entryCount; ++i) {
+            f.write(padding.data(), static_cast<std::streamsize>(entries[i].offset - written));
+            f.write(encoded[i].image.data(), static_cast<std::streamsize>(encoded[i].image.size()));
+            written = static_cast<size_t>(entries[i].offset + entries[i].size);
+        }
+        if (!f) {
+            std::cerr << "Error: Failed to write polygon archive: " << tmp << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, outPath, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to write polygon archive " << outPath << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,154 @@
+#include "PolygonParser.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline void skipWhitespace(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+}
+
+/**
+ * @brief c 能否开始一个 JSON 值（数组和数字之外的对象、字符串、true/false/null）。
+ */
+inline bool startsOtherValue(char c) {
+    return c == '{' || c == '"' || c == 't' || c == 'f' || c == 'n';
+}
+
+enum class NumberResult { Ok, Invalid, OutOfRange };
+
+/**
+ * @brief 按 JSON 的数字语法读取一个数：-?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+NumberResult parseNumber(const char*& p, const char* end, double& value) {
+    const char* start = p;
+    const char* q = p;
+    if (q < end && *q == '-') ++q;
+    if (q == end || !isDigit(*q)) return NumberResult::Invalid;
+    if (*q == '0') ++q;
+    else while (q < end && isDigit(*q)) ++q;
+    if (q < end && *q == '.') {
+        ++q;
+        if (q == end || !isDigit(*q)) return NumberResult::Invalid;
+        while (q < end && isDigit(*q)) ++q;
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        ++q;
+        if (q < end && (*q == '+' || *q == '-')) ++q;
+        if (q == end || !isDigit(*q)) return NumberResult::Invalid;
+        while (q < end && isDigit(*q)) ++q;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result result = std::from_chars(start, q, value);
+    if (result.ec == std::errc::result_out_of_range) return NumberResult::OutOfRange;
+    if (result.ec != std::errc() || result.ptr != q) return NumberResult::Invalid;
+#else
+    // 标准库没有浮点 from_chars 时退回 strtod（需要以 '\0' 结尾的副本）
+    char buffer[64];
+    const size_t length = static_cast<size_t>(q - start);
+    if (length >= sizeof(buffer)) return NumberResult::OutOfRange;
+    std::memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    char* parsedEnd = nullptr;
+    value = std::strtod(buffer, &parsedEnd);
+    if (parsedEnd != buffer + length) return NumberResult::Invalid;
+    if (value == HUGE_VAL || value == -HUGE_VAL) return NumberResult::OutOfRange;
+#endif
+    p = q;
+    return NumberResult::Ok;
+}
+
+} // namespace
+
+PolygonParseStatus parsePolygonJson(const char* data, size_t size, std::vector<Eigen::Vector2d>& out,
+                                    PolygonParseError& error){
+    const char* p = data;
+    const char* end = data + size;
+
+    // 行列号只在出错时才计算
+    auto fail = [&](const char* at, const char* message) {
+        error.offset = static_cast<size_t>(at - data);
+        error.line = 1 + static_cast<size_t>(std::count(data, at, '\n'));
+        const char* lineStart = at;
+        while (lineStart > data && lineStart[-1] != '\n') --lineStart;
+        error.column = static_cast<size_t>(at - lineStart) + 1;
+        error.message = message;
+        return PolygonParseStatus::Error;
+    };
+    auto unexpected = [&](const char* expected) {
+        if (p == end) return fail(p, "unexpected end of input");
+        if (startsOtherValue(*p)) return PolygonParseStatus::Unsupported;
+        return fail(p, expected);
+    };
+    auto readNumber = [&](double& value) {
+        skipWhitespace(p, end);
+        switch (parseNumber(p, end, value)) {
+            case NumberResult::Ok: return PolygonParseStatus::Ok;
+            case NumberResult::OutOfRange: return PolygonParseStatus::Unsupported;
+            default: break;
+        }
+        if (p < end && *p == '[') return PolygonParseStatus::Unsupported;
+        return unexpected("expected a number");
+    };
+
+    out.clear();
+    // 预扫描：严格格式下每个顶点恰好一个 '['，外层数组再多一个
+    const size_t brackets = static_cast<size_t>(std::count(data, end, '['));
+    out.reserve(brackets > 0 ? brackets - 1 : 0);
+
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) return PolygonParseStatus::Unsupported; // UTF-8 BOM
+
+    skipWhitespace(p, end);
+    if (p == end || *p != '[') return unexpected("expected '['");
+    ++p;
+    skipWhitespace(p, end);
+
+    if (p < end && *p == ']') {
+        ++p;
+    } else {
+        while (true) {
+            skipWhitespace(p, end);
+            if (p == end || *p != '[') return unexpected("expected '['");
+            ++p;
+
+            double x = 0.0;
+            double y = 0.0;
+            PolygonParseStatus status = readNumber(x);
+            if (status != PolygonParseStatus::Ok) return status;
+            skipWhitespace(p, end);
+            if (p == end || *p != ',') return unexpected("expected ',' between x and y");
+            ++p;
+            status = readNumber(y);
+            if (status != PolygonParseStatus::Ok) return status;
+
+            skipWhitespace(p, end);
+            if (p < end && *p == ',') return PolygonParseStatus::Unsupported; // 多于两个坐标
+            if (p == end || *p != ']') return unexpected("expected ']' after y");
+            ++p;
+            out.emplace_back(x, y);
+
+            skipWhitespace(p, end);
+            if (p < end && *p == ',') {
+                ++p;
+                continue;
+            }
+            if (p < end && *p == ']') {
+                ++p;
+                break;
+            }
+            return unexpected("expected ',' or ']'");
+        }
+    }
+
+    skipWhitespace(p, end);
+    if (p != end) return fail(p, "unexpected characters after the vertex array");
+    return PolygonParseStatus::Ok;
+}
@@ -0,0 +1,81 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <iomanip>
+
+Profiler& Profiler::instance(){
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::record(const std::string& stage, double ms){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Series& series = m_series[stage];
+    if (series.ring.empty()) {
+        series.ring.assign(kHistorySize, 0.0f);
+        series.stats.name = stage;
+    }
+
+    series.ring[series.head] = static_cast<float>(ms);
+    series.head = (series.head + 1) % kHistorySize;
+
+    series.stats.lastMs = ms;
+    series.stats.totalMs += ms;
+    series.stats.maxMs = std::max(series.stats.maxMs, ms);
+    series.stats.count++;
+}
+
+Profiler::Stage Profiler::toStage(const Series& series) const{
+    Stage stage = series.stats;
+    // 把环形缓冲区展开成按时间顺序的数组（不足 kHistorySize 时只取已有的部分）
+    int filled = static_cast<int>(std::min<long long>(series.stats.count, kHistorySize));
+    stage.history.resize(filled);
+    int start = (series.head - filled + kHistorySize) % kHistorySize;
+    for (int i = 0; i < filled; ++i) {
+        stage.history[i] = series.ring[(start + i) % kHistorySize];
+    }
+    return stage;
+}
+
+Profiler::Stage Profiler::stage(const std::string& name) const{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_series.find(name);
+    if (it == m_series.end()) {
+        Stage empty;
+        empty.name = name;
+        return empty;
+    }
+    return toStage(it->second);
+}
+
+std::vector<Profiler::Stage> Profiler::stages() const{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Stage> result;
+    result.reserve(m_series.size());
+    for (const auto& [name, series] : m_series) {
+        result.push_back(toStage(series));
+    }
+    return result;
+}
+
+void Profiler::reset(){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_series.clear();
+}
+
+void Profiler::report(std::ostream& os) const{
+    std::vector<Stage> all = stages();
+    os << std::left << std::setw(16) << "stage"
+       << std::right << std::setw(10) << "count"
+       << std::setw(14) << "total(ms)"
+       << std::setw(12) << "avg(ms)"
+       << std::setw(12) << "max(ms)" << "\n";
+    os << std::fixed << std::setprecision(3);
+    for (const auto& stage : all) {
+        os << std::left << std::setw(16) << stage.name
+           << std::right << std::setw(10) << stage.count
+           << std::setw(14) << stage.totalMs
+           << std::setw(12) << stage.averageMs()
+           << std::setw(12) << stage.maxMs << "\n";
+    }
+    os << std::defaultfloat;
+}
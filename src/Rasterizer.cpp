@@ -0,0 +1,416 @@
+#include "Rasterizer.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+// --- PNG 所需的校验和 ---
+
+/**
+ * @brief CRC-32 的 slicing-by-8 查找表：每次处理 8 个字节，比逐字节查表快数倍。
+ */
+const std::array<std::array<uint32_t, 256>, 8>& crcTables() {
+    static const auto tables = []() {
+        std::array<std::array<uint32_t, 256>, 8> t{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[0][n] = c;
+        }
+        for (uint32_t n = 0; n < 256; ++n) {
+            for (int s = 1; s < 8; ++s) t[s][n] = t[0][t[s - 1][n] & 0xFF] ^ (t[s - 1][n] >> 8);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+    const auto& t = crcTables();
+    for (; size >= 8; data += 8, size -= 8) {
+        const uint32_t low = crc ^ (data[0] | data[1] << 8 | data[2] << 16 | static_cast<uint32_t>(data[3]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+            ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; size > 0; ++data, --size) crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+void putBigEndian(std::string& out, uint32_t value) {
+    out.push_back(static_cast<char>(value >> 24));
+    out.push_back(static_cast<char>(value >> 16));
+    out.push_back(static_cast<char>(value >> 8));
+    out.push_back(static_cast<char>(value));
+}
+
+void writeChunk(std::ofstream& f, const char type[4], const std::string& data) {
+    std::string header;
+    putBigEndian(header, static_cast<uint32_t>(data.size()));
+    header.append(type, 4);
+    uint32_t crc = crc32Update(0xFFFFFFFFu, reinterpret_cast<const uint8_t*>(type), 4);
+    crc = crc32Update(crc, reinterpret_cast<const uint8_t*>(data.data()), data.size()) ^ 0xFFFFFFFFu;
+    std::string trailer;
+    putBigEndian(trailer, crc);
+    f.write(header.data(), static_cast<std::streamsize>(header.size()));
+    f.write(data.data(), static_cast<std::streamsize>(data.size()));
+    f.write(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+}
+
+/**
+ * @brief 合成到背景上：a 为 [0, 1] 的覆盖率。
+ */
+inline uint8_t blend(uint8_t background, uint8_t fill, float a) {
+    return static_cast<uint8_t>(background + (static_cast<float>(fill) - background) * a + 0.5f);
+}
+
+} // namespace
+
+bool RasterImage::writePpm(const std::string& path) const{
+    std::ofstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        std::cerr << "Error: Failed to write image: " << path << std::endl;
+        return false;
+    }
+    f << "P6\n" << width << " " << height << "\n255\n";
+    std::string rgb(3 * static_cast<size_t>(width) * static_cast<size_t>(height), '\0');
+    for (size_t p = 0, count = static_cast<size_t>(width) * height; p < count; ++p) {
+        rgb[3 * p] = static_cast<char>(rgba[4 * p]);
+        rgb[3 * p + 1] = static_cast<char>(rgba[4 * p + 1]);
+        rgb[3 * p + 2] = static_cast<char>(rgba[4 * p + 2]);
+    }
+    f.write(rgb.data(), static_cast<std::streamsize>(rgb.size()));
+    if (!f) {
+        std::cerr << "Error: Failed to write image: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RasterImage::writePng(const std::string& path) const{
+    std::ofstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        std::cerr << "Error: Failed to write image: " << path << std::endl;
+        return false;
+    }
+
+    std::string ihdr;
+    putBigEndian(ihdr, static_cast<uint32_t>(width));
+    putBigEndian(ihdr, static_cast<uint32_t>(height));
+    ihdr += std::string("\x08\x06\x00\x00\x00", 5); // 8 位 RGBA，无隔行
+
+    // 每行前加一个过滤类型字节 (0 = None)，整体作为 zlib 流的原始数据
+    const size_t rowBytes = 4 * static_cast<size_t>(width);
+    const size_t rawSize = (rowBytes + 1) * static_cast<size_t>(height);
+    std::string idat;
+    idat.reserve(2 + rawSize + 5 * (rawSize / 65535 + 1) + 4);
+    idat += "\x78\x01";
+
+    uint32_t adlerA = 1, adlerB = 0;
+    size_t blockLeft = 0;
+    size_t remaining = rawSize;
+    auto append = [&](const uint8_t* data, size_t size) {
+        while (size > 0) {
+            if (blockLeft == 0) {
+                // 新的 stored 块：BFINAL/BTYPE 字节，LEN 和 NLEN（小端）
+                blockLeft = std::min<size_t>(65535, remaining);
+                remaining -= blockLeft;
+                idat.push_back(remaining == 0 ? 1 : 0);
+                const uint16_t len = static_cast<uint16_t>(blockLeft);
+                idat.push_back(static_cast<char>(len & 0xFF));
+                idat.push_back(static_cast<char>(len >> 8));
+                idat.push_back(static_cast<char>(~len & 0xFF));
+                idat.push_back(static_cast<char>((~len >> 8) & 0xFF));
+            }
+            const size_t count = std::min(size, blockLeft);
+            idat.append(reinterpret_cast<const char*>(data), count);
+            // Adler-32：每 5552 字节才取一次模，期间的累加不会溢出 32 位
+            for (size_t done = 0; done < count;) {
+                const size_t run = std::min<size_t>(5552, count - done);
+                for (size_t i = 0; i < run; ++i) {
+                    adlerA += data[done + i];
+                    adlerB += adlerA;
+                }
+                adlerA %= 65521;
+                adlerB %= 65521;
+                done += run;
+            }
+            data += count;
+            size -= count;
+            blockLeft -= count;
+        }
+    };
+    const uint8_t filter = 0;
+    for (int y = 0; y < height; ++y) {
+        append(&filter, 1);
+        append(rgba.data() + rowBytes * y, rowBytes);
+    }
+    putBigEndian(idat, (adlerB << 16) | adlerA);
+
+    f.write("\x89PNG\r\n\x1a\n", 8);
+    writeChunk(f, "IHDR", ihdr);
+    writeChunk(f, "IDAT", idat);
+    writeChunk(f, "IEND", std::string());
+    if (!f) {
+        std::cerr << "Error: Failed to write image: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+RasterTransform RasterTransform::fit(double minX, double minY, double maxX, double maxY, int width, int height,
+                                     double margin){
+    RasterTransform transform;
+    const double w = std::max(maxX - minX, 1e-12);
+    const double h = std::max(maxY - minY, 1e-12);
+    transform.scale = std::min(width * (1.0 - 2.0 * margin) / w, height * (1.0 - 2.0 * margin) / h);
+    transform.offsetX = 0.5 * width - transform.scale * 0.5 * (minX + maxX);
+    transform.offsetY = 0.5 * height - transform.scale * 0.5 * (minY + maxY);
+    return transform;
+}
+
+void Rasterizer::render(const double* xy, int n, const RasterTransform& transform, const RasterOptions& options,
+                        RasterImage& out, ThreadPool* pool){
+    out.resize(options.width, options.height);
+
+    // 变换到像素空间并建立边表；水平边对奇偶规则没有贡献，直接丢弃
+    m_edges.clear();
+    bool finite = true;
+    for (int i = 0; i < n && finite; ++i) {
+        const int j = (i + 1) % n;
+        const double xa = transform.scale * xy[2 * i] + transform.offsetX;
+        const double ya = transform.scale * xy[2 * i + 1] + transform.offsetY;
+        const double xb = transform.scale * xy[2 * j] + transform.offsetX;
+        const double yb = transform.scale * xy[2 * j + 1] + transform.offsetY;
+        finite = std::isfinite(xa) && std::isfinite(ya) && std::isfinite(xb) && std::isfinite(yb);
+        if (ya == yb) continue;
+        Edge edge;
+        if (ya < yb) {
+            edge = {xa, ya, yb, (xb - xa) / (yb - ya)};
+        } else {
+            edge = {xb, yb, ya, (xa - xb) / (ya - yb)};
+        }
+        m_edges.push_back(edge);
+    }
+    // 退化的帧（NaN/Inf）只画背景
+    if (!finite) m_edges.clear();
+    std::sort(m_edges.begin(), m_edges.end(), [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+
+    const int tileHeight = std::max(1, options.tileHeight);
+    const int tileCount = (options.height + tileHeight - 1) / tileHeight;
+    if (!pool || pool->size() <= 1 || tileCount <= 1) {
+        for (int tile = 0; tile < tileCount; ++tile) {
+            renderTile(tile * tileHeight, std::min(options.height, (tile + 1) * tileHeight), options, out);
+        }
+        return;
+    }
+
+    // 块级并行：每个工作线程循环领取下一块，块之间不共享任何可写数据
+    std::atomic<int> next{0};
+    std::vector<std::future<void>> pending;
+    for (unsigned w = 0; w < pool->size(); ++w) {
+        pending.push_back(pool->submit([&]() {
+            for (int tile = next++; tile < tileCount; tile = next++) {
+                renderTile(tile * tileHeight, std::min(options.height, (tile + 1) * tileHeight), options, out);
+            }
+        }));
+    }
+    // 任务引用本函数的局部变量：先等所有任务结束，再重新抛出第一个异常
+    std::exception_ptr failure;
+    for (auto& f : pending) {
+        try {
+            f.get();
+        } catch (...) {
+            if (!failure) failure = std::current_exception();
+        }
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
+void Rasterizer::renderTile(int rowBegin, int rowEnd, const RasterOptions& options, RasterImage& out) const{
+    const int width = options.width;
+    const int samples = std::max(1, options.samples);
+    const float weight = 1.0f / samples;
+
+    // 与本块相交的边（m_edges 按 y0 升序，遇到 y0 >= rowEnd 即可停止）
+    std::vector<const Edge*> edges;
+    for (const Edge& edge : m_edges) {
+        if (edge.y0 >= rowEnd) break;
+        if (edge.y1 > rowBegin) edges.push_back(&edge);
+    }
+
+    std::vector<float> cover(width + 1);   // 跨度端点所在像素的部分覆盖率
+    std::vector<float> interior(width + 2); // 整像素覆盖率的差分数组
+    std::vector<double> crossings;
+    std::vector<const Edge*> active;
+    size_t nextEdge = 0;
+
+    const float fillAlpha = options.fill[3] / 255.0f;
+    std::array<uint8_t, 4> solid;
+    for (int c = 0; c < 4; ++c) solid[c] = blend(options.background[c], options.fill[c], fillAlpha);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        // 活动边表：加入开始于本行之前的边，移除在本行之前结束的边
+        while (nextEdge < edges.size() && edges[nextEdge]->y0 < y + 1) active.push_back(edges[nextEdge++]);
+        active.erase(std::remove_if(active.begin(), active.end(), [y](const Edge* e) { return e->y1 <= y; }), active.end());
+
+        std::fill(cover.begin(), cover.end(), 0.0f);
+        std::fill(interior.begin(), interior.end(), 0.0f);
+        for (int s = 0; s < samples && !active.empty(); ++s) {
+            const double sy = y + (s + 0.5) / samples;
+            crossings.clear();
+            for (const Edge* e : active) {
+                // 半开区间 [y0, y1)：经过顶点的扫描线只与其中一条边相交
+                if (e->y0 <= sy && sy < e->y1) crossings.push_back(e->x0 + (sy - e->y0) * e->dxdy);
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            // 奇偶规则：交点两两配对成填充跨度
+            for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+                const double xa = std::clamp(crossings[k], 0.0, static_cast<double>(width));
+                const double xb = std::clamp(crossings[k + 1], 0.0, static_cast<double>(width));
+                if (xb <= xa) continue;
+                const int ia = static_cast<int>(xa);
+                const int ib = static_cast<int>(xb);
+                if (ia == ib) {
+                    cover[ia] += static_cast<float>(xb - xa) * weight;
+                    continue;
+                }
+                cover[ia] += static_cast<float>(ia + 1 - xa) * weight;
+                cover[ib] += static_cast<float>(xb - ib) * weight;
+                interior[ia + 1] += weight;
+                interior[ib] -= weight;
+            }
+        }
+
+        // 大部分像素完全在形状内或外，直接拷贝预先合成好的颜色，只有边缘像素需要混合
+        uint8_t* row = out.rgba.data() + 4 * static_cast<size_t>(width) * y;
+        float run = 0.0f;
+        for (int x = 0; x < width; ++x) {
+            run += interior[x];
+            const float coverage = run + cover[x];
+            if (coverage <= 1e-6f) {
+                std::memcpy(row + 4 * x, options.background.data(), 4);
+            } else if (coverage >= 1.0f - 1e-6f) {
+                std::memcpy(row + 4 * x, solid.data(), 4);
+            } else {
+                const float a = coverage * fillAlpha;
+                for (int c = 0; c < 4; ++c) row[4 * x + c] = blend(options.background[c], options.fill[c], a);
+            }
+        }
+    }
+}
+
+bool renderMorphSequence(const MorphPlan& plan, const std::vector<float>& times, const RasterOptions& options,
+                         RasterFormat format, const std::string& outDir, RasterParallelism parallelism,
+                         unsigned threadCount, RasterSequenceStats* stats){
+    if (plan.empty() || times.empty() || options.width <= 0 || options.height <= 0) {
+        std::cerr << "Error: Nothing to render." << std::endl;
+        return false;
+    }
+    if (options.width > kMaxRasterSize || options.height > kMaxRasterSize) {
+        std::cerr << "Error: Image size " << options.width << "x" << options.height << " exceeds the limit of "
+                  << kMaxRasterSize << " pixels per side." << std::endl;
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to create output directory " << outDir << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // 整个序列共用一个视图：所有帧的总包围盒（每帧 O(n)，相对光栅化可以忽略）
+    std::vector<double> xy(2 * static_cast<size_t>(plan.n));
+    double minX = std::numeric_limits<double>::max(), minY = minX;
+    double maxX = std::numeric_limits<double>::lowest(), maxY = maxX;
+    for (float t : times) {
+        plan.evaluate(t, xy.data());
+        for (int i = 0; i < plan.n; ++i) {
+            if (!std::isfinite(xy[2 * i]) || !std::isfinite(xy[2 * i + 1])) continue;
+            minX = std::min(minX, xy[2 * i]);
+            maxX = std::max(maxX, xy[2 * i]);
+            minY = std::min(minY, xy[2 * i + 1]);
+            maxY = std::max(maxY, xy[2 * i + 1]);
+        }
+    }
+    if (minX > maxX) minX = minY = maxX = maxY = 0.0;
+    const RasterTransform transform = RasterTransform::fit(minX, minY, maxX, maxY, options.width, options.height);
+
+    const char* extension = format == RasterFormat::Png ? "png" : "ppm";
+    auto framePath = [&](size_t f) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%04zu.%s", f, extension);
+        return (std::filesystem::path(outDir) / name).string();
+    };
+    auto write = [&](const RasterImage& image, const std::string& path) {
+        ScopedTimer timer("image_write");
+        return format == RasterFormat::Png ? image.writePng(path) : image.writePpm(path);
+    };
+
+    std::atomic<bool> ok{true};
+    {
+        ThreadPool pool(threadCount);
+        if (parallelism == RasterParallelism::Tiles) {
+            Rasterizer rasterizer;
+            RasterImage image;
+            for (size_t f = 0; f < times.size() && ok; ++f) {
+                try {
+                    plan.evaluate(times[f], xy.data());
+                    {
+                        ScopedTimer timer("rasterize");
+                        rasterizer.render(xy.data(), plan.n, transform, options, image, &pool);
+                    }
+                    if (!write(image, framePath(f))) ok = false;
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Failed to render frame " << f << ": " << e.what() << std::endl;
+                    ok = false;
+                }
+            }
+        } else {
+            // 帧级并行：每个工作线程一个循环任务，独占自己的光栅器、坐标和图像缓冲区
+            std::atomic<size_t> next{0};
+            for (unsigned w = 0; w < pool.size(); ++w) {
+                // submit 返回的 future 不保留：异常在任务内捕获，记录后让整个序列失败
+                pool.submit([&]() {
+                    size_t f = 0;
+                    try {
+                        Rasterizer rasterizer;
+                        RasterImage image;
+                        std::vector<double> frame(2 * static_cast<size_t>(plan.n));
+                        for (f = next++; f < times.size() && ok; f = next++) {
+                            plan.evaluate(times[f], frame.data());
+                            {
+                                ScopedTimer timer("rasterize");
+                                rasterizer.render(frame.data(), plan.n, transform, options, image);
+                            }
+                            if (!write(image, framePath(f))) ok = false;
+                        }
+                    } catch (const std::exception& e) {
+                        std::cerr << "Error: Failed to render frame " << f << ": " << e.what() << std::endl;
+                        ok = false;
+                    }
+                });
+            }
+        }
+        // 线程池析构时等待所有任务完成
+    }
+
+    if (stats) {
+        stats->frames = static_cast<int>(times.size());
+        stats->wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats->framesPerSecond = stats->wallSeconds > 0.0 ? stats->frames / stats->wallSeconds : 0.0;
+    }
+    return ok;
+}
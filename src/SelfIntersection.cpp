@@ -0,0 +1,293 @@
+#include "SelfIntersection.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+inline double cross(const double* o, const double* a, const double* b) {
+    return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0]);
+}
+
+constexpr double kVertical = HUGE_VAL; // 竖直边的斜率
+
+inline int sign(double v) {
+    return (v > 0.0) - (v < 0.0);
+}
+
+/**
+ * @brief 已知 p、a、b 共线时，p 是否在线段 ab 的包围盒内（即在线段上）。
+ */
+inline bool onSegment(const double* a, const double* b, const double* p) {
+    return std::min(a[0], b[0]) <= p[0] && p[0] <= std::max(a[0], b[0]) &&
+           std::min(a[1], b[1]) <= p[1] && p[1] <= std::max(a[1], b[1]);
+}
+
+/**
+ * @brief 闭线段 ab 与 cd 是否有公共点（端点接触和共线重叠都算）。
+ */
+bool segmentsTouch(const double* a, const double* b, const double* c, const double* d) {
+    const int d1 = sign(cross(c, d, a));
+    const int d2 = sign(cross(c, d, b));
+    const int d3 = sign(cross(a, b, c));
+    const int d4 = sign(cross(a, b, d));
+    if (d1 * d2 < 0 && d3 * d4 < 0) return true;
+    return (d1 == 0 && onSegment(c, d, a)) || (d2 == 0 && onSegment(c, d, b)) ||
+           (d3 == 0 && onSegment(a, b, c)) || (d4 == 0 && onSegment(a, b, d));
+}
+
+} // namespace
+
+bool SelfIntersectionChecker::EdgeLess::operator()(int a, int b) const{
+    const Edge& ea = checker->m_edges[a];
+    const Edge& eb = checker->m_edges[b];
+    // 在较晚插入的那条边的左端点处比较：此时两条边都与扫描线相交
+    const double x = std::max(ea.x, eb.x);
+    const double ya = ea.slope == kVertical ? ea.y : ea.y + ea.slope * (x - ea.x);
+    const double yb = eb.slope == kVertical ? eb.y : eb.y + eb.slope * (x - eb.x);
+    if (ya != yb) return ya < yb;
+    // 从同一点出发的两条边：向右看斜率小的在下面（竖直边最陡）
+    return ea.slope < eb.slope;
+}
+
+bool SelfIntersectionChecker::intersects(int a, int b) const{
+    const int an = a + 1 == m_n ? 0 : a + 1;
+    const int bn = b + 1 == m_n ? 0 : b + 1;
+    const double* a0 = m_xy + 2 * a;
+    const double* a1 = m_xy + 2 * an;
+    const double* b0 = m_xy + 2 * b;
+    const double* b1 = m_xy + 2 * bn;
+
+    // 相邻的边必然共享一个顶点，只有向同一方向共线（折返）时才算自交
+    if (an == b || bn == a) {
+        const double* shared = an == b ? a1 : b1;
+        const double* p = an == b ? a0 : a1;
+        const double* q = an == b ? b1 : b0;
+        if (cross(shared, p, q) != 0.0) return false;
+        return (p[0] - shared[0]) * (q[0] - shared[0]) + (p[1] - shared[1]) * (q[1] - shared[1]) > 0.0;
+    }
+    return segmentsTouch(a0, a1, b0, b1);
+}
+
+bool SelfIntersectionChecker::report(int a, int b){
+    if (!intersects(a, b)) return false;
+    m_edgeA = std::min(a, b);
+    m_edgeB = std::max(a, b);
+    return true;
+}
+
+bool SelfIntersectionChecker::isSimple(const Polygon& poly){
+    if (poly.externalXY) return isSimple(poly.externalXY, poly.n);
+    m_ownedXY.resize(2 * static_cast<size_t>(std::max(poly.n, 0)));
+    for (int i = 0; i < poly.n; ++i) {
+        m_ownedXY[2 * i] = poly.vertices[i].x();
+        m_ownedXY[2 * i + 1] = poly.vertices[i].y();
+    }
+    return isSimple(m_ownedXY.data(), poly.n);
+}
+
+bool SelfIntersectionChecker::isSimple(const double* xy, int n){
+    m_edgeA = m_edgeB = -1;
+    if (n < 3) return false;
+    for (int i = 0; i < 2 * n; ++i) {
+        if (!std::isfinite(xy[i])) return false;
+    }
+
+    auto sameAsNext = [&](int i) {
+        const int j = i + 1 == n ? 0 : i + 1;
+        return xy[2 * i] == xy[2 * j] && xy[2 * i + 1] == xy[2 * j + 1];
+    };
+    int duplicates = 0;
+    for (int i = 0; i < n; ++i) duplicates += sameAsNext(i);
+    if (duplicates == 0) return sweep(xy, n);
+
+    // 合并重合的相邻顶点：每段重复只保留最后一个，它出发的边就是这一段之后的那条边
+    m_compactXY.clear();
+    m_originalEdge.clear();
+    for (int i = 0; i < n; ++i) {
+        if (sameAsNext(i)) continue;
+        m_compactXY.push_back(xy[2 * i]);
+        m_compactXY.push_back(xy[2 * i + 1]);
+        m_originalEdge.push_back(i);
+    }
+    const int m = static_cast<int>(m_originalEdge.size());
+    if (m < 3) return false; // 退化成一个点或一条线段
+    if (sweep(m_compactXY.data(), m)) return true;
+    if (m_edgeA >= 0) {
+        const int a = m_originalEdge[m_edgeA];
+        const int b = m_originalEdge[m_edgeB];
+        m_edgeA = std::min(a, b);
+        m_edgeB = std::max(a, b);
+    }
+    return false;
+}
+
+bool SelfIntersectionChecker::sweep(const double* xy, int n){
+    m_xy = xy;
+    m_n = n;
+    // 每条边记下左端点（字典序较小的一端）和斜率，扫描时不再回头读坐标
+    m_edges.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const double* p = xy + 2 * i;
+        const double* q = xy + 2 * (i + 1 == n ? 0 : i + 1);
+        const bool pLeft = p[0] < q[0] || (p[0] == q[0] && p[1] < q[1]);
+        const double* l = pLeft ? p : q;
+        const double* r = pLeft ? q : p;
+        Edge& e = m_edges[i];
+        e.x = l[0];
+        e.y = l[1];
+        e.slope = l[0] == r[0] ? kVertical : (r[1] - l[1]) / (r[0] - l[0]);
+        e.leftVertex = pLeft ? i : (i + 1 == n ? 0 : i + 1);
+    }
+    m_events.resize(n);
+    for (int i = 0; i < n; ++i) m_events[i] = {xy[2 * i], xy[2 * i + 1], i};
+    std::sort(m_events.begin(), m_events.end(), [](const Event& a, const Event& b) {
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        return a.vertex < b.vertex;
+    });
+    // 两个不相邻的顶点重合：各自出发的边在这一点相接。排序后它们必然相邻，
+    // 在这里直接判定，扫描时就不必处理同一点上多组插入/删除的先后顺序
+    for (int k = 1; k < n; ++k) {
+        if (m_events[k].x == m_events[k - 1].x && m_events[k].y == m_events[k - 1].y) {
+            m_edgeA = std::min(m_events[k].vertex, m_events[k - 1].vertex);
+            m_edgeB = std::max(m_events[k].vertex, m_events[k - 1].vertex);
+            m_xy = nullptr;
+            return false;
+        }
+    }
+
+    m_status.clear();
+    m_handles.assign(n, m_status.end());
+    bool simple = true;
+    for (const Event& event : m_events) {
+        const int v = event.vertex;
+        const int incident[2] = {v == 0 ? n - 1 : v - 1, v};
+        // 同一顶点上先插入后删除，使在此相接的边都在状态结构中相遇
+        for (int edge : incident) {
+            if (m_edges[edge].leftVertex != v) continue;
+            const auto it = m_status.insert(edge);
+            m_handles[edge] = it;
+            if (it != m_status.begin() && report(*std::prev(it), edge)) {
+                simple = false;
+                break;
+            }
+            const auto next = std::next(it);
+            if (next != m_status.end() && report(edge, *next)) {
+                simple = false;
+                break;
+            }
+        }
+        if (!simple) break;
+
+        for (int edge : incident) {
+            if (m_edges[edge].leftVertex == v) continue;
+            const auto it = m_handles[edge];
+            if (it == m_status.end()) continue;
+            const auto next = std::next(it);
+            if (it != m_status.begin() && next != m_status.end() && report(*std::prev(it), *next)) {
+                simple = false;
+                break;
+            }
+            m_status.erase(it);
+            m_handles[edge] = m_status.end();
+        }
+        if (!simple) break;
+    }
+
+    m_status.clear();
+    m_xy = nullptr;
+    return simple;
+}
+
+bool scanSelfIntersections(const MorphPlan& plan, const IntersectionScanOptions& options, IntersectionScanResult& result){
+    result = IntersectionScanResult();
+    const int n = plan.n;
+    if (n < 3 || !(options.tEnd >= options.tBegin)) return false;
+
+    SelfIntersectionChecker checker;
+    std::vector<double> good(2 * static_cast<size_t>(n));  // 最后一个通过检查的帧
+    std::vector<double> probe(2 * static_cast<size_t>(n)); // 待检查的帧
+
+    auto evaluate = [&](float t, std::vector<double>& xy) {
+        plan.evaluate(t, xy.data());
+        ++result.evaluations;
+    };
+    auto check = [&](const std::vector<double>& xy) {
+        ScopedTimer timer("self_intersection");
+        ++result.checks;
+        return checker.isSimple(xy.data(), n);
+    };
+    auto fail = [&](float lastGood, float bad, int edgeA, int edgeB) {
+        result.found = true;
+        result.lastGoodT = lastGood;
+        result.firstBadT = bad;
+        result.edgeA = edgeA;
+        result.edgeB = edgeB;
+        return true;
+    };
+
+    float goodT = options.tBegin;
+    evaluate(goodT, good);
+    if (!check(good)) return fail(goodT, goodT, checker.edgeA(), checker.edgeB());
+
+    // 位移阈值取起始帧包围盒对角线的 maxStep 倍
+    double minX = good[0], maxX = good[0], minY = good[1], maxY = good[1];
+    for (int i = 1; i < n; ++i) {
+        minX = std::min(minX, good[2 * i]);
+        maxX = std::max(maxX, good[2 * i]);
+        minY = std::min(minY, good[2 * i + 1]);
+        maxY = std::max(maxY, good[2 * i + 1]);
+    }
+    const double limit = options.maxStep * std::hypot(maxX - minX, maxY - minY);
+    const double limit2 = limit * limit;
+    const float tolerance = std::max(options.tolerance, 1e-7f);
+
+    // 待访问的采样点，栈顶是下一个（最小的）t
+    std::vector<float> pending;
+    const int segments = std::max(1, options.initialSamples);
+    for (int s = segments; s >= 1; --s) {
+        pending.push_back(options.tBegin + (options.tEnd - options.tBegin) * static_cast<float>(s) / segments);
+    }
+
+    while (!pending.empty()) {
+        const float t = pending.back();
+        evaluate(t, probe);
+
+        double maxMove2 = 0.0;
+        for (int i = 0; i < 2 * n; i += 2) {
+            const double dx = probe[i] - good[i];
+            const double dy = probe[i + 1] - good[i + 1];
+            maxMove2 = std::max(maxMove2, dx * dx + dy * dy);
+        }
+        if (maxMove2 > limit2 && t - goodT > tolerance) {
+            pending.push_back(0.5f * (goodT + t));
+            continue;
+        }
+
+        if (!check(probe)) {
+            // 在 (goodT, t] 中二分出第一个自交的帧
+            float lo = goodT;
+            float hi = t;
+            int edgeA = checker.edgeA();
+            int edgeB = checker.edgeB();
+            while (hi - lo > tolerance) {
+                const float mid = 0.5f * (lo + hi);
+                evaluate(mid, probe);
+                if (check(probe)) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                    edgeA = checker.edgeA();
+                    edgeB = checker.edgeB();
+                }
+            }
+            return fail(lo, hi, edgeA, edgeB);
+        }
+
+        goodT = t;
+        good.swap(probe);
+        pending.pop_back();
+    }
+    return false;
+}
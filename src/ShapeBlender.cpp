@@ -9,7 +9,10 @@
 #include <vector>
 #include <algorithm> // for std::sort
 #include <functional>
+#include <chrono>
 #include "Eigen/LU"
+#include "Profiler.h"
+#include "MorphDiskCache.h"
 
 // 用于M_PI
 #define _USE_MATH_DEFINES
@@ -17,25 +20,71 @@
 
 
 bool ShapeBlender::loadPolygons(const std::string& pathA, const std::string& pathB){
+    ScopedTimer timer("load");
     if (!m_polyA.loadFromFile(pathA)) {
-        std::cerr << "Failed to load Polygon A" << std::endl;
+        error() << "Failed to load Polygon A" << std::endl;
         return false;
     }
     if (!m_polyB.loadFromFile(pathB)) {
-        std::cerr << "Failed to load Polygon B" << std::endl;
+        error() << "Failed to load Polygon B" << std::endl;
         return false;
     }
 
+    alignWinding();
+
+    info() << "Loading Polygons : A (" << m_polyA.n <<  "verts ) and B (" << m_polyB.n << " verts)." << std::endl;
+    return true;
+}
+
+void ShapeBlender::setPolygons(const Polygon& polyA, const Polygon& polyB){
+    m_polyA = polyA;
+    m_polyB = polyB;
+    alignWinding();
+}
+
+void ShapeBlender::alignWinding(){
+    // 旧的计划引用的是上一对多边形
+    m_correspondence.clear();
+    m_plan = MorphPlan();
+
     if (m_polyA.signFlag != m_polyB.signFlag) {
-        std::cout << "Winding order mismatch detected. Reversing Polygon B." << std::endl;
-        //反转 B 的顶点列表
-        std::reverse(m_polyB.vertices.begin(), m_polyB.vertices.end());
-        //重新计算 B 的所有内在属性
-        m_polyB.precomputeIntrinsics();
+        info() << "Winding order mismatch detected. Reversing Polygon B." << std::endl;
+        //反转 B 的顶点列表，并重新计算 B 的所有内在属性
+        m_polyB.reverse();
     }
+}
 
-    std::cout << "Loading Polygons : A (" << m_polyA.n <<  "verts ) and B (" << m_polyB.n << " verts)." << std::endl;
-    return true;
+void ShapeBlender::setLogStreams(std::ostream* info, std::ostream* error){
+    m_info = info;
+    m_error = error;
+}
+
+namespace {
+// 没有 streambuf 的流处于 badbit 状态，写入什么都不做；每个线程一个，避免多个求解器并发写同一个对象
+std::ostream& nullStream(){
+    thread_local std::ostream stream(nullptr);
+    return stream;
+}
+} // namespace
+
+std::ostream& ShapeBlender::info() const{
+    return m_info ? *m_info : nullStream();
+}
+
+std::ostream& ShapeBlender::error() const{
+    return m_error ? *m_error : nullStream();
+}
+
+BlendWeights ShapeBlender::getWeights() const{
+    return {m_w1, m_w2, m_smooth_a_wS, m_smooth_a_wR, m_smooth_a_wA};
+}
+
+void ShapeBlender::setWeights(const BlendWeights& weights){
+    m_w1 = weights.w1;
+    m_w2 = weights.w2;
+    m_smooth_a_wS = weights.smooth_a_wS;
+    m_smooth_a_wR = weights.smooth_a_wR;
+    m_smooth_a_wA = weights.smooth_a_wA;
 }
 
 
@@ -97,12 +146,12 @@ double ShapeBlender::compute_smooth_a(int i_A, int i_B) const{
 
     //----- 计算R旋转 -----
     //我们选 e2 的 (v_curr -> v_next) 边旋转
-    const auto& v_curr_A = m_polyA.vertices[i_A];
-    const auto& v_next_A = m_polyA.vertices[m_polyA.get_next_idx(i_A)];
+    const auto v_curr_A = m_polyA.vertex(i_A);
+    const auto v_next_A = m_polyA.vertex(m_polyA.get_next_idx(i_A));
     Eigen::Vector2d vec_A = v_next_A - v_curr_A;
 
-    const auto& v_curr_B = m_polyB.vertices[i_B];
-    const auto& v_next_B = m_polyB.vertices[m_polyB.get_next_idx(i_B)];
+    const auto v_curr_B = m_polyB.vertex(i_B);
+    const auto v_next_B = m_polyB.vertex(m_polyB.get_next_idx(i_B));
     Eigen::Vector2d vec_B = v_next_B - v_curr_B;
 
     double angle_vec_A = std::atan2(vec_A.y(), vec_A.x());
@@ -122,32 +171,49 @@ double ShapeBlender::compute_smooth_a(int i_A, int i_B) const{
     return m_smooth_a_wS * S + m_smooth_a_wR * R + m_smooth_a_wA * A;
 }
 
-void ShapeBlender::computeCorrespondence(int manual_k){
+void ShapeBlender::computeCorrespondence(int manual_k, KSearchProgress* progress){
     int m = m_polyA.n;
     int n = m_polyB.n;
 
     //前置检查
-    if (m == 0 || n == 0) return;
+    if (m == 0 || n == 0) {
+        if (progress) progress->finished = true;
+        return;
+    }
     if (m < n) {
-        std::cerr << "Error in computeCorrespondence: Polygon A (" << m 
-                  << ") must have >= vertices than Polygon B (" << n << ").\n"
-                  << "Please reload polygons with the larger one as 'Polygon A'." << std::endl;
+        error() << "Error in computeCorrespondence: Polygon A (" << m 
+              << ") must have >= vertices than Polygon B (" << n << ").\n"
+              << "Please reload polygons with the larger one as 'Polygon A'." << std::endl;
+        if (progress) progress->finished = true;
         return; // DP逻辑基于 m >= n
     }
+    if (manual_k < -1 || manual_k >= m) {
+        error() << "Error in computeCorrespondence: manual k = " << manual_k
+              << " is out of range (expected -1 for auto search or 0.." << m - 1 << ")." << std::endl;
+        // 不保留上一次的结果，调用者据此看到空的计划
+        m_correspondence.clear();
+        m_plan = MorphPlan();
+        if (progress) progress->finished = true;
+        return;
+    }
 
     // 构建代价图(m x n)，
     Eigen::MatrixXd costGraph(m, n); 
-    
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
-            double sim = compute_sim_t(i, j);
-            costGraph(i, j) = 1.0 - sim;
+    {
+        ScopedTimer timer("cost_graph");
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double sim = compute_sim_t(i, j);
+                costGraph(i, j) = 1.0 - sim;
+            }
         }
     }
+    // 代价图 + 一次 DP 的代价表和路径表（及其返回的副本）
+    m_scratchBytes = static_cast<size_t>(m) * n * (2 * sizeof(double) + 2 * sizeof(int));
 
 
     double min_total_cost = std::numeric_limits<double>::max();
-    int best_k = 0; // 最佳的 A 的起始顶点
+    m_kCosts.assign(m, std::numeric_limits<double>::infinity());
     
     //----- 将DP逻辑抽象为一个辅助函数 -----
     auto run_single_dp_pass = [&](int k) -> std::pair<double, Eigen::MatrixXi> {
@@ -204,28 +270,84 @@ void ShapeBlender::computeCorrespondence(int manual_k){
 
     if (manual_k == -1) {
         // --- 自动模式 ---
-        // (遍历 A 的 m 个起始点)
-        std::cout << "Running Auto-Search for best k (O(m^2*n))..." << std::endl;
+        // (遍历 A 的 m 个起始点，可随时停止)
+        info() << "Running Auto-Search for best k (O(m^2*n))..." << std::endl;
+        ScopedTimer timer("k_sweep");
+        const auto searchStart = std::chrono::steady_clock::now();
+
+        // 每条路径恰好在每一行取一个格子，而 k 只是把行重新排列，
+        // 所以"每行最小代价之和"是所有 k 共同的下界
+        double lower_bound = costGraph.rowwise().minCoeff().sum();
+
+        // 启发式排序：沿"均匀拉伸"路径 j(i) = i*(n-1)/(m-1) 的代价。
+        // 这条路径本身是合法的 DP 路径，因此它也是该 k 真实代价的上界。
+        std::vector<std::pair<double, int>> order(m);
         for (int k = 0; k < m; ++k) {
+            double estimate = 0.0;
+            for (int i = 0; i < m; ++i) {
+                int j = (m > 1) ? static_cast<int>(static_cast<long long>(i) * (n - 1) / (m - 1)) : 0;
+                estimate += costGraph((i + k) % m, j);
+            }
+            order[k] = {estimate, k};
+        }
+        std::sort(order.begin(), order.end());
+
+        if (progress) {
+            progress->total = m;
+            progress->lowerBound = lower_bound;
+        }
+
+        int tested = 0;
+        for (const auto& candidate : order) {
+            int k = candidate.second;
             double current_total_cost = run_single_dp_pass(k).first; // 只获取代价
+            m_kCosts[k] = current_total_cost;
+            ++tested;
+
             if (current_total_cost < min_total_cost) {
                  min_total_cost = current_total_cost;
                  m_bestK = k; 
+                 if (progress) {
+                     progress->bestCost = min_total_cost;
+                     progress->bestK = m_bestK;
+                     if (progress->onImproved) progress->onImproved(m_bestK, min_total_cost);
+                 }
+            }
+            if (progress) progress->tested = tested;
+
+            // 已经达到下界，不可能再找到更好的 k
+            if (min_total_cost <= lower_bound + 1e-12) break;
+
+            if (progress) {
+                if (progress->cancel) {
+                    info() << "  - (Auto-Search) Cancelled." << std::endl;
+                    progress->truncated = true;
+                    break;
+                }
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+                if (progress->timeBudgetSeconds > 0.0 && elapsed >= progress->timeBudgetSeconds) {
+                    info() << "  - (Auto-Search) Time budget reached." << std::endl;
+                    progress->truncated = true;
+                    break;
+                }
             }
         }
-        std::cout << "  - (Auto-Search) Best start vertex (k) = " << m_bestK << std::endl;
+        info() << "  - (Auto-Search) Best start vertex (k) = " << m_bestK
+           << " (tested " << tested << "/" << m << " k, lower bound = " << lower_bound << ")" << std::endl;
 
     } else {
         // --- 手动模式 ---
         // (只运行一次，使用用户指定的 k)
-        std::cout << "Running Manual-Search for k = " << manual_k << " (O(m*n))..." << std::endl;
+        info() << "Running Manual-Search for k = " << manual_k << " (O(m*n))..." << std::endl;
         m_bestK = manual_k;
     }
 
     // -----------------------------------------------------------------
     // 重走 'best_k'
+    ScopedTimer tracebackTimer("traceback");
     std::pair<double, Eigen::MatrixXi> result = run_single_dp_pass(m_bestK);
     if(manual_k != -1) min_total_cost = result.first;
+    m_kCosts[m_bestK % m] = result.first;
     Eigen::MatrixXi dpPath = result.second; 
 
     m_correspondence.clear();
@@ -234,7 +356,7 @@ void ShapeBlender::computeCorrespondence(int manual_k){
     
     while (i >= 0 && j >= 0) {
         // 将 "窗口" 索引 (i, j) 转换回 "真实" 索引
-        m_correspondence[(i + best_k) % m] = j;
+        m_correspondence[(i + m_bestK) % m] = j;
         
         int path = dpPath(i,j);
         
@@ -249,18 +371,28 @@ void ShapeBlender::computeCorrespondence(int manual_k){
             i--;
         }
     }
-    std::cout << "  - i = " << i << "; j = " << j << std::endl;
-    std::cout << "  - Best path start index (A_start) = " << best_k << " (maps to B[ 0 ])" << std::endl;
-    std::cout << "  - Min total cost = " << min_total_cost << std::endl;
-    std::cout << "  - Correspondence map size: " << m_correspondence.size() << " (should be " << m << ")" << std::endl;
+    info() << "  - i = " << i << "; j = " << j << std::endl;
+    info() << "  - Best path start index (A_start) = " << m_bestK << " (maps to B[ 0 ])" << std::endl;
+    info() << "  - Min total cost = " << min_total_cost << std::endl;
+    info() << "  - Correspondence map size: " << m_correspondence.size() << " (should be " << m << ")" << std::endl;
+
+    rebuildPlan();
+    if (progress) progress->finished = true;
 }
 
 void ShapeBlender::findOptimalBasis(){
+    ScopedTimer timer("basis");
     if(m_correspondence.size() < 3){
-        std::cerr << "Error: Correspondence map has < 3 pairs. Cannot find basis." << std::endl;
+        error() << "Error: Correspondence map has < 3 pairs. Cannot find basis." << std::endl;
         // 设置一个默认的、可能不好的基
         m_basis.polyA_indices = {0, m_polyA.n / 3, 2 * m_polyA.n / 3};
         m_basis.polyB_indices = {0, m_polyB.n / 3, 2 * m_polyB.n / 3};
+        // 对应关系求解失败（例如 k 越界）时保持空的计划，不用缺失的对应点拼出一帧
+        if (m_correspondence.empty()) {
+            m_plan = MorphPlan();
+            return;
+        }
+        rebuildPlan();
         return;
     }
 
@@ -275,20 +407,50 @@ void ShapeBlender::findOptimalBasis(){
     }
 
     if (smooth_pairs.size() < 3) {
-         std::cerr << "Error: Not enough valid pairs (<3) after computing smooth_a." << std::endl;
+         error() << "Error: Not enough valid pairs (<3) after computing smooth_a." << std::endl;
         // 设置一个默认的、可能不好的基
         m_basis.polyA_indices = {0, m_polyA.n / 3, 2 * m_polyA.n / 3};
         m_basis.polyB_indices = {0, m_polyB.n / 3, 2 * m_polyB.n / 3};
+        rebuildPlan();
         return;
     }
 
     // 我们使用 std::greater<> 来进行降序排序
     std::sort(smooth_pairs.begin(), smooth_pairs.end(), std::greater<SmoothPair>());
 
-    //取排序后的前 3 个
-    const auto& best_1 = smooth_pairs[0];
-    const auto& best_2 = smooth_pairs[1];
-    const auto& best_3 = smooth_pairs[2];
+    //按 smooth_a 从高到低挑 3 个，跳过会让 A 或 B 上的基三角形退化的点对
+    //（多对一的对应关系下，smooth_a 最高的几对常常落在同一个 B 顶点上）
+    std::vector<const SmoothPair*> chosen;
+    auto triangleArea = [](const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c) {
+        Eigen::Vector2d ab = b - a, ac = c - a;
+        return std::abs(ab.x() * ac.y() - ab.y() * ac.x());
+    };
+    for (const auto& pair : smooth_pairs) {
+        bool usable = true;
+        for (const SmoothPair* other : chosen) {
+            if (other->i_A == pair.i_A || other->i_B == pair.i_B) { usable = false; break; }
+        }
+        if (usable && chosen.size() == 2) {
+            const Polygon& A = m_polyA;
+            const Polygon& B = m_polyB;
+            usable = triangleArea(A.vertex(chosen[0]->i_A), A.vertex(chosen[1]->i_A), A.vertex(pair.i_A)) > 1e-9
+                  && triangleArea(B.vertex(chosen[0]->i_B), B.vertex(chosen[1]->i_B), B.vertex(pair.i_B)) > 1e-9;
+        }
+        if (usable) chosen.push_back(&pair);
+        if (chosen.size() == 3) break;
+    }
+
+    if (chosen.size() < 3) {
+        error() << "Error: No non-degenerate basis among the correspondence pairs." << std::endl;
+        m_basis.polyA_indices = {0, m_polyA.n / 3, 2 * m_polyA.n / 3};
+        m_basis.polyB_indices = {0, m_polyB.n / 3, 2 * m_polyB.n / 3};
+        rebuildPlan();
+        return;
+    }
+
+    const auto& best_1 = *chosen[0];
+    const auto& best_2 = *chosen[1];
+    const auto& best_3 = *chosen[2];
 
     //存储最佳基
     m_basis.polyA_indices[0] = best_1.i_A;
@@ -302,9 +464,33 @@ void ShapeBlender::findOptimalBasis(){
 
     double max_smooth_t = best_1.smooth_a_value * best_2.smooth_a_value * best_3.smooth_a_value;
 
-    std::cout << "Found optimal basis with smooth_t = " << max_smooth_t << std::endl;
+    info() << "Found optimal basis with smooth_t = " << max_smooth_t << std::endl;
+
+    rebuildPlan();
 } 
 
+bool ShapeBlender::restoreSolution(const std::map<int, int>& correspondence, int bestK,
+                                   const AffineBasis& basis, const std::vector<double>& kCosts){
+    const int m = m_polyA.n;
+    const int n = m_polyB.n;
+    if (m == 0 || n == 0 || bestK < 0 || bestK >= m || static_cast<int>(kCosts.size()) != m) return false;
+    for (const auto& [i_A, i_B] : correspondence) {
+        if (i_A < 0 || i_A >= m || i_B < 0 || i_B >= n) return false;
+    }
+    for (int k = 0; k < 3; ++k) {
+        if (basis.polyA_indices[k] < 0 || basis.polyA_indices[k] >= m ||
+            basis.polyB_indices[k] < 0 || basis.polyB_indices[k] >= n) return false;
+    }
+
+    m_correspondence = correspondence;
+    m_bestK = bestK;
+    m_basis = basis;
+    m_kCosts = kCosts;
+    m_scratchBytes = 0;
+    rebuildPlan();
+    return true;
+}
+
 Eigen::Vector2d ShapeBlender::getLocalCoords(const Eigen::Vector2d& p, 
                                              const Eigen::Vector2d& a, 
                                              const Eigen::Vector2d& b, 
@@ -318,26 +504,25 @@ Eigen::Vector2d ShapeBlender::getLocalCoords(const Eigen::Vector2d& p,
     return T.colPivHouseholderQr().solve(rhs);    
 } 
 
-Eigen::Vector2d ShapeBlender::getWorldCoords(const Eigen::Vector2d& uv, 
-                                   const Eigen::Vector2d& a, 
-                                   const Eigen::Vector2d& b, 
-                                   const Eigen::Vector2d& c) const{
-
-    return b + uv[0] * (a - b) + uv[1] * (c - b);
-}
+void ShapeBlender::rebuildPlan() {
+    m_plan = MorphPlan();
+    if(m_polyA.n == 0 || m_polyB.n == 0) return;
 
-Polygon ShapeBlender::getInterpolatedPolygon(float t) const {
-    Polygon resultPoly;
-    if(m_polyA.n == 0 || m_polyB.n == 0) return resultPoly;
+    for (int k = 0; k < 3; ++k) {
+        if (m_basis.polyA_indices[k] < 0 || m_basis.polyA_indices[k] >= m_polyA.n ||
+            m_basis.polyB_indices[k] < 0 || m_basis.polyB_indices[k] >= m_polyB.n) {
+            return; // 基尚未针对当前这对多边形计算
+        }
+    }
 
     //获取基顶点
-    Eigen::Vector2d A1 = m_polyA.vertices[m_basis.polyA_indices[0]];
-    Eigen::Vector2d B1 = m_polyA.vertices[m_basis.polyA_indices[1]];
-    Eigen::Vector2d C1 = m_polyA.vertices[m_basis.polyA_indices[2]];
+    Eigen::Vector2d A1 = m_polyA.vertex(m_basis.polyA_indices[0]);
+    Eigen::Vector2d B1 = m_polyA.vertex(m_basis.polyA_indices[1]);
+    Eigen::Vector2d C1 = m_polyA.vertex(m_basis.polyA_indices[2]);
    
-    Eigen::Vector2d A2 = m_polyB.vertices[m_basis.polyB_indices[0]];
-    Eigen::Vector2d B2 = m_polyB.vertices[m_basis.polyB_indices[1]];
-    Eigen::Vector2d C2 = m_polyB.vertices[m_basis.polyB_indices[2]];
+    Eigen::Vector2d A2 = m_polyB.vertex(m_basis.polyB_indices[0]);
+    Eigen::Vector2d B2 = m_polyB.vertex(m_basis.polyB_indices[1]);
+    Eigen::Vector2d C2 = m_polyB.vertex(m_basis.polyB_indices[2]);
     
     //获得A和T
     Eigen::Matrix<double, 6, 6> M_solve;
@@ -356,77 +541,90 @@ Polygon ShapeBlender::getInterpolatedPolygon(float t) const {
     Eigen::Matrix2d A_mat;
     A_mat << X_solve(0), X_solve(1), X_solve(2), X_solve(3);
 
-    Eigen::RowVector2d T_vec;
-    T_vec << X_solve(4), X_solve(5);
-
     // 下面开始分解 A 矩阵
-    Eigen::Matrix2d B_mat;
-    Eigen::Matrix2d C_mat;
-    double theta = 0.0;
-
     double det_A = A_mat.determinant();
     double sign_detA = (det_A < 0) ? -1.0 : 1.0;
 
     Eigen::Matrix2d cofactor_matrix;
     cofactor_matrix << A_mat(1,1), -A_mat(1,0),  
                        -A_mat(0,1), A_mat(0,0); 
-    B_mat = A_mat + sign_detA * cofactor_matrix;
+    Eigen::Matrix2d B_mat = A_mat + sign_detA * cofactor_matrix;
 
     //归一化 B
     Eigen::Vector2d b1 = B_mat.col(0);
     b1.normalize();
     B_mat << b1.x(), -b1.y(), 
              b1.y(),  b1.x();
-    
-    theta = std::atan2(b1.y(), b1.x());
-    C_mat = B_mat.inverse() * A_mat;
-
-
-    // 插值并且重新组合
-    double t_f = static_cast<double>(t);
-    Eigen::Matrix2d A_t;
-    Eigen::RowVector2d T_t;
 
-    //插值旋转 B
-    double theta_t = t_f * theta;
-    Eigen::Matrix2d B_t;
-    B_t << std::cos(theta_t), -std::sin(theta_t),
-           std::sin(theta_t),  std::cos(theta_t);
-
-    //插值缩放 C
-    Eigen::Matrix2d C_t = t_f * C_mat;
-
-    //插值平移 T
-    T_t = t_f * T_vec;
-    
-    //重新组合 A
-    Eigen::Matrix2d I = Eigen::Matrix2d::Identity();
-    A_t = (1.0-t_f) * I + B_t * C_t;
+    m_plan.basisA = A1;
+    m_plan.basisB = B1;
+    m_plan.basisC = C1;
+    m_plan.theta = std::atan2(b1.y(), b1.x());
+    m_plan.C_mat = B_mat.inverse() * A_mat;
+    m_plan.T_vec << X_solve(4), X_solve(5);
+
+    //每个顶点的局部坐标与 t 无关，在这里一次算好
+    m_plan.n = m_polyA.n;
+    m_plan.uv1.resize(m_polyA.n);
+    m_plan.uv2.resize(m_polyA.n);
+    for(int i_A = 0; i_A < m_polyA.n; ++i_A){
+        m_plan.uv1[i_A] = getLocalCoords(m_polyA.vertex(i_A), A1, B1, C1);
 
-    //----- 应用变化 ----------
-    Eigen::Vector2d A_t_final = A_t * A1 + T_t.transpose();
-    Eigen::Vector2d B_t_final = A_t * B1 + T_t.transpose();
-    Eigen::Vector2d C_t_final = A_t * C1 + T_t.transpose();
+        auto it = m_correspondence.find(i_A);
+        if(it != m_correspondence.end()){
+            m_plan.uv2[i_A] = getLocalCoords(m_polyB.vertex(it->second), A2, B2, C2);
+        }else {
+            error() << "m_correspondense[" << i_A << "] Cannot Find i_B"  << std::endl; 
+            m_plan.uv2[i_A] = m_plan.uv1[i_A];
+        }
+    }
+}
 
-    resultPoly.vertices.resize(m_polyA.n);
-    resultPoly.n = m_polyA.n;
+size_t ShapeBlender::memoryUsage() const {
+    // std::map 每个节点除了键值对之外还有三个指针和颜色位
+    const size_t mapNodeBytes = sizeof(std::pair<const int, int>) + 4 * sizeof(void*);
+    return m_polyA.memoryUsage() + m_polyB.memoryUsage()
+         + m_correspondence.size() * mapNodeBytes
+         + m_kCosts.capacity() * sizeof(double)
+         + (m_plan.uv1.capacity() + m_plan.uv2.capacity()) * sizeof(Eigen::Vector2d);
+}
 
-    for(int i_A = 0; i_A < m_polyA.n; ++i_A){
-        const Eigen::Vector2d& X1 = m_polyA.vertices[i_A];
+Polygon ShapeBlender::getInterpolatedPolygon(float t) const {
+    return m_plan.evaluate(t);
+}
 
-        if(m_correspondence.count(i_A)){
-            int i_B = m_correspondence.at(i_A);
-            const Eigen::Vector2d& X2 = m_polyB.vertices[i_B];
+MorphSolution solveMorph(const Polygon& src, const Polygon& dst, const BlendWeights& weights, int manual_k){
+    ShapeBlender blender;
+    return solveMorph(blender, src, dst, weights, manual_k);
+}
 
-            Eigen::Vector2d uv1 = getLocalCoords(X1, A1, B1, C1);
-            Eigen::Vector2d uv2 = getLocalCoords(X2, A2, B2, C2);
-            Eigen::Vector2d uv_t = (1.0-t_f) * uv1 + t_f * uv2; 
+MorphSolution solveMorph(ShapeBlender& blender, const Polygon& src, const Polygon& dst,
+                         const BlendWeights& weights, int manual_k, KSearchProgress* progress,
+                         const MorphDiskCache* cache){
+    MorphSolution solution;
+    solution.swapped = src.n < dst.n;
+    if (solution.swapped && manual_k >= 0) {
+        blender.error() << "Error in solveMorph: manual k = " << manual_k << " needs the source (" << src.n
+                        << " verts) to have at least as many vertices as the target (" << dst.n << " verts)." << std::endl;
+        if (progress) progress->finished = true;
+        return solution;
+    }
 
-            resultPoly.vertices[i_A] = getWorldCoords(uv_t, A_t_final, B_t_final, C_t_final);
-        }else {
-            std::cerr << "m_correspondense[" << i_A << "] Cannot Find i_B"  << std::endl; 
-        }
+    blender.setWeights(weights);
+    if (solution.swapped) blender.setPolygons(dst, src);
+    else blender.setPolygons(src, dst);
 
+    if (cache) {
+        cache->solve(blender, manual_k, progress);
+    } else {
+        blender.computeCorrespondence(manual_k, progress);
+        blender.findOptimalBasis();
     }
-    return resultPoly;
+
+    solution.plan = blender.getPlan();
+    solution.plan.reversed = solution.swapped;
+    solution.correspondence = blender.getCorrespondence();
+    solution.basis = blender.getBasis();
+    solution.bestK = blender.getBestK();
+    return solution;
 }
@@ -0,0 +1,353 @@
+#include "Triangulation.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
+
+namespace {
+
+struct Point {
+    double x, y;
+};
+
+inline double cross(const Point& o, const Point& a, const Point& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/**
+ * @brief 扫描顺序：y 大者在前，y 相同时 x 小者在前（相当于把水平边看成略微倾斜）。
+ */
+inline bool above(const Point& a, const Point& b) {
+    return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+enum class VertexType { Start, End, Split, Merge, Regular };
+
+/**
+ * @brief 单调分解。顶点 0..n-1 已按逆时针排列，边 i 为 (i, i+1)。
+ * 扫描线自上而下经过各顶点，状态结构保存与扫描线相交、内部在其右侧的边及其 helper 顶点；
+ * split 顶点向上、merge 顶点向下连对角线，结果中的每一块都是 y 单调的。
+ */
+class MonotoneSplitter {
+public:
+    explicit MonotoneSplitter(const std::vector<Point>& pts) : m_pts(pts), m_n(static_cast<int>(pts.size())) {}
+
+    std::vector<std::pair<int, int>> run() {
+        std::vector<int> order(m_n);
+        for (int i = 0; i < m_n; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [this](int a, int b) { return above(m_pts[a], m_pts[b]); });
+
+        m_helper.assign(m_n, -1);
+        m_handles.assign(m_n, m_status.end());
+        m_type.resize(m_n);
+        for (int i = 0; i < m_n; ++i) m_type[i] = classify(i);
+
+        for (int v : order) {
+            m_sweepY = m_pts[v].y;
+            const int prevEdge = (v + m_n - 1) % m_n;
+            switch (m_type[v]) {
+                case VertexType::Start:
+                    insert(v);
+                    break;
+                case VertexType::End:
+                    connectIfMerge(v, m_helper[prevEdge]);
+                    erase(prevEdge);
+                    break;
+                case VertexType::Split: {
+                    const int left = leftOf(v);
+                    if (left >= 0) {
+                        m_diagonals.emplace_back(v, m_helper[left]);
+                        m_helper[left] = v;
+                    }
+                    insert(v);
+                    break;
+                }
+                case VertexType::Merge: {
+                    connectIfMerge(v, m_helper[prevEdge]);
+                    erase(prevEdge);
+                    const int left = leftOf(v);
+                    if (left >= 0) {
+                        connectIfMerge(v, m_helper[left]);
+                        m_helper[left] = v;
+                    }
+                    break;
+                }
+                case VertexType::Regular:
+                    if (above(m_pts[(v + m_n - 1) % m_n], m_pts[v])) {
+                        // 左链上的顶点：内部在右侧，替换上方的边
+                        connectIfMerge(v, m_helper[prevEdge]);
+                        erase(prevEdge);
+                        insert(v);
+                    } else {
+                        const int left = leftOf(v);
+                        if (left >= 0) {
+                            connectIfMerge(v, m_helper[left]);
+                            m_helper[left] = v;
+                        }
+                    }
+                    break;
+            }
+        }
+        return m_diagonals;
+    }
+
+private:
+    /**
+     * @brief 按扫描线上的 x 比较两条边；编号 -1 表示查询点。
+     */
+    struct EdgeLess {
+        const MonotoneSplitter* splitter;
+        bool operator()(int a, int b) const { return splitter->xAt(a) < splitter->xAt(b); }
+    };
+
+    const std::vector<Point>& m_pts;
+    int m_n;
+    double m_sweepY = 0.0;
+    double m_queryX = 0.0;
+    std::multiset<int, EdgeLess> m_status{EdgeLess{this}};
+    std::vector<std::multiset<int, EdgeLess>::iterator> m_handles; // 删除时不必再比较
+    std::vector<int> m_helper;
+    std::vector<VertexType> m_type;
+    std::vector<std::pair<int, int>> m_diagonals;
+
+    double xAt(int edge) const {
+        if (edge < 0) return m_queryX;
+        const Point& a = m_pts[edge];
+        const Point& b = m_pts[(edge + 1) % m_n];
+        if (a.y == b.y) return std::max(a.x, b.x);
+        const double s = (m_sweepY - a.y) / (b.y - a.y);
+        return a.x + s * (b.x - a.x);
+    }
+
+    VertexType classify(int v) const {
+        const Point& u = m_pts[(v + m_n - 1) % m_n];
+        const Point& p = m_pts[v];
+        const Point& w = m_pts[(v + 1) % m_n];
+        const bool convex = cross(u, p, w) > 0.0;
+        if (above(p, u) && above(p, w)) return convex ? VertexType::Start : VertexType::Split;
+        if (above(u, p) && above(w, p)) return convex ? VertexType::End : VertexType::Merge;
+        return VertexType::Regular;
+    }
+
+    void insert(int edge) {
+        m_helper[edge] = edge; // 边 i 的上端点就是顶点 i
+        m_handles[edge] = m_status.insert(edge);
+    }
+
+    void erase(int edge) {
+        if (m_handles[edge] == m_status.end()) return;
+        m_status.erase(m_handles[edge]);
+        m_handles[edge] = m_status.end();
+    }
+
+    /**
+     * @brief 扫描线上位于 v 左侧的最近一条边；没有时返回 -1（只会出现在非简单多边形中）。
+     */
+    int leftOf(int v) {
+        m_queryX = m_pts[v].x;
+        auto it = m_status.lower_bound(-1);
+        if (it == m_status.begin()) return -1;
+        return *--it;
+    }
+
+    void connectIfMerge(int v, int helper) {
+        if (helper >= 0 && m_type[helper] == VertexType::Merge) m_diagonals.emplace_back(v, helper);
+    }
+};
+
+/**
+ * @brief 用多边形的边和对角线把顶点围成的平面图拆成若干个面（每个面都是逆时针的单调多边形）。
+ */
+std::vector<std::vector<int>> splitFaces(const std::vector<Point>& pts, const std::vector<std::pair<int, int>>& diagonals) {
+    const int n = static_cast<int>(pts.size());
+    // 每个顶点的出边（按极角升序）：多边形的下一条边和所有对角线
+    std::vector<std::vector<int>> out(n);
+    for (int i = 0; i < n; ++i) out[i].push_back((i + 1) % n);
+    for (const auto& [a, b] : diagonals) {
+        out[a].push_back(b);
+        out[b].push_back(a);
+    }
+    // 入边 (i-1 -> i) 也要参与极角排序，才能找到顺时针方向的下一条边
+    std::vector<std::vector<int>> ring(n);
+    for (int i = 0; i < n; ++i) {
+        ring[i] = out[i];
+        ring[i].push_back((i + n - 1) % n);
+        const Point& o = pts[i];
+        std::sort(ring[i].begin(), ring[i].end(), [&](int a, int b) {
+            return std::atan2(pts[a].y - o.y, pts[a].x - o.x) < std::atan2(pts[b].y - o.y, pts[b].x - o.x);
+        });
+    }
+
+    std::vector<std::vector<char>> used(n);
+    for (int i = 0; i < n; ++i) used[i].assign(out[i].size(), 0);
+    auto outIndex = [&](int from, int to) {
+        return static_cast<int>(std::find(out[from].begin(), out[from].end(), to) - out[from].begin());
+    };
+
+    std::vector<std::vector<int>> faces;
+    for (int start = 0; start < n; ++start) {
+        for (size_t k = 0; k < out[start].size(); ++k) {
+            if (used[start][k]) continue;
+            std::vector<int> face;
+            int a = start;
+            int b = out[start][k];
+            used[start][k] = 1;
+            face.push_back(a);
+            // 面在有向边左侧：到达 b 后，取从 b->a 顺时针方向的下一条出边
+            while (b != start) {
+                face.push_back(b);
+                const std::vector<int>& around = ring[b];
+                const int pos = static_cast<int>(std::find(around.begin(), around.end(), a) - around.begin());
+                const int c = around[(pos + static_cast<int>(around.size()) - 1) % around.size()];
+                const int idx = outIndex(b, c);
+                if (idx >= static_cast<int>(out[b].size()) || used[b][idx] || face.size() > static_cast<size_t>(n)) {
+                    return {}; // 不是合法的平面划分（例如多边形自交）
+                }
+                used[b][idx] = 1;
+                a = b;
+                b = c;
+            }
+            faces.push_back(std::move(face));
+        }
+    }
+    return faces;
+}
+
+/**
+ * @brief 逆时针单调多边形的栈式剖分，输出逆时针三角形（局部编号）。
+ */
+void triangulateMonotone(const std::vector<Point>& pts, const std::vector<int>& face, std::vector<int>& triangles) {
+    const int m = static_cast<int>(face.size());
+    if (m < 3) return;
+
+    int top = 0, bottom = 0;
+    for (int i = 1; i < m; ++i) {
+        if (above(pts[face[i]], pts[face[top]])) top = i;
+        if (above(pts[face[bottom]], pts[face[i]])) bottom = i;
+    }
+
+    // 逆时针从最高点走到最低点是左链（含最低点），反向走是右链；两条链各自有序，归并即得扫描顺序
+    std::vector<std::pair<int, bool>> left, right; // (顶点, 是否在左链)
+    for (int i = (top + 1) % m;; i = (i + 1) % m) {
+        left.emplace_back(face[i], true);
+        if (i == bottom) break;
+    }
+    for (int i = (top + m - 1) % m; i != bottom; i = (i + m - 1) % m) right.emplace_back(face[i], false);
+
+    std::vector<std::pair<int, bool>> sorted;
+    sorted.reserve(m);
+    sorted.emplace_back(face[top], true);
+    std::merge(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(sorted),
+               [&](const std::pair<int, bool>& a, const std::pair<int, bool>& b) { return above(pts[a.first], pts[b.first]); });
+
+    auto emit = [&](int a, int b, int c) {
+        if (cross(pts[a], pts[b], pts[c]) < 0.0) std::swap(b, c);
+        triangles.push_back(a);
+        triangles.push_back(b);
+        triangles.push_back(c);
+    };
+
+    std::vector<std::pair<int, bool>> stack = {sorted[0], sorted[1]};
+    for (int j = 2; j < m - 1; ++j) {
+        const auto [v, onLeft] = sorted[j];
+        if (onLeft != stack.back().second) {
+            // 不同链：与栈中所有顶点连线
+            while (stack.size() > 1) {
+                const int a = stack.back().first;
+                stack.pop_back();
+                emit(v, a, stack.back().first);
+            }
+            stack.clear();
+            stack.push_back(sorted[j - 1]);
+            stack.push_back(sorted[j]);
+        } else {
+            // 同一条链：只要对角线在多边形内部（中间顶点是凸的）就继续切耳
+            auto last = stack.back();
+            stack.pop_back();
+            while (!stack.empty()) {
+                const int t = stack.back().first;
+                const double turn = onLeft ? cross(pts[t], pts[last.first], pts[v]) : cross(pts[v], pts[last.first], pts[t]);
+                if (turn <= 0.0) break;
+                emit(v, last.first, t);
+                last = stack.back();
+                stack.pop_back();
+            }
+            stack.push_back(last);
+            stack.push_back(sorted[j]);
+        }
+    }
+    const int v = sorted[m - 1].first;
+    while (stack.size() > 1) {
+        const int a = stack.back().first;
+        stack.pop_back();
+        emit(v, a, stack.back().first);
+    }
+}
+
+} // namespace
+
+bool Triangulation::build(const Polygon& poly){
+    std::vector<double> xy(2 * static_cast<size_t>(std::max(poly.n, 0)));
+    for (int i = 0; i < poly.n; ++i) {
+        const auto v = poly.vertex(i);
+        xy[2 * i] = v.x();
+        xy[2 * i + 1] = v.y();
+    }
+    return build(xy.data(), poly.n);
+}
+
+bool Triangulation::build(const double* xy, int n){
+    m_indices.clear();
+    m_n = 0;
+    if (n < 3) return false;
+
+    double area2 = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const int j = (i + 1) % n;
+        area2 += xy[2 * i] * xy[2 * j + 1] - xy[2 * j] * xy[2 * i + 1];
+    }
+    if (!std::isfinite(area2) || area2 == 0.0) return false;
+
+    // 统一成逆时针的局部编号；顺时针输入时 local i 对应原编号 n-1-i
+    const bool reversed = area2 < 0.0;
+    std::vector<Point> pts(n);
+    for (int i = 0; i < n; ++i) {
+        const int src = reversed ? n - 1 - i : i;
+        pts[i] = {xy[2 * src], xy[2 * src + 1]};
+    }
+
+    const std::vector<std::pair<int, int>> diagonals = MonotoneSplitter(pts).run();
+    const std::vector<std::vector<int>> faces = splitFaces(pts, diagonals);
+
+    std::vector<int> triangles;
+    triangles.reserve(3 * static_cast<size_t>(n - 2));
+    for (const auto& face : faces) triangulateMonotone(pts, face, triangles);
+
+    // 合法的剖分恰好有 n - 2 个三角形，面积之和等于多边形面积
+    if (triangles.size() != 3 * static_cast<size_t>(n - 2)) return false;
+    double sum2 = 0.0;
+    for (size_t t = 0; t < triangles.size(); t += 3) {
+        sum2 += cross(pts[triangles[t]], pts[triangles[t + 1]], pts[triangles[t + 2]]);
+    }
+    if (std::abs(sum2 - std::abs(area2)) > 1e-6 * std::abs(area2)) return false;
+
+    m_indices.resize(triangles.size());
+    for (size_t k = 0; k < triangles.size(); ++k) {
+        const int local = triangles[k];
+        m_indices[k] = static_cast<uint32_t>(reversed ? n - 1 - local : local);
+    }
+    m_n = n;
+    return true;
+}
+
+int Triangulation::firstInvertedTriangle(const double* xy) const{
+    for (size_t t = 0; t < m_indices.size(); t += 3) {
+        const double* a = xy + 2 * m_indices[t];
+        const double* b = xy + 2 * m_indices[t + 1];
+        const double* c = xy + 2 * m_indices[t + 2];
+        const double area2 = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+        // 零面积不影响覆盖（源多边形上有共线顶点时本来就会出现），NaN 也视为失效
+        if (!(area2 >= 0.0)) return static_cast<int>(t / 3);
+    }
+    return -1;
+}
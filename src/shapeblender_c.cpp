@@ -0,0 +1,303 @@
+#include "shapeblender_c.h"
+#include "ShapeBlender.h"
+#include "KineticBvh.h"
+#include <cmath>
+#include <new>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief C 接口的实现：把 C++ 核心包装在不透明句柄后面。
+ * 前置条件在这里检查并转换为错误码，核心只会收到合法输入；
+ * 任何异常都在边界内被捕获，不会传播到 C 调用者。
+ */
+
+struct sb_blender {
+    ShapeBlender blender; // 其中的多边形借用调用者的顶点
+    bool hasPolygons = false;
+    bool swapped = false; // A 的顶点数少于 B 时交换求解，计划里用 1 - t
+    bool solved = false;
+    std::ostringstream solverErrors; // 核心的错误信息收集在这里，求解失败时并入 sb_last_error()
+};
+
+struct sb_plan {
+    MorphPlan plan;
+};
+
+struct sb_bvh {
+    KineticBvh bvh;
+};
+
+namespace {
+
+thread_local std::string g_lastError;
+
+sb_status fail(sb_status status, const std::string& message) {
+    g_lastError = message;
+    return status;
+}
+
+sb_status ok() {
+    g_lastError.clear();
+    return SB_OK;
+}
+
+// 求解失败时附上核心报告的第一条错误
+sb_status failSolve(sb_blender* blender, sb_status status, const std::string& message) {
+    std::string detail = blender->solverErrors.str();
+    detail = detail.substr(0, detail.find('\n'));
+    return fail(status, detail.empty() ? message : message + ": " + detail);
+}
+
+sb_status checkVertices(const char* name, const double* xy, size_t count) {
+    if (xy == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, std::string(name) + " is null");
+    if (count < 3) return fail(SB_ERR_TOO_FEW_VERTICES, std::string(name) + " has fewer than 3 vertices");
+    for (size_t i = 0; i < 2 * count; ++i) {
+        if (!std::isfinite(xy[i])) {
+            return fail(SB_ERR_INVALID_ARGUMENT, std::string(name) + " has a non-finite coordinate at vertex " + std::to_string(i / 2));
+        }
+    }
+    return SB_OK;
+}
+
+bool planIsFinite(const MorphPlan& plan) {
+    for (int i = 0; i < plan.n; ++i) {
+        if (!plan.uv1[i].allFinite() || !plan.uv2[i].allFinite()) return false;
+    }
+    return plan.C_mat.allFinite() && plan.T_vec.allFinite() && std::isfinite(plan.theta);
+}
+
+// 把函数体里抛出的异常转换为错误码
+template <typename F>
+sb_status guarded(F&& body) {
+    try {
+        return body();
+    } catch (const std::bad_alloc&) {
+        return fail(SB_ERR_OUT_OF_MEMORY, "out of memory");
+    } catch (const std::exception& e) {
+        return fail(SB_ERR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(SB_ERR_INTERNAL, "unknown exception");
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+int sb_api_version(void) {
+    return SB_API_VERSION;
+}
+
+const char* sb_last_error(void) {
+    return g_lastError.c_str();
+}
+
+const char* sb_status_string(sb_status status) {
+    switch (status) {
+        case SB_OK: return "ok";
+        case SB_ERR_INVALID_ARGUMENT: return "invalid argument";
+        case SB_ERR_TOO_FEW_VERTICES: return "too few vertices";
+        case SB_ERR_NOT_READY: return "not ready";
+        case SB_ERR_DEGENERATE: return "degenerate basis";
+        case SB_ERR_BUFFER_TOO_SMALL: return "buffer too small";
+        case SB_ERR_OUT_OF_MEMORY: return "out of memory";
+        case SB_ERR_INTERNAL: return "internal error";
+    }
+    return "unknown status";
+}
+
+void sb_default_weights(sb_weights* out) {
+    if (out == nullptr) return;
+    BlendWeights defaults;
+    out->w1 = defaults.w1;
+    out->w2 = defaults.w2;
+    out->smooth_a_wS = defaults.smooth_a_wS;
+    out->smooth_a_wR = defaults.smooth_a_wR;
+    out->smooth_a_wA = defaults.smooth_a_wA;
+}
+
+sb_status sb_blender_create(sb_blender** out) {
+    if (out == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "out is null");
+    *out = nullptr;
+    return guarded([&]() {
+        *out = new sb_blender();
+        // 不向宿主的标准输出写东西，错误只通过 sb_last_error() 报告
+        (*out)->blender.setLogStreams(nullptr, &(*out)->solverErrors);
+        return ok();
+    });
+}
+
+void sb_blender_destroy(sb_blender* blender) {
+    delete blender;
+}
+
+sb_status sb_blender_set_weights(sb_blender* blender, const sb_weights* weights) {
+    if (blender == nullptr || weights == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "blender or weights is null");
+    const double values[] = {weights->w1, weights->w2, weights->smooth_a_wS, weights->smooth_a_wR, weights->smooth_a_wA};
+    for (double v : values) {
+        if (!std::isfinite(v)) return fail(SB_ERR_INVALID_ARGUMENT, "weights must be finite");
+    }
+
+    BlendWeights w;
+    w.w1 = static_cast<float>(weights->w1);
+    w.w2 = static_cast<float>(weights->w2);
+    w.smooth_a_wS = static_cast<float>(weights->smooth_a_wS);
+    w.smooth_a_wR = static_cast<float>(weights->smooth_a_wR);
+    w.smooth_a_wA = static_cast<float>(weights->smooth_a_wA);
+    blender->blender.setWeights(w);
+    blender->solved = false;
+    return ok();
+}
+
+sb_status sb_blender_set_polygons(sb_blender* blender,
+                                  const double* xyA, size_t countA,
+                                  const double* xyB, size_t countB) {
+    if (blender == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "blender is null");
+    sb_status status = checkVertices("polygon A", xyA, countA);
+    if (status != SB_OK) return status;
+    status = checkVertices("polygon B", xyB, countB);
+    if (status != SB_OK) return status;
+
+    return guarded([&]() {
+        blender->hasPolygons = false;
+        blender->solved = false;
+        Polygon polyA, polyB;
+        polyA.borrowVertices(xyA, countA);
+        polyB.borrowVertices(xyB, countB);
+
+        // 动态规划要求源多边形的顶点不少于目标多边形
+        blender->swapped = countA < countB;
+        if (blender->swapped) blender->blender.setPolygons(polyB, polyA);
+        else blender->blender.setPolygons(polyA, polyB);
+
+        blender->hasPolygons = true;
+        return ok();
+    });
+}
+
+sb_status sb_blender_solve(sb_blender* blender, int manual_k, double budget_seconds) {
+    if (blender == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "blender is null");
+    if (!blender->hasPolygons) return fail(SB_ERR_NOT_READY, "polygons have not been set");
+
+    const int sourceCount = blender->blender.getPolyA().n;
+    if (manual_k >= sourceCount) {
+        return fail(SB_ERR_INVALID_ARGUMENT, "manual_k must be smaller than the vertex count of the larger polygon");
+    }
+
+    return guarded([&]() {
+        blender->solved = false;
+        blender->solverErrors.str(std::string());
+
+        KSearchProgress progress;
+        progress.timeBudgetSeconds = budget_seconds;
+        // 任何负数都表示自动搜索，核心只接受 -1
+        blender->blender.computeCorrespondence(manual_k < 0 ? -1 : manual_k, &progress);
+        blender->blender.findOptimalBasis();
+
+        const MorphPlan& plan = blender->blender.getPlan();
+        if (plan.empty()) return failSolve(blender, SB_ERR_INTERNAL, "solver produced no plan");
+        if (!planIsFinite(plan)) return failSolve(blender, SB_ERR_DEGENERATE, "no non-degenerate affine basis was found");
+
+        blender->solved = true;
+        return ok();
+    });
+}
+
+int sb_blender_best_k(const sb_blender* blender) {
+    if (blender == nullptr || !blender->solved) return -1;
+    return blender->blender.getBestK();
+}
+
+sb_status sb_blender_get_plan(const sb_blender* blender, sb_plan** out) {
+    if (blender == nullptr || out == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "blender or out is null");
+    *out = nullptr;
+    if (!blender->solved) return fail(SB_ERR_NOT_READY, "blender has not been solved");
+
+    return guarded([&]() {
+        sb_plan* plan = new sb_plan();
+        plan->plan = blender->blender.getPlan();
+        plan->plan.reversed = blender->swapped;
+        *out = plan;
+        return ok();
+    });
+}
+
+void sb_plan_destroy(sb_plan* plan) {
+    delete plan;
+}
+
+size_t sb_plan_vertex_count(const sb_plan* plan) {
+    return plan ? static_cast<size_t>(plan->plan.n) : 0;
+}
+
+sb_status sb_plan_evaluate(const sb_plan* plan, double t, double* out_xy, size_t capacity) {
+    return sb_plan_evaluate_many(plan, &t, 1, out_xy, capacity);
+}
+
+sb_status sb_plan_evaluate_many(const sb_plan* plan, const double* ts, size_t count,
+                                double* out_xy, size_t capacity) {
+    if (plan == nullptr || ts == nullptr || out_xy == nullptr) {
+        return fail(SB_ERR_INVALID_ARGUMENT, "plan, ts or out_xy is null");
+    }
+    const size_t n = static_cast<size_t>(plan->plan.n);
+    if (count > 0 && capacity / count < n) {
+        return fail(SB_ERR_BUFFER_TOO_SMALL, "out_xy needs room for " + std::to_string(n) + " vertices per frame");
+    }
+    for (size_t f = 0; f < count; ++f) {
+        if (!std::isfinite(ts[f])) return fail(SB_ERR_INVALID_ARGUMENT, "t must be finite");
+    }
+
+    for (size_t f = 0; f < count; ++f) {
+        plan->plan.evaluate(static_cast<float>(ts[f]), out_xy + 2 * n * f);
+    }
+    return ok();
+}
+
+sb_status sb_bvh_create(const sb_plan* plan, int slabs, sb_bvh** out) {
+    if (plan == nullptr || out == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "plan or out is null");
+    *out = nullptr;
+    if (plan->plan.n < 3) return fail(SB_ERR_TOO_FEW_VERTICES, "plan has fewer than 3 vertices");
+
+    return guarded([&]() {
+        KineticBvhOptions options;
+        if (slabs > 0) options.slabs = slabs;
+        sb_bvh* bvh = new sb_bvh();
+        bvh->bvh.build(plan->plan, options);
+        *out = bvh;
+        return ok();
+    });
+}
+
+void sb_bvh_destroy(sb_bvh* bvh) {
+    delete bvh;
+}
+
+sb_status sb_bvh_contains(const sb_bvh* bvh, double t, double x, double y, int* out_inside) {
+    if (bvh == nullptr || out_inside == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "bvh or out_inside is null");
+    if (!std::isfinite(t) || !std::isfinite(x) || !std::isfinite(y)) return fail(SB_ERR_INVALID_ARGUMENT, "t, x and y must be finite");
+    *out_inside = bvh->bvh.contains(static_cast<float>(t), x, y) ? 1 : 0;
+    return ok();
+}
+
+sb_status sb_bvh_raycast(const sb_bvh* bvh, double t, double origin_x, double origin_y,
+                         double dir_x, double dir_y, double max_distance, sb_ray_hit* out_hit) {
+    if (bvh == nullptr || out_hit == nullptr) return fail(SB_ERR_INVALID_ARGUMENT, "bvh or out_hit is null");
+    const double values[] = {t, origin_x, origin_y, dir_x, dir_y};
+    for (double v : values) {
+        if (!std::isfinite(v)) return fail(SB_ERR_INVALID_ARGUMENT, "t, origin and direction must be finite");
+    }
+    if (dir_x == 0.0 && dir_y == 0.0) return fail(SB_ERR_INVALID_ARGUMENT, "direction is zero");
+    if (std::isnan(max_distance)) return fail(SB_ERR_INVALID_ARGUMENT, "max_distance is NaN");
+
+    RayHit hit;
+    bvh->bvh.raycast(static_cast<float>(t), origin_x, origin_y, dir_x, dir_y, max_distance, hit);
+    out_hit->edge = hit.edge;
+    out_hit->distance = hit.distance;
+    out_hit->x = hit.x;
+    out_hit->y = hit.y;
+    out_hit->edge_param = hit.edgeParam;
+    return ok();
+}
+
+} // extern "C"
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Polygon.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * @brief 测试用的最小工具：不依赖测试框架，CHECK 失败时打印位置并计数，main 返回失败数。
+ */
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief 本进程独占的临时目录，析构时连同内容删除。
+ */
+class TempDir {
+public:
+    TempDir() {
+        m_path = std::filesystem::temp_directory_path() / ("shapeblender_test_" + std::to_string(getpid()));
+        std::filesystem::remove_all(m_path);
+        std::filesystem::create_directories(m_path);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_path, ec);
+    }
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    std::string file(const std::string& name) const { return (m_path / name).string(); }
+
+private:
+    std::filesystem::path m_path;
+};
+
+inline std::string readFile(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+inline void writeFile(const std::string& path, const std::string& bytes) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ * @brief 一个不规则的星形多边形（自有顶点，已计算内在属性）。
+ */
+inline Polygon makeStar(int n, double phase = 0.0) {
+    Polygon poly;
+    poly.vertices.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const double angle = 2.0 * M_PI * i / n + phase;
+        const double radius = (i % 2 == 0 ? 100.0 : 55.0) + 7.0 * std::sin(3.0 * i);
+        poly.vertices[i] = Eigen::Vector2d(radius * std::cos(angle) + 0.125, radius * std::sin(angle) - 3.5);
+    }
+    poly.n = n;
+    poly.precomputeIntrinsics();
+    return poly;
+}
+
+} // namespace test
+
+#define CHECK(cond)                                                                       \
+    do {                                                                                  \
+        if (!(cond)) {                                                                    \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond << std::endl; \
+            ++test::failures();                                                           \
+        }                                                                                 \
+    } while (0)
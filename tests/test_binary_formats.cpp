@@ -0,0 +1,247 @@
+#include "TestUtil.h"
+#include "FrameFile.h"
+#include "PolygonArchive.h"
+#include <cstring>
+
+namespace {
+
+bool sameIntrinsics(const Polygon& a, const Polygon& b) {
+    return a.edge_e0_lengths == b.edge_e0_lengths && a.edge_e1_lengths == b.edge_e1_lengths
+        && a.edge_e2_lengths == b.edge_e2_lengths && a.angles_curr == b.angles_curr
+        && a.angles_prev == b.angles_prev && a.angles_next == b.angles_next
+        && a.cornerTriangle_areas == b.cornerTriangle_areas;
+}
+
+bool sameVertices(const Polygon& a, const Polygon& b) {
+    if (a.n != b.n) return false;
+    for (int i = 0; i < a.n; ++i) {
+        if (a.vertex(i) != b.vertex(i)) return false;
+    }
+    return true;
+}
+
+void testPolygonRoundTrip() {
+    test::TempDir dir;
+    const Polygon star = test::makeStar(37);
+
+    for (bool withIntrinsics : {true, false}) {
+        const std::string path = dir.file(withIntrinsics ? "full.sbp" : "plain.sbp");
+        CHECK(star.saveBinary(path, withIntrinsics));
+
+        Polygon loaded;
+        CHECK(loaded.loadFromFile(path));
+        CHECK(loaded.externalXY != nullptr); // 顶点在映射中原地使用
+        CHECK(sameVertices(star, loaded));
+        CHECK(sameIntrinsics(star, loaded));
+        CHECK(loaded.totalArea == star.totalArea);
+        CHECK(loaded.signFlag == star.signFlag);
+    }
+
+    // 覆盖一个正被映射的文件：改名替换，已加载的多边形仍看到旧的顶点
+    const std::string path = dir.file("full.sbp");
+    Polygon mapped;
+    CHECK(mapped.loadBinary(path));
+    CHECK(test::makeStar(12, 0.3).saveBinary(path));
+    CHECK(sameVertices(star, mapped));
+    Polygon reloaded;
+    CHECK(reloaded.loadBinary(path) && reloaded.n == 12);
+}
+
+void testPolygonCorruptInput() {
+    test::TempDir dir;
+    const std::string path = dir.file("star.sbp");
+    CHECK(test::makeStar(9).saveBinary(path));
+    const std::string image = test::readFile(path);
+
+    Polygon poly;
+    // 截断在任何位置都要被拒绝
+    for (size_t length : {size_t(0), size_t(3), size_t(63), size_t(64), size_t(64 + 8), image.size() - 1}) {
+        test::writeFile(path, image.substr(0, length));
+        CHECK(!poly.loadFromFile(path));
+    }
+    // 多出来的字节同样说明文件与文件头不符
+    test::writeFile(path, image + std::string(8, '\0'));
+    CHECK(!poly.loadBinary(path));
+
+    std::string mutated = image;
+    mutated[4] = 7; // 版本
+    CHECK(!poly.loadBinaryImage(mutated.data(), mutated.size(), nullptr, "version"));
+    mutated = image;
+    mutated[12] = 2; // 顶点数 < 3
+    std::memset(&mutated[13], 0, 3);
+    CHECK(!poly.loadBinaryImage(mutated.data(), mutated.size(), nullptr, "count"));
+    mutated = image;
+    mutated[15] = 0x7f; // 顶点数远大于文件
+    CHECK(!poly.loadBinaryImage(mutated.data(), mutated.size(), nullptr, "count"));
+    mutated = image;
+    mutated[8] ^= 1; // 去掉内在属性标志后长度不符
+    CHECK(!poly.loadBinaryImage(mutated.data(), mutated.size(), nullptr, "flags"));
+
+    // 没有所有者时拷贝顶点
+    CHECK(poly.loadBinaryImage(image.data(), image.size(), nullptr, "copy"));
+    CHECK(poly.externalXY == nullptr && poly.n == 9);
+}
+
+void testArchiveRoundTrip() {
+    test::TempDir dir;
+    std::vector<std::pair<std::string, std::string>> inputs;
+    std::vector<Polygon> polygons;
+    for (int i = 0; i < 20; ++i) {
+        polygons.push_back(test::makeStar(5 + 3 * i, 0.1 * i));
+        const std::string path = dir.file("p" + std::to_string(i) + (i % 2 ? ".sbp" : ".json"));
+        if (i % 2) {
+            CHECK(polygons.back().saveBinary(path));
+        } else {
+            // JSON 只能经文本往返，用整数坐标保证逐位一致
+            std::string text = "[";
+            for (auto& v : polygons.back().vertices) {
+                v = Eigen::Vector2d(std::round(v.x()), std::round(v.y()));
+                text += (text.size() > 1 ? ", [" : "[") + std::to_string(static_cast<int>(v.x())) + ", " +
+                        std::to_string(static_cast<int>(v.y())) + "]";
+            }
+            test::writeFile(path, text + "]");
+            polygons.back().precomputeIntrinsics();
+        }
+        inputs.emplace_back("shape_" + std::to_string(i), path);
+    }
+
+    const std::string archivePath = dir.file("library.sba");
+    CHECK(PolygonArchive::build(inputs, archivePath, 4));
+
+    PolygonArchive archive;
+    CHECK(archive.open(archivePath));
+    CHECK(archive.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const long index = archive.find(inputs[i].first);
+        CHECK(index >= 0);
+        if (index < 0) continue;
+        CHECK(archive.entry(static_cast<size_t>(index)).name == inputs[i].first);
+        Polygon loaded;
+        CHECK(archive.load(static_cast<size_t>(index), loaded));
+        CHECK(sameVertices(polygons[i], loaded));
+        CHECK(loaded.externalXY != nullptr);
+    }
+    CHECK(archive.find("missing") == -1);
+    CHECK(archive.find("shape_1x") == -1);
+
+    // 通过 "<归档>#<名字>" 加载，多边形比归档对象活得久
+    Polygon viaPath;
+    CHECK(viaPath.loadFromFile(archivePath + "#shape_7"));
+    CHECK(sameVertices(polygons[7], viaPath));
+
+    // 名字重复时拒绝打包
+    inputs.push_back(inputs.front());
+    CHECK(!PolygonArchive::build(inputs, dir.file("dup.sba"), 2));
+}
+
+void testArchiveCorruptInput() {
+    test::TempDir dir;
+    CHECK(test::makeStar(8).saveBinary(dir.file("a.sbp")));
+    CHECK(test::makeStar(11).saveBinary(dir.file("b.sbp")));
+    const std::string archivePath = dir.file("library.sba");
+    CHECK(PolygonArchive::build({{"a", dir.file("a.sbp")}, {"b", dir.file("b.sbp")}}, archivePath, 1));
+    const std::string image = test::readFile(archivePath);
+
+    PolygonArchive archive;
+    const std::string path = dir.file("corrupt.sba");
+    for (size_t length : {size_t(0), size_t(10), size_t(63), size_t(64), size_t(200), image.size() - 1}) {
+        test::writeFile(path, image.substr(0, length));
+        // 打开可以成功（只检查目录），但加载条目必须失败或得到完整的多边形
+        if (archive.open(path)) {
+            Polygon poly;
+            for (const char* name : {"a", "b"}) {
+                if (archive.load(name, poly)) CHECK(poly.n == (name[0] == 'a' ? 8 : 11));
+            }
+        }
+    }
+
+    // 逐字节破坏文件头和目录：不能崩溃，加载成功时多边形必须完整
+    const size_t tableEnd = std::min<size_t>(image.size(), PolygonArchive::kPageSize);
+    for (size_t offset = 0; offset < tableEnd; ++offset) {
+        std::string mutated = image;
+        mutated[offset] = static_cast<char>(mutated[offset] ^ 0x5a);
+        test::writeFile(path, mutated);
+        if (!archive.open(path)) continue;
+        for (size_t i = 0; i < archive.size() && i < 4; ++i) {
+            Polygon poly;
+            if (archive.load(i, poly)) CHECK(poly.n >= 3);
+        }
+        archive.find("a");
+        archive.find("b");
+    }
+}
+
+void testFrameFileRoundTrip() {
+    test::TempDir dir;
+    const std::string path = dir.file("frames.sbf");
+    const int vertexCount = 13;
+    const int frameCount = 5;
+
+    FrameFileWriter writer;
+    CHECK(writer.open(path, vertexCount, frameCount));
+    for (int f = 0; f < frameCount; ++f) {
+        float* xy = writer.frame(f);
+        CHECK(reinterpret_cast<uintptr_t>(xy) % FrameFileFormat::kAlignment == 0);
+        for (int i = 0; i < 2 * vertexCount; ++i) xy[i] = static_cast<float>(f * 1000 + i) * 0.5f;
+        writer.setTime(f, static_cast<float>(f) / (frameCount - 1));
+    }
+    CHECK(!std::filesystem::exists(path)); // finish() 之前只有临时文件
+    CHECK(writer.finish());
+
+    FrameFile file;
+    CHECK(file.open(path));
+    CHECK(file.vertexCount() == vertexCount);
+    CHECK(file.frameCount() == frameCount);
+    CHECK(file.frameStride() == FrameFileFormat::frameStride(vertexCount));
+    CHECK(file.frameStride() % FrameFileFormat::kAlignment == 0);
+    for (int f = 0; f < frameCount; ++f) {
+        CHECK(file.time(f) == static_cast<float>(f) / (frameCount - 1));
+        const float* xy = file.frame(f);
+        bool same = true;
+        for (int i = 0; i < 2 * vertexCount; ++i) same = same && xy[i] == static_cast<float>(f * 1000 + i) * 0.5f;
+        CHECK(same);
+    }
+}
+
+void testFrameFileCorruptInput() {
+    test::TempDir dir;
+    const std::string good = dir.file("good.sbf");
+    FrameFileWriter writer;
+    CHECK(writer.open(good, 7, 3));
+    for (int f = 0; f < 3; ++f) {
+        std::fill(writer.frame(f), writer.frame(f) + 14, 1.0f);
+        writer.setTime(f, 0.5f * f);
+    }
+    CHECK(writer.finish());
+    const std::string image = test::readFile(good);
+
+    FrameFile file;
+    const std::string path = dir.file("corrupt.sbf");
+    for (size_t length : {size_t(0), size_t(63), size_t(64), image.size() - 1}) {
+        test::writeFile(path, image.substr(0, length));
+        CHECK(!file.open(path));
+    }
+
+    // 逐字节破坏文件头：要么拒绝，要么所有帧都在文件之内
+    for (size_t offset = 0; offset < 64; ++offset) {
+        std::string mutated = image;
+        mutated[offset] = static_cast<char>(mutated[offset] ^ 0xa5);
+        test::writeFile(path, mutated);
+        if (!file.open(path)) continue;
+        const char* begin = file.file()->data();
+        const char* last = reinterpret_cast<const char*>(file.frame(file.frameCount() - 1));
+        CHECK(last >= begin && last + 2 * sizeof(float) * file.vertexCount() <= begin + file.file()->size());
+    }
+}
+
+} // namespace
+
+int main() {
+    testPolygonRoundTrip();
+    testPolygonCorruptInput();
+    testArchiveRoundTrip();
+    testArchiveCorruptInput();
+    testFrameFileRoundTrip();
+    testFrameFileCorruptInput();
+    return test::failures() == 0 ? 0 : 1;
+}
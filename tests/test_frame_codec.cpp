@@ -0,0 +1,164 @@
+#include "TestUtil.h"
+#include "FrameCodec.h"
+#include <sstream>
+
+namespace {
+
+const int kVertexCount = 23;
+const int kFrameCount = 47;
+
+/**
+ * @brief 平滑变化的一帧：和变形动画一样，相邻帧之间的差很小。
+ */
+void makeFrame(int f, std::vector<double>& xy) {
+    xy.resize(2 * kVertexCount);
+    for (int i = 0; i < kVertexCount; ++i) {
+        const double angle = 2.0 * M_PI * i / kVertexCount + 0.02 * f;
+        const double radius = 80.0 + 20.0 * std::sin(0.1 * f + i);
+        xy[2 * i] = radius * std::cos(angle) + 0.37 * f;
+        xy[2 * i + 1] = radius * std::sin(angle) - 1234.5;
+    }
+}
+
+std::string encodeStream(const FrameCodecOptions& options) {
+    std::stringstream ss;
+    FrameStreamEncoder encoder;
+    CHECK(encoder.open(ss, kVertexCount, options));
+    std::vector<double> xy;
+    for (int f = 0; f < kFrameCount; ++f) {
+        makeFrame(f, xy);
+        CHECK(encoder.addFrame(static_cast<float>(f) / (kFrameCount - 1), xy.data()));
+    }
+    CHECK(encoder.finish());
+    CHECK(encoder.frameCount() == kFrameCount);
+    CHECK(encoder.bytesWritten() == ss.str().size());
+    return ss.str();
+}
+
+bool closeTo(const std::vector<double>& decoded, int f, double tolerance) {
+    std::vector<double> expected;
+    makeFrame(f, expected);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (std::abs(decoded[i] - expected[i]) > tolerance) return false;
+    }
+    return true;
+}
+
+void testRoundTrip() {
+    FrameCodecOptions options;
+    options.precision = 1e-3;
+    options.keyframeInterval = 8;
+    const std::string bytes = encodeStream(options);
+    // 量化加预测之后应当远小于原始的 double 数据
+    CHECK(bytes.size() < sizeof(double) * 2 * kVertexCount * kFrameCount / 4);
+
+    const double tolerance = options.precision / 2 + 1e-9;
+    std::istringstream is(bytes);
+    FrameStreamDecoder decoder;
+    CHECK(decoder.open(is));
+    CHECK(decoder.vertexCount() == kVertexCount);
+    CHECK(decoder.precision() == options.precision);
+    CHECK(decoder.frameCount() == kFrameCount);
+
+    std::vector<double> xy(2 * kVertexCount);
+    float t = 0.0f;
+    for (int f = 0; f < kFrameCount; ++f) {
+        CHECK(decoder.position() == f);
+        CHECK(decoder.next(t, xy.data()));
+        CHECK(t == static_cast<float>(f) / (kFrameCount - 1));
+        CHECK(closeTo(xy, f, tolerance));
+    }
+    CHECK(!decoder.next(t, xy.data()));
+    CHECK(decoder.error().empty());
+
+    // 任意顺序定位：每次都从最近的关键帧重新解码
+    for (int f : {40, 0, 7, 8, 9, kFrameCount - 1, 15, 16, 3}) {
+        CHECK(decoder.seek(f));
+        CHECK(decoder.position() == f);
+        CHECK(decoder.next(t, xy.data()));
+        CHECK(closeTo(xy, f, tolerance));
+    }
+    CHECK(!decoder.seek(kFrameCount));
+    CHECK(!decoder.error().empty());
+}
+
+void testInvalidEncoderInput() {
+    std::stringstream ss;
+    FrameStreamEncoder encoder;
+    CHECK(!encoder.open(ss, 0));
+    FrameCodecOptions options;
+    options.precision = 0.0;
+    CHECK(!encoder.open(ss, 3, options));
+
+    CHECK(encoder.open(ss, 3));
+    std::vector<double> xy(6, 1.0);
+    xy[4] = std::nan("");
+    CHECK(!encoder.addFrame(0.0f, xy.data()));
+}
+
+/**
+ * @brief 解码整个流，返回是否顺利到达结尾；失败时必须给出错误信息。
+ */
+bool decodeAll(const std::string& bytes) {
+    std::istringstream is(bytes);
+    FrameStreamDecoder decoder;
+    if (!decoder.open(is)) {
+        CHECK(!decoder.error().empty());
+        return false;
+    }
+    std::vector<double> xy(2 * static_cast<size_t>(decoder.vertexCount()));
+    float t = 0.0f;
+    int frames = 0;
+    while (decoder.next(t, xy.data())) ++frames;
+    if (!decoder.error().empty()) return false;
+    if (decoder.frameCount() >= 0 && decoder.seek(decoder.frameCount() / 2)) decoder.next(t, xy.data());
+    return frames > 0;
+}
+
+void testCorruptInput() {
+    FrameCodecOptions options;
+    options.keyframeInterval = 5;
+    const std::string bytes = encodeStream(options);
+    CHECK(decodeAll(bytes));
+
+    // 截断在任何位置都不能崩溃，截掉尾部索引之后不能再当作完整的流
+    for (size_t length = 0; length < bytes.size(); length += (length < 64 ? 1 : 37)) {
+        std::istringstream is(bytes.substr(0, length));
+        FrameStreamDecoder decoder;
+        if (decoder.open(is)) {
+            std::vector<double> xy(2 * kVertexCount);
+            float t = 0.0f;
+            while (decoder.next(t, xy.data())) {
+            }
+        } else {
+            CHECK(!decoder.error().empty());
+        }
+    }
+
+    std::string mutated = bytes;
+    mutated[0] ^= 0x20;
+    {
+        std::istringstream is(mutated);
+        FrameStreamDecoder decoder;
+        CHECK(!decoder.open(is));
+        CHECK(!decoder.error().empty());
+    }
+
+    // 逐字节破坏：解码器要么报错，要么得到某个结果，但绝不能崩溃或按损坏的长度分配内存
+    for (size_t offset = 0; offset < bytes.size(); ++offset) {
+        for (unsigned char mask : {0x01, 0x80, 0xff}) {
+            mutated = bytes;
+            mutated[offset] = static_cast<char>(mutated[offset] ^ mask);
+            decodeAll(mutated);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testInvalidEncoderInput();
+    testCorruptInput();
+    return test::failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "TestUtil.h"
+#include "PolygonParser.h"
+#include <cstdlib>
+
+namespace {
+
+PolygonParseStatus parse(const std::string& text, std::vector<Eigen::Vector2d>& out, PolygonParseError& error) {
+    return parsePolygonJson(text.data(), text.size(), out, error);
+}
+
+void testStrictArrays() {
+    std::vector<Eigen::Vector2d> out;
+    PolygonParseError error;
+
+    CHECK(parse("[[0, 0], [1.5, -2], [3e2, 4E-1]]", out, error) == PolygonParseStatus::Ok);
+    CHECK(out.size() == 3);
+    if (out.size() == 3) {
+        CHECK(out[1] == Eigen::Vector2d(1.5, -2.0));
+        CHECK(out[2] == Eigen::Vector2d(300.0, 0.4));
+    }
+
+    CHECK(parse(" \n\t[ ]\r\n", out, error) == PolygonParseStatus::Ok);
+    CHECK(out.empty());
+
+    // 与 strtod 逐位一致
+    const char* numbers[] = {"0.1", "-123.456789012345678", "2.2250738585072014e-308", "1e-320", "0.30000000000000004"};
+    for (const char* number : numbers) {
+        const std::string text = std::string("[[") + number + ", " + number + "]]";
+        CHECK(parse(text, out, error) == PolygonParseStatus::Ok);
+        CHECK(out.size() == 1 && out[0].x() == std::strtod(number, nullptr) && out[0].y() == out[0].x());
+    }
+}
+
+void testMalformedInput() {
+    std::vector<Eigen::Vector2d> out;
+    PolygonParseError error;
+
+    CHECK(parse("", out, error) == PolygonParseStatus::Error);
+    CHECK(parse("[[0, 0], [1,", out, error) == PolygonParseStatus::Error);
+    CHECK(error.message == "unexpected end of input");
+
+    CHECK(parse("[[0, 0],\n [1 1]]", out, error) == PolygonParseStatus::Error);
+    CHECK(error.line == 2);
+    CHECK(error.column == 5);
+
+    CHECK(parse("[[0, 0]] x", out, error) == PolygonParseStatus::Error);
+    CHECK(parse("[[01, 0]]", out, error) == PolygonParseStatus::Error);
+    CHECK(parse("[[1., 0]]", out, error) == PolygonParseStatus::Error);
+    CHECK(parse("[[-, 0]]", out, error) == PolygonParseStatus::Error);
+    CHECK(parse("[[0, 0]", out, error) == PolygonParseStatus::Error);
+
+    // 每个前缀都必须干净地失败，而不是越界读取
+    const std::string text = "[[12.5, -3e1], [4, 5], [6, 7]]";
+    for (size_t length = 0; length < text.size(); ++length) {
+        CHECK(parse(text.substr(0, length), out, error) == PolygonParseStatus::Error);
+    }
+}
+
+void testUnsupportedInput() {
+    std::vector<Eigen::Vector2d> out;
+    PolygonParseError error;
+
+    // 合法但格式外的 JSON 交给通用解析器
+    CHECK(parse("{\"vertices\": []}", out, error) == PolygonParseStatus::Unsupported);
+    CHECK(parse("[[0, 0, 0]]", out, error) == PolygonParseStatus::Unsupported);
+    CHECK(parse("[[\"0\", 0]]", out, error) == PolygonParseStatus::Unsupported);
+    CHECK(parse("[[[0], 0]]", out, error) == PolygonParseStatus::Unsupported);
+    CHECK(parse("[[1e999, 0]]", out, error) == PolygonParseStatus::Unsupported);
+    CHECK(parse("\xEF\xBB\xBF[[0, 0]]", out, error) == PolygonParseStatus::Unsupported);
+}
+
+void testLoadFromFile() {
+    test::TempDir dir;
+
+    test::writeFile(dir.file("strict.json"), "[[0, 0], [4, 0], [4, 3], [0, 3]]");
+    Polygon poly;
+    CHECK(poly.loadFromFile(dir.file("strict.json")));
+    CHECK(poly.n == 4);
+    CHECK(std::abs(poly.totalArea - 12.0) < 1e-12);
+    CHECK(poly.signFlag);
+
+    // 格式外的输入经通用解析器读取：多余的坐标被忽略，顺时针的绕序反映在 signFlag 中
+    test::writeFile(dir.file("extra.json"), "[[0, 0, 9], [0, 3, 9], [4, 3, 9], [4, 0, 9]]");
+    CHECK(poly.loadFromFile(dir.file("extra.json")));
+    CHECK(poly.n == 4);
+    CHECK(!poly.signFlag);
+
+    test::writeFile(dir.file("broken.json"), "[[0, 0], [4, 0], [4,");
+    CHECK(!poly.loadFromFile(dir.file("broken.json")));
+    test::writeFile(dir.file("short.json"), "[[0, 0], [4, 0]]");
+    CHECK(!poly.loadFromFile(dir.file("short.json")));
+    CHECK(!poly.loadFromFile(dir.file("missing.json")));
+}
+
+} // namespace
+
+int main() {
+    testStrictArrays();
+    testMalformedInput();
+    testUnsupportedInput();
+    testLoadFromFile();
+    return test::failures() == 0 ? 0 : 1;
+}